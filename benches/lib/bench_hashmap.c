@@ -0,0 +1,200 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lib/allocator.h"
+#include "lib/hashmap.h"
+
+#define BENCH_MIN_OPERATIONS 1000000
+#define BENCH_MAX_SIZE 65536
+
+struct BenchTimer
+{
+    struct CountingAllocator *counting_allocator;
+    double start_ns;
+    size_t start_allocations;
+    double elapsed_ns;
+    size_t allocations;
+};
+
+volatile uintptr_t bench_sink;
+
+double bench_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+void bench_init(struct BenchTimer *timer, struct CountingAllocator *counting_allocator)
+{
+    timer->counting_allocator = counting_allocator;
+    timer->elapsed_ns = 0;
+    timer->allocations = 0;
+
+    return;
+}
+
+void bench_start(struct BenchTimer *timer)
+{
+    timer->start_allocations = timer->counting_allocator->allocations;
+    timer->start_ns = bench_now_ns();
+
+    return;
+}
+
+void bench_stop(struct BenchTimer *timer)
+{
+    timer->elapsed_ns += bench_now_ns() - timer->start_ns;
+    timer->allocations +=
+        timer->counting_allocator->allocations - timer->start_allocations;
+
+    return;
+}
+
+void bench_report(const char *benchmark, const char *distribution, size_t size,
+                  double load_factor, size_t operations, struct BenchTimer *timer)
+{
+    printf("{\"benchmark\":\"%s\",\"distribution\":\"%s\",\"size\":%zu,"
+           "\"load_factor\":%.2f,\"operations\":%zu,\"ns_per_op\":%.2f,"
+           "\"allocs_per_op\":%.4f}\n",
+           benchmark, distribution, size, load_factor, operations,
+           timer->elapsed_ns / operations, (double)timer->allocations / operations);
+
+    return;
+}
+
+uint64_t xorshift(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+void fill_keys(uint64_t *keys, uint64_t *missing_keys, size_t size, int random)
+{
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        keys[i] = random ? xorshift(&state) | 1 : i * 2;
+        missing_keys[i] = random ? xorshift(&state) & ~(uint64_t)1 : i * 2 + 1;
+    }
+
+    return;
+}
+
+void bench_hashmap(const char *distribution, uint64_t *keys, uint64_t *missing_keys,
+                   size_t size, double load_factor)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer set_timer;
+    struct BenchTimer overwrite_timer;
+    struct BenchTimer hit_timer;
+    struct BenchTimer miss_timer;
+    struct BenchTimer remove_timer;
+    size_t capacity = (size_t)(size / load_factor);
+    size_t rounds = BENCH_MIN_OPERATIONS / size == 0 ? 1 : BENCH_MIN_OPERATIONS / size;
+
+    bench_init(&set_timer, &counting_allocator);
+    bench_init(&overwrite_timer, &counting_allocator);
+    bench_init(&hit_timer, &counting_allocator);
+    bench_init(&miss_timer, &counting_allocator);
+    bench_init(&remove_timer, &counting_allocator);
+
+    for (size_t round = 0; round < rounds; round++)
+    {
+        struct HashMap *hashmap = hm_create_with_allocator(
+            capacity, hm_hash_uint64, hm_compare_uint64, allocator);
+
+        bench_start(&set_timer);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            hm_set(hashmap, &keys[i], &keys[i]);
+        }
+
+        bench_stop(&set_timer);
+        bench_start(&overwrite_timer);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            hm_set(hashmap, &keys[i], &missing_keys[i]);
+        }
+
+        bench_stop(&overwrite_timer);
+        bench_start(&hit_timer);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            bench_sink += (uintptr_t)hm_get(hashmap, &keys[i]);
+        }
+
+        bench_stop(&hit_timer);
+        bench_start(&miss_timer);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            bench_sink += (uintptr_t)hm_get(hashmap, &missing_keys[i]);
+        }
+
+        bench_stop(&miss_timer);
+        bench_start(&remove_timer);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            bench_sink += (uintptr_t)hm_remove(hashmap, &keys[i]);
+        }
+
+        bench_stop(&remove_timer);
+
+        hm_free(hashmap, NULL);
+    }
+
+    size_t operations = rounds * size;
+
+    bench_report("hm_set", distribution, size, load_factor, operations, &set_timer);
+    bench_report("hm_set_overwrite", distribution, size, load_factor, operations,
+                 &overwrite_timer);
+    bench_report("hm_get_hit", distribution, size, load_factor, operations, &hit_timer);
+    bench_report("hm_get_miss", distribution, size, load_factor, operations,
+                 &miss_timer);
+    bench_report("hm_remove", distribution, size, load_factor, operations,
+                 &remove_timer);
+
+    return;
+}
+
+int main()
+{
+    size_t sizes[] = {8, 1024, BENCH_MAX_SIZE};
+    double load_factors[] = {0.25, 0.5, 0.75, 1.0};
+    const char *distributions[] = {"sequential", "random"};
+
+    uint64_t *keys = malloc(BENCH_MAX_SIZE * sizeof(uint64_t));
+    uint64_t *missing_keys = malloc(BENCH_MAX_SIZE * sizeof(uint64_t));
+
+    for (int random = 0; random < 2; random++)
+    {
+        fill_keys(keys, missing_keys, BENCH_MAX_SIZE, random);
+
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        {
+            for (size_t j = 0; j < sizeof(load_factors) / sizeof(load_factors[0]); j++)
+            {
+                bench_hashmap(distributions[random], keys, missing_keys, sizes[i],
+                              load_factors[j]);
+            }
+        }
+    }
+
+    free(keys);
+    free(missing_keys);
+
+    return 0;
+}
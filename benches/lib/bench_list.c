@@ -0,0 +1,375 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lib/allocator.h"
+#include "lib/list.h"
+
+#define BENCH_MIN_OPERATIONS 1000000
+#define BENCH_SEARCHES 256
+
+struct BenchTimer
+{
+    struct CountingAllocator *counting_allocator;
+    double start_ns;
+    size_t start_allocations;
+    double elapsed_ns;
+    size_t allocations;
+};
+
+volatile uintptr_t bench_sink;
+
+double bench_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+void bench_init(struct BenchTimer *timer, struct CountingAllocator *counting_allocator)
+{
+    timer->counting_allocator = counting_allocator;
+    timer->elapsed_ns = 0;
+    timer->allocations = 0;
+
+    return;
+}
+
+void bench_start(struct BenchTimer *timer)
+{
+    timer->start_allocations = timer->counting_allocator->allocations;
+    timer->start_ns = bench_now_ns();
+
+    return;
+}
+
+void bench_stop(struct BenchTimer *timer)
+{
+    timer->elapsed_ns += bench_now_ns() - timer->start_ns;
+    timer->allocations +=
+        timer->counting_allocator->allocations - timer->start_allocations;
+
+    return;
+}
+
+void bench_report(const char *benchmark, size_t size, size_t operations,
+                  struct BenchTimer *timer)
+{
+    printf("{\"benchmark\":\"%s\",\"distribution\":\"sequential\",\"size\":%zu,"
+           "\"load_factor\":null,\"operations\":%zu,\"ns_per_op\":%.2f,"
+           "\"allocs_per_op\":%.4f}\n",
+           benchmark, size, operations, timer->elapsed_ns / operations,
+           (double)timer->allocations / operations);
+
+    return;
+}
+
+int int_compare_function(void *a, void *b)
+{
+    return *(int *)a - *(int *)b;
+}
+
+struct LinkedList *list_create(struct Allocator *allocator, int *values, size_t size)
+{
+    struct LinkedList *linked_list =
+        ll_create_with_allocator(int_compare_function, allocator);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        ll_push(linked_list, &values[i]);
+    }
+
+    return linked_list;
+}
+
+size_t rounds_for(size_t operations_per_round)
+{
+    size_t rounds = BENCH_MIN_OPERATIONS / operations_per_round;
+
+    return rounds == 0 ? 1 : rounds;
+}
+
+void bench_ll_push(int *values, size_t size, int front)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer timer;
+    size_t rounds = rounds_for(size);
+
+    bench_init(&timer, &counting_allocator);
+
+    for (size_t round = 0; round < rounds; round++)
+    {
+        struct LinkedList *linked_list = list_create(allocator, values, 0);
+
+        bench_start(&timer);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            if (front)
+            {
+                ll_push_front(linked_list, &values[i]);
+            }
+            else
+            {
+                ll_push(linked_list, &values[i]);
+            }
+        }
+
+        bench_stop(&timer);
+
+        ll_free(linked_list, NULL);
+    }
+
+    bench_report(front ? "ll_push_front" : "ll_push", size, rounds * size, &timer);
+
+    return;
+}
+
+void bench_ll_pop(int *values, size_t size, int front)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer timer;
+    size_t pops = front || size < BENCH_SEARCHES ? size : BENCH_SEARCHES;
+    size_t rounds = rounds_for(front ? pops : pops * size);
+
+    bench_init(&timer, &counting_allocator);
+
+    for (size_t round = 0; round < rounds; round++)
+    {
+        struct LinkedList *linked_list = list_create(allocator, values, size);
+
+        bench_start(&timer);
+
+        for (size_t i = 0; i < pops; i++)
+        {
+            bench_sink += (uintptr_t)(front ? ll_pop_front(linked_list)
+                                            : ll_pop(linked_list));
+        }
+
+        bench_stop(&timer);
+
+        ll_free(linked_list, NULL);
+    }
+
+    bench_report(front ? "ll_pop_front" : "ll_pop", size, rounds * pops, &timer);
+
+    return;
+}
+
+void bench_ll_peek(int *values, size_t size)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer timer;
+    struct LinkedList *linked_list = list_create(allocator, values, size);
+
+    bench_init(&timer, &counting_allocator);
+    bench_start(&timer);
+
+    for (size_t i = 0; i < BENCH_MIN_OPERATIONS; i++)
+    {
+        bench_sink += (uintptr_t)ll_peek_front(linked_list);
+        bench_sink += (uintptr_t)ll_peek_back(linked_list);
+    }
+
+    bench_stop(&timer);
+    bench_report("ll_peek", size, BENCH_MIN_OPERATIONS * 2, &timer);
+
+    ll_free(linked_list, NULL);
+
+    return;
+}
+
+void bench_ll_iter(int *values, size_t size)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer timer;
+    struct LinkedList *linked_list = list_create(allocator, values, size);
+    struct LinkedListIterator iterator;
+    struct LinkedListNode *node;
+    size_t rounds = rounds_for(size);
+
+    bench_init(&timer, &counting_allocator);
+    bench_start(&timer);
+
+    for (size_t round = 0; round < rounds; round++)
+    {
+        ll_iter_begin(linked_list, &iterator);
+
+        while ((node = ll_iter_next(&iterator)) != NULL)
+        {
+            bench_sink += (uintptr_t)node->value;
+        }
+    }
+
+    bench_stop(&timer);
+    bench_report("ll_iter", size, rounds * size, &timer);
+
+    ll_free(linked_list, NULL);
+
+    return;
+}
+
+void bench_ll_search(int *values, size_t size)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer get_timer;
+    struct BenchTimer has_timer;
+    struct LinkedList *linked_list = list_create(allocator, values, size);
+    struct LinkedListNode *nodes[BENCH_SEARCHES];
+
+    bench_init(&get_timer, &counting_allocator);
+    bench_init(&has_timer, &counting_allocator);
+    bench_start(&get_timer);
+
+    for (size_t i = 0; i < BENCH_SEARCHES; i++)
+    {
+        nodes[i] = ll_get_node_by_value(linked_list, &values[(i * 7919) % size]);
+    }
+
+    bench_stop(&get_timer);
+    bench_start(&has_timer);
+
+    for (size_t i = 0; i < BENCH_SEARCHES; i++)
+    {
+        bench_sink += ll_has_node(linked_list, nodes[i]);
+    }
+
+    bench_stop(&has_timer);
+    bench_report("ll_get_node_by_value", size, BENCH_SEARCHES, &get_timer);
+    bench_report("ll_has_node", size, BENCH_SEARCHES, &has_timer);
+
+    ll_free(linked_list, NULL);
+
+    return;
+}
+
+void bench_ll_insert(int *values, size_t size)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer timers[4];
+    struct LinkedList *linked_list = list_create(allocator, values, size);
+    int inserted = -1;
+
+    for (int i = 0; i < 4; i++)
+    {
+        bench_init(&timers[i], &counting_allocator);
+    }
+
+    bench_start(&timers[0]);
+
+    for (size_t i = 0; i < BENCH_SEARCHES; i++)
+    {
+        ll_insert_after_node(linked_list, linked_list->head, &inserted);
+    }
+
+    bench_stop(&timers[0]);
+    bench_start(&timers[1]);
+
+    for (size_t i = 0; i < BENCH_SEARCHES; i++)
+    {
+        ll_insert_before_node(linked_list, linked_list->tail, &inserted);
+    }
+
+    bench_stop(&timers[1]);
+    bench_start(&timers[2]);
+
+    for (size_t i = 0; i < BENCH_SEARCHES; i++)
+    {
+        ll_insert_after_value(linked_list, &values[size - 1], &inserted);
+    }
+
+    bench_stop(&timers[2]);
+    bench_start(&timers[3]);
+
+    for (size_t i = 0; i < BENCH_SEARCHES; i++)
+    {
+        ll_insert_before_value(linked_list, &values[size - 1], &inserted);
+    }
+
+    bench_stop(&timers[3]);
+    bench_report("ll_insert_after_node", size, BENCH_SEARCHES, &timers[0]);
+    bench_report("ll_insert_before_node", size, BENCH_SEARCHES, &timers[1]);
+    bench_report("ll_insert_after_value", size, BENCH_SEARCHES, &timers[2]);
+    bench_report("ll_insert_before_value", size, BENCH_SEARCHES, &timers[3]);
+
+    ll_free(linked_list, NULL);
+
+    return;
+}
+
+void bench_ll_remove(int *values, size_t size)
+{
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+    struct BenchTimer node_timer;
+    struct BenchTimer value_timer;
+    size_t removals = size < BENCH_SEARCHES ? size : BENCH_SEARCHES;
+
+    bench_init(&node_timer, &counting_allocator);
+    bench_init(&value_timer, &counting_allocator);
+
+    struct LinkedList *linked_list = list_create(allocator, values, size);
+
+    bench_start(&node_timer);
+
+    for (size_t i = 0; i < removals; i++)
+    {
+        ll_remove_node(linked_list, linked_list->tail);
+    }
+
+    bench_stop(&node_timer);
+
+    ll_free(linked_list, NULL);
+    linked_list = list_create(allocator, values, size);
+
+    bench_start(&value_timer);
+
+    for (size_t i = 0; i < removals; i++)
+    {
+        ll_remove_value(linked_list, &values[size - 1 - i]);
+    }
+
+    bench_stop(&value_timer);
+    bench_report("ll_remove_node", size, removals, &node_timer);
+    bench_report("ll_remove_value", size, removals, &value_timer);
+
+    ll_free(linked_list, NULL);
+
+    return;
+}
+
+int main()
+{
+    size_t sizes[] = {16, 1024, 16384};
+    int *values = malloc(16384 * sizeof(int));
+
+    for (int i = 0; i < 16384; i++)
+    {
+        values[i] = i;
+    }
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        bench_ll_push(values, sizes[i], 0);
+        bench_ll_push(values, sizes[i], 1);
+        bench_ll_pop(values, sizes[i], 0);
+        bench_ll_pop(values, sizes[i], 1);
+        bench_ll_peek(values, sizes[i]);
+        bench_ll_iter(values, sizes[i]);
+        bench_ll_search(values, sizes[i]);
+        bench_ll_insert(values, sizes[i]);
+        bench_ll_remove(values, sizes[i]);
+    }
+
+    free(values);
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * @brief A pluggable memory allocator interface used by every container.
+ */
+
+#ifndef __ALLOCATOR_H
+#define __ALLOCATOR_H
+
+#include <stddef.h>
+
+/**
+ * @brief A function that allocates memory.
+ * @param context The context pointer of the allocator.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+typedef void *(*AllocatorAllocFunction)(void *, size_t);
+
+/**
+ * @brief A function that resizes memory.
+ * @param context The context pointer of the allocator.
+ * @param pointer A pointer to the memory to resize.
+ * @param old_size The size the memory was allocated with.
+ * @param new_size The size to resize the memory to.
+ * @return A pointer to the resized memory, or NULL if the allocation failed, in which
+ *         case the original memory is left untouched.
+ */
+typedef void *(*AllocatorReallocFunction)(void *, void *, size_t, size_t);
+
+/**
+ * @brief A function that frees memory.
+ * @param context The context pointer of the allocator.
+ * @param pointer A pointer to the memory to free.
+ * @param size The size the memory was allocated with.
+ * @return void
+ */
+typedef void (*AllocatorFreeFunction)(void *, void *, size_t);
+
+/**
+ * @struct Allocator
+ * @brief A memory allocator.
+ *
+ * This allocator contains pointers to functions that allocate, resize and free
+ * memory, as well as a context pointer that is passed to each of them.
+ *
+ * Every free and resize is passed the size the memory was allocated with, so that
+ * allocators do not have to store it. If realloc is NULL, resizing allocates new
+ * memory and copies the old contents over. If free is NULL, memory is only ever
+ * released in bulk, as with an arena, and containers skip freeing their elements
+ * one by one.
+ *
+ * Containers keep a pointer to the allocator they were created with, so it has to
+ * outlive them. Wherever an allocator is accepted, NULL selects malloc and free.
+ */
+struct Allocator
+{
+    AllocatorAllocFunction alloc;
+    AllocatorReallocFunction realloc;
+    AllocatorFreeFunction free;
+    void *context;
+};
+
+/**
+ * @struct CountingAllocator
+ * @brief An allocator that counts the allocations made through it.
+ *
+ * This allocator contains the allocator interface to pass to containers, a pointer
+ * to the allocator it forwards to, the number of allocations and frees made, the
+ * number of bytes currently allocated, as well as the peak of that number.
+ */
+struct CountingAllocator
+{
+    struct Allocator allocator;
+    const struct Allocator *parent;
+    size_t allocations;
+    size_t frees;
+    size_t bytes_in_use;
+    size_t peak_bytes_in_use;
+};
+
+/**
+ * @brief Allocates memory from an allocator.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+void *allocator_alloc(const struct Allocator *allocator, size_t size);
+
+/**
+ * @brief Resizes memory allocated from an allocator.
+ * @param allocator A pointer to the allocator the memory was allocated from, or NULL
+ *                  for malloc.
+ * @param pointer A pointer to the memory to resize, or NULL to allocate.
+ * @param old_size The size the memory was allocated with.
+ * @param new_size The size to resize the memory to.
+ * @return A pointer to the resized memory, or NULL if the allocation failed, in which
+ *         case the original memory is left untouched.
+ */
+void *allocator_realloc(const struct Allocator *allocator, void *pointer,
+                        size_t old_size, size_t new_size);
+
+/**
+ * @brief Frees memory allocated from an allocator.
+ * @param allocator A pointer to the allocator the memory was allocated from, or NULL
+ *                  for malloc.
+ * @param pointer A pointer to the memory to free.
+ * @param size The size the memory was allocated with.
+ * @return void
+ */
+void allocator_free(const struct Allocator *allocator, void *pointer, size_t size);
+
+/**
+ * @brief Checks if an allocator frees its allocations one at a time.
+ * @param allocator A pointer to the allocator to check, or NULL for malloc.
+ * @return 1 if the allocator has a free function, 0 if it only releases memory in bulk.
+ */
+int allocator_frees_individually(const struct Allocator *allocator);
+
+/**
+ * @brief Initializes a counting allocator.
+ * @param counting_allocator A pointer to the counting allocator to initialize.
+ * @param parent A pointer to the allocator to forward to, or NULL for malloc.
+ * @return A pointer to the allocator interface to pass to containers.
+ */
+struct Allocator *counting_allocator_init(struct CountingAllocator *counting_allocator,
+                                          const struct Allocator *parent);
+
+#endif
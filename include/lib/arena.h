@@ -0,0 +1,104 @@
+/**
+ * @brief A bump pointer arena allocator that frees everything at once.
+ */
+
+#ifndef __ARENA_H
+#define __ARENA_H
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+
+/**
+ * @brief The alignment of every allocation made from an arena.
+ */
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+
+/**
+ * @struct ArenaBlock
+ * @brief A block of memory that arena allocations are carved out of.
+ *
+ * This block contains a pointer to the next block of the arena, as well as the
+ * number of usable bytes in it. The usable bytes follow the block header in the
+ * same allocation.
+ */
+struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t size;
+};
+
+/**
+ * @struct Arena
+ * @brief An arena of memory.
+ *
+ * This arena contains the default size of its blocks, pointers to its first block
+ * and the block currently allocated from, the unused range of the current block,
+ * the allocator interface to pass to containers, as well as a pointer to the
+ * allocator its blocks are allocated from.
+ *
+ * Allocating bumps cursor. Resetting the arena moves cursor back to the start of
+ * the first block and keeps every block for reuse, so it takes constant time no
+ * matter how much was allocated.
+ *
+ * The allocator interface has no free function. Containers created with it skip
+ * freeing their elements one by one, and do not need to be freed at all if the
+ * arena is reset or freed instead.
+ */
+struct Arena
+{
+    size_t block_size;
+    struct ArenaBlock *first_block;
+    struct ArenaBlock *current_block;
+    char *cursor;
+    char *end;
+    struct Allocator allocator;
+    const struct Allocator *parent;
+};
+
+/**
+ * @brief Creates a new arena.
+ * @param block_size The number of bytes to allocate for each block.
+ * @return A pointer to the created arena.
+ */
+struct Arena *arena_create(size_t block_size);
+
+/**
+ * @brief Creates a new arena that allocates its blocks from an allocator.
+ * @param block_size The number of bytes to allocate for each block.
+ * @param parent A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created arena.
+ */
+struct Arena *arena_create_with_allocator(size_t block_size,
+                                          const struct Allocator *parent);
+
+/**
+ * @brief Frees an arena and everything allocated from it.
+ * @param arena A pointer to the arena to free.
+ * @return void
+ */
+void arena_free(struct Arena *arena);
+
+/**
+ * @brief Allocates memory from an arena.
+ * @param arena A pointer to the arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+void *arena_alloc(struct Arena *arena, size_t size);
+
+/**
+ * @brief Frees everything allocated from an arena, keeping its blocks for reuse.
+ * @param arena A pointer to the arena to reset.
+ * @return void
+ */
+void arena_reset(struct Arena *arena);
+
+/**
+ * @brief Gets the allocator interface of an arena.
+ * @param arena A pointer to the arena.
+ * @return A pointer to the allocator interface to pass to containers.
+ */
+struct Allocator *arena_allocator(struct Arena *arena);
+
+#endif
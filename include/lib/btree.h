@@ -0,0 +1,185 @@
+/**
+ * @brief An ordered map from 64-bit integer keys to generic values, kept in a B+tree.
+ */
+
+#ifndef __BTREE_H
+#define __BTREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/list.h"
+
+/**
+ * @brief The maximum number of keys in a node of a B+tree.
+ *
+ * Every node has room for one key more than this while it is being split, so the
+ * keys of a node take up 128 bytes.
+ */
+#define BT_NODE_KEYS 15
+
+/**
+ * @brief The minimum number of keys in every node of a B+tree except the root.
+ */
+#define BT_MIN_KEYS (BT_NODE_KEYS / 2)
+
+/**
+ * @brief The maximum height of a B+tree.
+ *
+ * Every node below the root has at least BT_MIN_KEYS + 1 children, so a tree this
+ * tall holds more keys than fit in memory.
+ */
+#define BT_MAX_HEIGHT 32
+
+/**
+ * @struct BTreeNode
+ * @brief The part shared by the leaves and internal nodes of a B+tree.
+ *
+ * This node contains its keys in ascending order, the number of keys in it, as
+ * well as whether it is a leaf. The keys are stored contiguously ahead of the
+ * count and leaf flag, so that a search scans them as one array.
+ */
+struct BTreeNode
+{
+    uint64_t keys[BT_NODE_KEYS + 1];
+    size_t count;
+    int is_leaf;
+};
+
+/**
+ * @struct BTreeLeaf
+ * @brief A leaf of a B+tree.
+ *
+ * This leaf contains the shared node, the value of each of its keys, as well as a
+ * pointer to the leaf holding the next larger keys, so that ranges are walked
+ * without going back up the tree.
+ */
+struct BTreeLeaf
+{
+    struct BTreeNode node;
+    void *values[BT_NODE_KEYS + 1];
+    struct BTreeLeaf *next;
+};
+
+/**
+ * @struct BTreeInternal
+ * @brief An internal node of a B+tree.
+ *
+ * This node contains the shared node, as well as one child more than it has keys.
+ * Every key in children[i] is smaller than keys[i], and every key in children[i + 1]
+ * is at least keys[i].
+ */
+struct BTreeInternal
+{
+    struct BTreeNode node;
+    struct BTreeNode *children[BT_NODE_KEYS + 2];
+};
+
+/**
+ * @struct BTree
+ * @brief An ordered map from 64-bit integer keys to generic values.
+ *
+ * This tree contains a pointer to its root, the number of keys in it, as well as a
+ * pointer to the allocator its nodes are allocated from.
+ *
+ * Values are only kept in the leaves, which are linked in key order, so looking up
+ * a key takes O(log n) time and walking k keys from there takes O(k) more. Nodes
+ * split when they overflow and borrow from or merge with a sibling when they fall
+ * below BT_MIN_KEYS, so every leaf is at the same depth. The root is NULL until the
+ * first key is inserted, and after the last key is removed.
+ */
+struct BTree
+{
+    struct BTreeNode *root;
+    size_t size;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @struct BTreeIterator
+ * @brief A cursor over the keys of a B+tree in ascending order.
+ *
+ * This iterator contains a pointer to the leaf it is in, as well as the index of
+ * the next key in that leaf. The tree must not be changed while it is iterated.
+ */
+struct BTreeIterator
+{
+    struct BTreeLeaf *leaf;
+    size_t index;
+};
+
+/**
+ * @brief Creates a new B+tree.
+ * @return A pointer to the created tree.
+ */
+struct BTree *bt_create(void);
+
+/**
+ * @brief Creates a new B+tree that allocates from an allocator.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created tree.
+ */
+struct BTree *bt_create_with_allocator(const struct Allocator *allocator);
+
+/**
+ * @brief Frees a B+tree.
+ * @param tree A pointer to the tree to free.
+ * @param value_free_function A function that frees a value in the tree. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+void bt_free(struct BTree *tree, ValueFreeFunction value_free_function);
+
+/**
+ * @brief Inserts a key-value pair into a B+tree, replacing the value if the key is
+ *        already in it.
+ * @param tree A pointer to the tree to insert into.
+ * @param key The key to insert.
+ * @param value A pointer to the value to insert.
+ * @return 0 if the key-value pair was inserted successfully, -1 otherwise.
+ */
+int bt_insert(struct BTree *tree, uint64_t key, void *value);
+
+/**
+ * @brief Gets a value from a B+tree.
+ * @param tree A pointer to the tree to get from.
+ * @param key The key to get.
+ * @return A pointer to the value, or NULL if the key is not in the tree.
+ */
+void *bt_get(struct BTree *tree, uint64_t key);
+
+/**
+ * @brief Removes a key-value pair from a B+tree.
+ * @param tree A pointer to the tree to remove from.
+ * @param key The key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the tree.
+ */
+void *bt_remove(struct BTree *tree, uint64_t key);
+
+/**
+ * @brief Gets the number of keys in a B+tree.
+ * @param tree A pointer to the tree.
+ * @return The number of keys.
+ */
+size_t bt_size(struct BTree *tree);
+
+/**
+ * @brief Starts iterating over the keys of a B+tree from a given key.
+ * @param tree A pointer to the tree to iterate over.
+ * @param from The smallest key to return. Pass 0 to iterate over every key.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return void
+ */
+void bt_iter_begin(struct BTree *tree, uint64_t from, struct BTreeIterator *iterator);
+
+/**
+ * @brief Advances an iterator to the next key of a B+tree.
+ * @param iterator A pointer to the iterator to advance.
+ * @param key A pointer that is set to the key. Pass NULL if it is not needed.
+ * @param value A pointer that is set to the value. Pass NULL if it is not needed.
+ * @return 1 if a key was returned, 0 if every key has been returned.
+ */
+int bt_iter_next(struct BTreeIterator *iterator, uint64_t *key, void **value);
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @brief A concurrent hashmap with lock-free lookups and striped writer locks.
+ */
+
+#ifndef __CHASHMAP_H
+#define __CHASHMAP_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/epoch.h"
+#include "lib/hashmap.h"
+
+/**
+ * @brief The number of locks a concurrent hashmap spreads its buckets over.
+ *
+ * This is a power of two, and also the smallest capacity of a concurrent hashmap,
+ * so that every bucket is guarded by exactly one lock at every capacity.
+ */
+#define CHM_STRIPES 64
+
+/**
+ * @brief The size of a cache line, which every stripe is padded to.
+ */
+#define CHM_CACHE_LINE_SIZE 64
+
+/**
+ * @struct ConcurrentHashMapEntry
+ * @brief An entry in a concurrent hashmap bucket.
+ *
+ * This entry contains the key, value and hash of the entry, a pointer to the next
+ * entry in the same bucket, as well as its reclamation state once it is retired.
+ *
+ * An entry never changes once it is published. Setting an existing key replaces the
+ * entry with a new one, so lock-free readers always see a consistent key and value.
+ */
+struct ConcurrentHashMapEntry
+{
+    struct HashMapEntry entry;
+    _Atomic(struct ConcurrentHashMapEntry *) next;
+    struct EpochNode epoch_node;
+};
+
+/**
+ * @struct ConcurrentHashMapTable
+ * @brief The bucket array of a concurrent hashmap.
+ *
+ * This table contains its reclamation state once it is retired, a power of two
+ * capacity, as well as the buckets themselves.
+ */
+struct ConcurrentHashMapTable
+{
+    struct EpochNode epoch_node;
+    size_t capacity;
+    _Atomic(struct ConcurrentHashMapEntry *) buckets[];
+};
+
+/**
+ * @struct ConcurrentHashMapStripe
+ * @brief A lock guarding every CHM_STRIPES-th bucket of a concurrent hashmap.
+ *
+ * The lock is padded to at least a cache line, so that threads taking different
+ * stripes do not keep stealing the same cache line from each other.
+ */
+struct ConcurrentHashMapStripe
+{
+    pthread_rwlock_t lock;
+    char padding[CHM_CACHE_LINE_SIZE - sizeof(pthread_rwlock_t) % CHM_CACHE_LINE_SIZE];
+};
+
+/**
+ * @struct ConcurrentHashMap
+ * @brief A generic hashmap that can be shared by many threads.
+ *
+ * This concurrent hashmap contains a pointer to its current table, the number of
+ * entries it holds, the locks guarding its buckets, pointers to a hash function and
+ * key compare function, as well as a pointer to the allocator it was allocated
+ * from.
+ *
+ * Lookups take no lock. They enter an epoch critical section and walk the current
+ * table, while writers publish every change with a single atomic store. Entries
+ * that are removed or replaced, and tables that are outgrown, are retired through
+ * epoch_retire and only freed once no lookup can still see them.
+ *
+ * Writers lock bucket i with stripes[i % CHM_STRIPES], so only writers to the same
+ * stripe exclude each other. A thread that pushes the load factor past
+ * HM_MAX_LOAD_PERCENT allocates a table of twice the capacity and copies of the
+ * entries, then takes every stripe, in order, and publishes the new table filled
+ * with the copies, so that lookups still walking the old table never lose their
+ * way. The old table is retired together with its entries. Since the capacity is a
+ * multiple of CHM_STRIPES, the stripe of a key never changes when the hashmap
+ * grows.
+ *
+ * The allocator the hashmap was created with has to be safe to call from every
+ * thread that uses the hashmap.
+ */
+struct ConcurrentHashMap
+{
+    _Atomic(struct ConcurrentHashMapTable *) table;
+    atomic_size_t size;
+    struct ConcurrentHashMapStripe stripes[CHM_STRIPES];
+    HashMapHashFunction hash_function;
+    HashMapKeyCompareFunction key_compare_function;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new concurrent hashmap.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two
+ *                 of at least CHM_STRIPES.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @return A pointer to the created concurrent hashmap, or NULL if the capacity has
+ *         no power of two that fits in a size_t or an allocation failed.
+ */
+struct ConcurrentHashMap *chm_create(size_t capacity, HashMapHashFunction hash_function,
+                                     HashMapKeyCompareFunction key_compare_function);
+
+/**
+ * @brief Creates a new concurrent hashmap that allocates from an allocator.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two
+ *                 of at least CHM_STRIPES.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @param allocator A pointer to a thread safe allocator to allocate from, or NULL
+ *                  for malloc.
+ * @return A pointer to the created concurrent hashmap, or NULL if the capacity has
+ *         no power of two that fits in a size_t or an allocation failed.
+ */
+struct ConcurrentHashMap *
+chm_create_with_allocator(size_t capacity, HashMapHashFunction hash_function,
+                          HashMapKeyCompareFunction key_compare_function,
+                          const struct Allocator *allocator);
+
+/**
+ * @brief Frees a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to free. No other
+ *                           thread may be using it, and the calling thread may not
+ *                           be inside an epoch critical section.
+ * @param entry_free_function A function that frees an entry in the hashmap.
+ *                            Pass NULL if the entries do not need to be freed.
+ * @return void
+ */
+void chm_free(struct ConcurrentHashMap *concurrent_hashmap,
+              HashMapEntryFreeFunction entry_free_function);
+
+/**
+ * @brief Sets a key-value pair in a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ */
+int chm_set(struct ConcurrentHashMap *concurrent_hashmap, void *key, void *value);
+
+/**
+ * @brief Gets a value from a concurrent hashmap without taking a lock.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ */
+void *chm_get(struct ConcurrentHashMap *concurrent_hashmap, void *key);
+
+/**
+ * @brief Removes a key-value pair from a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ */
+void *chm_remove(struct ConcurrentHashMap *concurrent_hashmap, void *key);
+
+/**
+ * @brief Gets the number of entries in a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap.
+ * @return The number of entries, which other threads may change at any time.
+ */
+size_t chm_size(struct ConcurrentHashMap *concurrent_hashmap);
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @brief A generic double-ended queue backed by a ring buffer.
+ */
+
+#ifndef __DEQUE_H
+#define __DEQUE_H
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+#include "lib/list.h"
+
+/**
+ * @brief The capacity a deque grows to when its first value is added.
+ */
+#define DQ_MIN_CAPACITY 8
+
+/**
+ * @struct Deque
+ * @brief A double-ended queue.
+ *
+ * This deque contains a power of two capacity, the index of its first value, the
+ * number of values in it, a pointer to its slots, as well as a pointer to the
+ * allocator it was allocated from.
+ *
+ * Values wrap around the end of the slots, so pushing and popping at either end
+ * takes constant time and never moves the other values. When the deque is full,
+ * its capacity doubles and the values are copied to the start of the new slots.
+ */
+struct Deque
+{
+    size_t capacity;
+    size_t head;
+    size_t size;
+    void **slots;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new deque.
+ * @return A pointer to the created deque.
+ */
+struct Deque *dq_create(void);
+
+/**
+ * @brief Creates a new deque that allocates from an allocator.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created deque.
+ */
+struct Deque *dq_create_with_allocator(const struct Allocator *allocator);
+
+/**
+ * @brief Frees a deque.
+ * @param deque A pointer to the deque to free.
+ * @param value_free_function A function that frees a value in the deque. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+void dq_free(struct Deque *deque, ValueFreeFunction value_free_function);
+
+/**
+ * @brief Gets a value of a deque.
+ * @param deque A pointer to the deque to get from.
+ * @param index The index of the value to get, counting from the front.
+ * @return A pointer to the value, or NULL if the index is out of bounds.
+ */
+void *dq_get(struct Deque *deque, size_t index);
+
+/**
+ * @brief Pushes a value onto the back of a deque.
+ * @param deque A pointer to the deque to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dq_push_back(struct Deque *deque, void *value);
+
+/**
+ * @brief Pushes a value onto the front of a deque.
+ * @param deque A pointer to the deque to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dq_push_front(struct Deque *deque, void *value);
+
+/**
+ * @brief Pops a value from the back of a deque.
+ * @param deque A pointer to the deque to pop from.
+ * @return A pointer to the popped value, or NULL if the deque is empty.
+ */
+void *dq_pop_back(struct Deque *deque);
+
+/**
+ * @brief Pops a value from the front of a deque.
+ * @param deque A pointer to the deque to pop from.
+ * @return A pointer to the popped value, or NULL if the deque is empty.
+ */
+void *dq_pop_front(struct Deque *deque);
+
+/**
+ * @brief Gets the value at the front of a deque without removing it.
+ * @param deque A pointer to the deque to peek at.
+ * @return A pointer to the value, or NULL if the deque is empty.
+ */
+void *dq_peek_front(struct Deque *deque);
+
+/**
+ * @brief Gets the value at the back of a deque without removing it.
+ * @param deque A pointer to the deque to peek at.
+ * @return A pointer to the value, or NULL if the deque is empty.
+ */
+void *dq_peek_back(struct Deque *deque);
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @brief A generic doubly linked list implementation.
+ */
+
+#ifndef __DLIST_H
+#define __DLIST_H
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+#include "lib/list.h"
+#include "lib/pool.h"
+
+/**
+ * @struct DoublyLinkedListNode
+ * @brief A node in a doubly linked list.
+ *
+ * This node contains a generic value, as well as pointers to the previous and next
+ * nodes in the list.
+ */
+struct DoublyLinkedListNode
+{
+    void *value;
+    struct DoublyLinkedListNode *prev;
+    struct DoublyLinkedListNode *next;
+};
+
+/**
+ * @struct DoublyLinkedList
+ * @brief A doubly linked list.
+ *
+ * This doubly linked list contains a size, a pointer to it's head and tail nodes,
+ * a pointer to a function compares values contained in the list,
+ * a pointer to the pool its nodes are allocated from,
+ * as well as a pointer to the allocator it was allocated from.
+ *
+ * If node_pool is NULL, nodes are allocated from the allocator.
+ *
+ * Every operation on a node takes constant time, as nodes know their predecessor.
+ * In exchange, the list trusts that the nodes passed to it belong to it.
+ */
+struct DoublyLinkedList
+{
+    size_t size;
+    struct DoublyLinkedListNode *head;
+    struct DoublyLinkedListNode *tail;
+    ValueCompareFunction value_compare_function;
+    struct Pool *node_pool;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new doubly linked list.
+ * @param value_compare_function A function that compares two values in the list.
+ * @return A pointer to the created doubly linked list.
+ */
+struct DoublyLinkedList *dll_create(ValueCompareFunction value_compare_function);
+
+/**
+ * @brief Creates a new doubly linked list that allocates from an allocator.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created doubly linked list.
+ */
+struct DoublyLinkedList *
+dll_create_with_allocator(ValueCompareFunction value_compare_function,
+                          const struct Allocator *allocator);
+
+/**
+ * @brief Creates a new doubly linked list that allocates its nodes from a pool.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param node_pool A pointer to a pool of objects of
+ *                  sizeof(struct DoublyLinkedListNode) bytes. The pool may be shared
+ *                  by many lists and must outlive them.
+ * @return A pointer to the created doubly linked list.
+ */
+struct DoublyLinkedList *
+dll_create_with_pool(ValueCompareFunction value_compare_function,
+                     struct Pool *node_pool);
+
+/**
+ * @brief Frees a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to free.
+ * @param value_free_function A function that frees a value in the list. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+void dll_free(struct DoublyLinkedList *doubly_linked_list,
+              ValueFreeFunction value_free_function);
+
+/**
+ * @brief Gets a node from a doubly linked list by its value.
+ * @param doubly_linked_list A pointer to the doubly linked list to search.
+ * @param value A pointer to the value to search for.
+ * @return A pointer to the node with the value, or NULL if the value is not found.
+ */
+struct DoublyLinkedListNode *
+dll_get_node_by_value(struct DoublyLinkedList *doubly_linked_list, void *value);
+
+/**
+ * @brief Pushes a value onto the tail of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dll_push(struct DoublyLinkedList *doubly_linked_list, void *value);
+
+/**
+ * @brief Pushes a value onto the head of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dll_push_front(struct DoublyLinkedList *doubly_linked_list, void *value);
+
+/**
+ * @brief Pops a value from the tail of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to pop from.
+ * @return A pointer to the popped value, or NULL if the list is empty.
+ */
+void *dll_pop(struct DoublyLinkedList *doubly_linked_list);
+
+/**
+ * @brief Pops a value from the head of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to pop from.
+ * @return A pointer to the popped value, or NULL if the list is empty.
+ */
+void *dll_pop_front(struct DoublyLinkedList *doubly_linked_list);
+
+/**
+ * @brief Inserts a value before a node in a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to insert into.
+ * @param node A pointer to the node to insert before.
+ * @param value A pointer to the value to insert.
+ * @return 0 if the value was inserted successfully, -1 otherwise.
+ */
+int dll_insert_before_node(struct DoublyLinkedList *doubly_linked_list,
+                           struct DoublyLinkedListNode *node, void *value);
+
+/**
+ * @brief Inserts a value after a node in a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to insert into.
+ * @param node A pointer to the node to insert after.
+ * @param value A pointer to the value to insert.
+ * @return 0 if the value was inserted successfully, -1 otherwise.
+ */
+int dll_insert_after_node(struct DoublyLinkedList *doubly_linked_list,
+                          struct DoublyLinkedListNode *node, void *value);
+
+/**
+ * @brief Moves a node of a doubly linked list to its head.
+ * @param doubly_linked_list A pointer to the doubly linked list to move in.
+ * @param node A pointer to the node to move.
+ * @return void
+ */
+void dll_move_to_front(struct DoublyLinkedList *doubly_linked_list,
+                       struct DoublyLinkedListNode *node);
+
+/**
+ * @brief Removes a node from a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to remove from.
+ * @param node A pointer to the node to remove.
+ * @return void
+ */
+void dll_remove_node(struct DoublyLinkedList *doubly_linked_list,
+                     struct DoublyLinkedListNode *node);
+
+/**
+ * @brief Removes the first occurrence of a value from a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to remove from.
+ * @param value A pointer to the value to remove.
+ * @return 0 if the value was removed successfully, -1 otherwise.
+ */
+int dll_remove_value(struct DoublyLinkedList *doubly_linked_list, void *value);
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @brief Epoch based reclamation of memory that lock-free readers may still see.
+ */
+
+#ifndef __EPOCH_H
+#define __EPOCH_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The number of retired nodes after which a retiring thread tries to advance
+ *        the epoch and reclaim them.
+ */
+#define EPOCH_RECLAIM_THRESHOLD 64
+
+struct EpochNode;
+
+/**
+ * @brief A function that frees memory once no reader can see it any more.
+ * @param node A pointer to the node embedded in the memory to free.
+ * @param context The context pointer the node was retired with.
+ * @return void
+ */
+typedef void (*EpochFreeFunction)(struct EpochNode *, void *);
+
+/**
+ * @struct EpochNode
+ * @brief The reclamation state of a piece of retired memory.
+ *
+ * This node contains a pointer to the next retired node, the function that frees
+ * the memory, as well as the context pointer to pass to it. It is embedded in the
+ * memory being retired, so retiring never allocates.
+ */
+struct EpochNode
+{
+    struct EpochNode *next;
+    EpochFreeFunction free_function;
+    void *context;
+};
+
+/**
+ * @struct EpochRecord
+ * @brief The announced epoch of a reading thread.
+ *
+ * This record contains the epoch the thread entered, shifted left by one with the
+ * lowest bit set while the thread is inside a critical section, whether a thread
+ * currently owns the record, as well as a pointer to the next record.
+ *
+ * Records are created the first time a thread calls epoch_enter, and are handed to
+ * another thread once their thread exits. They are never freed.
+ */
+struct EpochRecord
+{
+    atomic_uint_fast64_t state;
+    atomic_int in_use;
+    struct EpochRecord *next;
+};
+
+/**
+ * @brief Enters a read-side critical section on the calling thread.
+ * @return 0 if the critical section was entered, -1 if the thread has no record
+ *         and allocating one failed.
+ *
+ * Memory retired after this call is not freed until the matching epoch_exit.
+ * Critical sections may be nested. Entering is wait-free once the thread has a
+ * record.
+ */
+int epoch_enter(void);
+
+/**
+ * @brief Leaves a read-side critical section on the calling thread.
+ * @return void
+ */
+void epoch_exit(void);
+
+/**
+ * @brief Retires memory that has been unlinked from every shared structure.
+ * @param node A pointer to the node embedded in the memory to retire.
+ * @param free_function A function that frees the memory.
+ * @param context A context pointer to pass to free_function.
+ * @return void
+ *
+ * The memory is freed by whichever thread advances the epoch far enough that every
+ * reader that could have seen it has left its critical section.
+ */
+void epoch_retire(struct EpochNode *node, EpochFreeFunction free_function,
+                  void *context);
+
+/**
+ * @brief Waits until every memory retired so far has been freed.
+ * @return void
+ *
+ * The calling thread may not be inside a critical section.
+ */
+void epoch_synchronize(void);
+
+#endif
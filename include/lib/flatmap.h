@@ -0,0 +1,124 @@
+/**
+ * @brief A generic open addressing hashmap that stores its entries in one flat array.
+ *
+ * Slots are grouped into groups of FM_GROUP_WIDTH. Every slot has a control byte
+ * holding either a 7-bit tag taken from the hash of its key, or a marker for an empty
+ * or deleted slot. Lookups scan a whole group of control bytes at a time and only
+ * compare keys whose tag matches, so a lookup touches the control bytes and the slot
+ * array, and never follows a pointer until the key compare function is called.
+ */
+
+#ifndef __FLATMAP_H
+#define __FLATMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/hashmap.h"
+
+/**
+ * @brief The number of slots whose control bytes are scanned together.
+ */
+#define FM_GROUP_WIDTH 16
+
+/**
+ * @brief Whether groups of control bytes are scanned with SSE2 instructions.
+ *
+ * This is chosen when building, and is on whenever the compiler targets SSE2, which
+ * every x86-64 target does. Define FM_USE_SSE2 as 0 to force the portable scalar
+ * loop, which is also used on every other architecture.
+ */
+#ifndef FM_USE_SSE2
+#if defined(__SSE2__)
+#define FM_USE_SSE2 1
+#else
+#define FM_USE_SSE2 0
+#endif
+#endif
+
+/**
+ * @struct FlatMap
+ * @brief A generic open addressing hashmap.
+ *
+ * This hashmap contains its capacity in slots, the number of entries it holds,
+ * the number of empty slots that can still be filled before it has to grow,
+ * a pointer to its control bytes and slots, which live in a single allocation,
+ * pointers to a hash function and key compare function, as well as a pointer to
+ * the allocator it allocates from.
+ *
+ * Each slot is a HashMapEntry, which stores the key, the value and the full hash of
+ * the key inline, so the hash never has to be recomputed when the map grows.
+ */
+struct FlatMap
+{
+    size_t capacity;
+    size_t size;
+    size_t growth_left;
+    int8_t *control;
+    struct HashMapEntry *slots;
+    HashMapHashFunction hash_function;
+    HashMapKeyCompareFunction key_compare_function;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new flat hashmap.
+ * @param capacity The number of entries the hashmap should hold without growing.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @return A pointer to the created hashmap, or NULL if no capacity that fits in a
+ *         size_t can hold that many entries or an allocation failed.
+ */
+struct FlatMap *fm_create(size_t capacity, HashMapHashFunction hash_function,
+                          HashMapKeyCompareFunction key_compare_function);
+
+/**
+ * @brief Creates a new flat hashmap that allocates from an allocator.
+ * @param capacity The number of entries the hashmap should hold without growing.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created hashmap, or NULL if no capacity that fits in a
+ *         size_t can hold that many entries or an allocation failed.
+ */
+struct FlatMap *fm_create_with_allocator(size_t capacity,
+                                         HashMapHashFunction hash_function,
+                                         HashMapKeyCompareFunction key_compare_function,
+                                         const struct Allocator *allocator);
+
+/**
+ * @brief Frees a flat hashmap.
+ * @param flatmap A pointer to the hashmap to free.
+ * @param entry_free_function A function that frees an entry in the hashmap.
+ *                            Pass NULL if the entries do not need to be freed.
+ * @return void
+ */
+void fm_free(struct FlatMap *flatmap, HashMapEntryFreeFunction entry_free_function);
+
+/**
+ * @brief Sets a key-value pair in a flat hashmap.
+ * @param flatmap A pointer to the hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ */
+int fm_set(struct FlatMap *flatmap, void *key, void *value);
+
+/**
+ * @brief Gets a value from a flat hashmap.
+ * @param flatmap A pointer to the hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ */
+void *fm_get(struct FlatMap *flatmap, void *key);
+
+/**
+ * @brief Removes a key-value pair from a flat hashmap.
+ * @param flatmap A pointer to the hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ */
+void *fm_remove(struct FlatMap *flatmap, void *key);
+
+#endif
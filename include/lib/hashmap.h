@@ -6,17 +6,30 @@
 #define __HASHMAP_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
+#include "lib/allocator.h"
 #include "lib/list.h"
+#include "lib/pool.h"
+
+/**
+ * @brief The maximum number of entries or nodes a hashmap allocates at once.
+ */
+#define HM_POOL_MAX_SLAB_OBJECTS 1024
 
 /**
  * @struct HashMapEntry
  * @brief The value stored in a LinkedListNode in a hashmap bucket.
+ *
+ * The full hash of the key is cached so that the hashmap can grow without calling
+ * the hash function again, and can skip comparing keys whose hashes differ.
  */
 struct HashMapEntry
 {
     void *key;
     void *value;
+    uint64_t hash;
 };
 
 /**
@@ -28,15 +41,15 @@ struct HashMapEntry
  */
 typedef void (*HashMapEntryFreeFunction)(struct HashMapEntry *);
 
-struct HashMap;
-
 /**
- * @brief A hash function that hashes a generic key to an index in a hashmap.
- * @param hashmap A pointer to the hashmap to hash into.
+ * @brief A hash function that hashes a generic key to a 64-bit hash.
  * @param key A pointer to the key to hash.
- * @return The index in the hashmap to hash the key to.
+ * @return The full 64-bit hash of the key.
+ *
+ * The hashmap picks a bucket by masking the hash with its power of two capacity,
+ * so the low bits of the hash should depend on every bit of the key.
  */
-typedef size_t (*HashMapHashFunction)(struct HashMap *, void *);
+typedef uint64_t (*HashMapHashFunction)(void *);
 
 /**
  * @brief A function that compares two generic keys.
@@ -48,30 +61,186 @@ typedef int (*HashMapKeyCompareFunction)(void *, void *);
 
 typedef struct LinkedList HashMapBucket;
 
+/**
+ * @brief The load factor, as a percentage, above which a hashmap starts to grow.
+ */
+#define HM_MAX_LOAD_PERCENT 75
+
+/**
+ * @brief The number of old buckets migrated by every operation while a hashmap grows.
+ */
+#define HM_REHASH_STEP 4
+
+/**
+ * @brief The number of keys hm_get_many, hm_set_many and hm_remove_many hash and
+ * prefetch before probing any of them.
+ */
+#define HM_BATCH_SIZE 16
+
+/**
+ * @brief The number of entries a hashmap keeps inline before it switches to buckets.
+ */
+#define HM_SMALL_CAPACITY 8
+
+/**
+ * @brief The number of 64-bit words in the occupancy bitmap of a bucket array.
+ */
+#define HM_OCCUPIED_WORDS(capacity) (((capacity) + 63) / 64)
+
+/**
+ * @brief Whether hashmaps count their lookups and resizes.
+ *
+ * This is chosen when building the library and is off by default, in which case
+ * the counters stay zero and lookups do no extra work. The counters are part of
+ * every hashmap either way, so code built with a different setting than the library
+ * still agrees with it on the layout of struct HashMap. hm_stats works either way,
+ * and leaves out the counters when they are off.
+ */
+#ifndef HM_STATS
+#define HM_STATS 0
+#endif
+
+/**
+ * @brief The number of bins in the probe and chain length histograms of hm_stats.
+ *
+ * Bin i counts lengths of exactly i, and the last bin counts every longer length.
+ */
+#define HM_STATS_HISTOGRAM_SIZE 8
+
+/**
+ * @struct HashMapStats
+ * @brief The counters a hashmap updates when HM_STATS is enabled.
+ *
+ * These counters contain the number of lookups made by every operation, how many
+ * of them found their key, the total number of entries compared against, a
+ * histogram of the number of entries each lookup compared against, as well as the
+ * number of times the hashmap grew.
+ */
+struct HashMapStats
+{
+    size_t lookups;
+    size_t hits;
+    size_t probes;
+    size_t probe_histogram[HM_STATS_HISTOGRAM_SIZE];
+    size_t resizes;
+};
+
 /**
  * @struct HashMap
  * @brief A generic hashmap.
  *
- * This hashmap contains a capacity, a pointer to its buckets,
- * as well as pointers to a hash function and key compare function.
+ * This hashmap contains a power of two capacity, the number of entries it holds,
+ * a pointer to its buckets, as well as pointers to a hash function and key compare
+ * function.
+ *
+ * When the load factor exceeds HM_MAX_LOAD_PERCENT, the hashmap allocates a bucket
+ * array of twice the capacity and keeps the previous one in old_buckets. Every
+ * hm_set, hm_get and hm_remove then migrates HM_REHASH_STEP old buckets, starting
+ * at rehash_index, until old_buckets is empty and freed. While rehashing, new
+ * entries are always added to buckets.
+ *
+ * A hashmap created with a capacity of at most HM_SMALL_CAPACITY starts out in
+ * small mode, where is_small is set and the entries are kept in small_entries and
+ * found by scanning their cached hashes. Adding one entry more than fits moves them
+ * into twice HM_SMALL_CAPACITY buckets, and the hashmap stays hashed from then on.
+ * The inline entries share their memory with the buckets, occupancy bitmap, rehash
+ * state and pools, which only exist once the hashmap is hashed, so a large hashmap
+ * does not carry them around.
+ *
+ * Buckets are created when the first entry is added to them, so an empty hashmap
+ * costs one pointer per bucket and creating it takes a fixed number of allocations.
+ *
+ * Bit i of occupied is set if buckets[i] holds at least one entry, so iterating
+ * skips 64 empty buckets with every word it reads.
+ *
+ * Entries, bucket nodes and the buckets themselves are allocated from pools owned
+ * by the hashmap, so setting and removing keys reuses memory instead of calling
+ * malloc and free, and hm_free releases all of it at once without visiting every
+ * bucket. All memory, including the pools, comes from
+ * the allocator the hashmap was created with.
+ *
+ * If HM_STATS is enabled, stats counts the lookups and resizes of the hashmap, and
+ * otherwise stays zero.
  */
 struct HashMap
 {
     size_t capacity;
-    HashMapBucket **buckets;
+    size_t size;
+    int is_small;
     HashMapHashFunction hash_function;
     HashMapKeyCompareFunction key_compare_function;
+    const struct Allocator *allocator;
+    union
+    {
+        struct HashMapEntry small_entries[HM_SMALL_CAPACITY];
+        struct
+        {
+            HashMapBucket **buckets;
+            uint64_t *occupied;
+            size_t old_capacity;
+            HashMapBucket **old_buckets;
+            size_t rehash_index;
+            struct Pool *entry_pool;
+            struct Pool *node_pool;
+            struct Pool *bucket_pool;
+        };
+    };
+    struct HashMapStats stats;
+};
+
+/**
+ * @struct HashMapIterator
+ * @brief A cursor over the entries of a hashmap.
+ *
+ * This iterator contains a pointer to the hashmap it iterates over, the position of
+ * the next bucket to look at, or of the next inline entry in small mode, the
+ * capacity the hashmap had before it started rehashing, or its capacity if it was
+ * not rehashing, a pointer to the entry returned last, as well as an iterator over
+ * the current bucket.
+ *
+ * A hashmap that is rehashing is iterated without finishing the rehash first. Old
+ * bucket i and buckets i and i + split are walked together, and the old bucket is
+ * migrated just before, so rehash steps taken while iterating only move entries
+ * between groups the iterator is not in.
+ *
+ * The entry returned last can be removed with hm_iter_remove without invalidating
+ * the iterator, and hm_get can be called while iterating. Any other change to the
+ * hashmap while iterating invalidates the iterator.
+ */
+struct HashMapIterator
+{
+    struct HashMap *hashmap;
+    size_t next_bucket;
+    size_t split;
+    struct HashMapEntry *current;
+    struct LinkedListIterator bucket_iterator;
 };
 
 /**
  * @brief Creates a new hashmap.
- * @param capacity The capacity of the hashmap.
- * @param hash_function A function that hashes a key to an index in the hashmap.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
  * @param key_compare_function A function that compares two keys in the hashmap.
- * @return A pointer to the created hashmap.
+ * @return A pointer to the created hashmap, or NULL if the capacity has no power of
+ *         two that fits in a size_t or an allocation failed.
  */
 struct HashMap *hm_create(size_t capacity, HashMapHashFunction hash_function,
                           HashMapKeyCompareFunction key_compare_function);
+
+/**
+ * @brief Creates a new hashmap that allocates from an allocator.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created hashmap, or NULL if the capacity has no power of
+ *         two that fits in a size_t or an allocation failed.
+ */
+struct HashMap *hm_create_with_allocator(size_t capacity,
+                                         HashMapHashFunction hash_function,
+                                         HashMapKeyCompareFunction key_compare_function,
+                                         const struct Allocator *allocator);
+
 /**
  * @brief Frees a hashmap.
  * @param hashmap A pointer to the hashmap to free.
@@ -106,4 +275,202 @@ void *hm_get(struct HashMap *hashmap, void *key);
  */
 void *hm_remove(struct HashMap *hashmap, void *key);
 
+/**
+ * @brief Gets the value slot of a key in a hashmap, adding the key if it is missing.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to find.
+ * @param inserted A pointer that is set to 1 if the key was added and 0 if it was
+ *                 already in the hashmap. Pass NULL if this is not needed.
+ * @return A pointer to the value of the key, or NULL if adding the key failed.
+ *
+ * A key that is added gets a NULL value, which the caller fills in through the
+ * returned pointer. The pointer is only valid until the hashmap is next changed.
+ */
+void **hm_entry(struct HashMap *hashmap, void *key, int *inserted);
+
+/**
+ * @brief Gets the value of a key in a hashmap, setting it if the key is missing.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to get.
+ * @param value A pointer to the value to set if the key is missing.
+ * @return A pointer to the value the key has afterwards, or NULL if adding the key
+ *         failed.
+ */
+void *hm_get_or_insert(struct HashMap *hashmap, void *key, void *value);
+
+/**
+ * @brief Sets a key-value pair in a hashmap and hands back the value it replaced.
+ * @param hashmap A pointer to the hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @param old_value A pointer that is set to the replaced value, or to NULL if the
+ *                  key was added. Pass NULL if this is not needed.
+ * @return 1 if an existing value was replaced, 0 if the key was added, or -1 if
+ *         adding the key failed.
+ */
+int hm_upsert(struct HashMap *hashmap, void *key, void *value, void **old_value);
+
+/**
+ * @brief Gets the number of entries in a hashmap.
+ * @param hashmap A pointer to the hashmap.
+ * @return The number of entries.
+ */
+size_t hm_size(struct HashMap *hashmap);
+
+/**
+ * @brief Writes the statistics of a hashmap to a stream as a single line of JSON.
+ * @param hashmap A pointer to the hashmap to describe.
+ * @param stream The stream to write to.
+ * @return 0 if the statistics were written successfully, -1 otherwise.
+ */
+int hm_stats(struct HashMap *hashmap, FILE *stream);
+
+/**
+ * @brief Sets many key-value pairs in a hashmap.
+ * @param hashmap A pointer to the hashmap to set in.
+ * @param keys An array of pointers to the keys to set.
+ * @param values An array of pointers to the values to set, one for each key.
+ * @param count The number of key-value pairs to set.
+ * @return 0 if every key-value pair was set successfully, -1 otherwise.
+ */
+int hm_set_many(struct HashMap *hashmap, void **keys, void **values, size_t count);
+
+/**
+ * @brief Gets many values from a hashmap.
+ * @param hashmap A pointer to the hashmap to get from.
+ * @param keys An array of pointers to the keys to get.
+ * @param count The number of keys to get.
+ * @param values An array to store the value of each key in, or NULL for keys that
+ *               are not in the hashmap.
+ * @return void
+ */
+void hm_get_many(struct HashMap *hashmap, void **keys, size_t count, void **values);
+
+/**
+ * @brief Removes many key-value pairs from a hashmap.
+ * @param hashmap A pointer to the hashmap to remove from.
+ * @param keys An array of pointers to the keys to remove.
+ * @param count The number of keys to remove.
+ * @param values An array to store the removed value of each key in, or NULL for keys
+ *               that are not in the hashmap. Pass NULL if the values are not needed.
+ * @return The number of key-value pairs that were removed.
+ */
+size_t hm_remove_many(struct HashMap *hashmap, void **keys, size_t count,
+                      void **values);
+
+/**
+ * @brief Starts iterating over a hashmap.
+ * @param hashmap A pointer to the hashmap to iterate over.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return void
+ */
+void hm_iter_begin(struct HashMap *hashmap, struct HashMapIterator *iterator);
+
+/**
+ * @brief Advances an iterator to the next entry of its hashmap.
+ * @param iterator A pointer to the iterator to advance.
+ * @return A pointer to the next entry, or NULL if every entry has been returned.
+ */
+struct HashMapEntry *hm_iter_next(struct HashMapIterator *iterator);
+
+/**
+ * @brief Removes the entry last returned by an iterator from its hashmap.
+ * @param iterator A pointer to the iterator.
+ * @return A pointer to the value of the removed entry, or NULL if there is no entry
+ *         to remove.
+ */
+void *hm_iter_remove(struct HashMapIterator *iterator);
+
+/**
+ * @brief Sets the seed used by the built-in hash functions.
+ * @param seed The new seed.
+ * @return void
+ *
+ * The seed should be set once from a random source at startup, before any hashmap
+ * using the built-in hash functions is created, so that an attacker cannot choose
+ * keys that all collide. Entries cache their hashes, so changing the seed while
+ * such a hashmap holds entries makes those entries unreachable.
+ */
+void hm_set_hash_seed(uint64_t seed);
+
+/**
+ * @brief Hashes a sequence of bytes with a given seed.
+ * @param data A pointer to the bytes to hash.
+ * @param length The number of bytes to hash.
+ * @param seed The seed to hash with.
+ * @return The 64-bit hash of the bytes.
+ *
+ * This is a wyhash style hash that consumes 16 or 48 bytes per round using 64-bit
+ * multiplications, which makes it fast on both short and long keys.
+ */
+uint64_t hm_hash_bytes(const void *data, size_t length, uint64_t seed);
+
+/**
+ * @brief Hashes a 64-bit integer with a given seed.
+ * @param value The integer to hash.
+ * @param seed The seed to hash with.
+ * @return The 64-bit hash of the integer, with every bit of the input mixed in.
+ */
+uint64_t hm_hash_integer(uint64_t value, uint64_t seed);
+
+/**
+ * @brief A hash function for keys that are NUL terminated strings.
+ * @param key A pointer to the first character of the string.
+ * @return The 64-bit hash of the string, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_string(void *key);
+
+/**
+ * @brief A hash function for keys that are pointers to an int.
+ * @param key A pointer to the int.
+ * @return The 64-bit hash of the int, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_int(void *key);
+
+/**
+ * @brief A hash function for keys that are pointers to a uint64_t.
+ * @param key A pointer to the uint64_t.
+ * @return The 64-bit hash of the integer, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_uint64(void *key);
+
+/**
+ * @brief A hash function for keys that are compared by their address.
+ * @param key The key.
+ * @return The 64-bit hash of the address, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_pointer(void *key);
+
+/**
+ * @brief A key compare function for keys that are NUL terminated strings.
+ * @param key1 The first string to compare.
+ * @param key2 The second string to compare.
+ * @return 0 if the strings are equal, else a non-zero value.
+ */
+int hm_compare_string(void *key1, void *key2);
+
+/**
+ * @brief A key compare function for keys that are pointers to an int.
+ * @param key1 A pointer to the first int to compare.
+ * @param key2 A pointer to the second int to compare.
+ * @return 0 if the ints are equal, else a non-zero value.
+ */
+int hm_compare_int(void *key1, void *key2);
+
+/**
+ * @brief A key compare function for keys that are pointers to a uint64_t.
+ * @param key1 A pointer to the first integer to compare.
+ * @param key2 A pointer to the second integer to compare.
+ * @return 0 if the integers are equal, else a non-zero value.
+ */
+int hm_compare_uint64(void *key1, void *key2);
+
+/**
+ * @brief A key compare function for keys that are compared by their address.
+ * @param key1 The first key to compare.
+ * @param key2 The second key to compare.
+ * @return 0 if the keys are the same pointer, else a non-zero value.
+ */
+int hm_compare_pointer(void *key1, void *key2);
+
 #endif
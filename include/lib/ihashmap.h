@@ -0,0 +1,146 @@
+/**
+ * @brief An intrusive hashmap whose links are embedded in its elements.
+ */
+
+#ifndef __IHASHMAP_H
+#define __IHASHMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/hashmap.h"
+#include "lib/ilist.h"
+
+/**
+ * @struct IntrusiveHashMapNode
+ * @brief The links of an element in an intrusive hashmap.
+ *
+ * This node contains a pointer to the next node in the same bucket, as well as the
+ * full hash of the key of the element. It is embedded in the element itself, and
+ * container_of gets the element back from it.
+ */
+struct IntrusiveHashMapNode
+{
+    struct IntrusiveHashMapNode *next;
+    uint64_t hash;
+};
+
+/**
+ * @brief A function that compares the key of an element to a generic key.
+ * @param node A pointer to the node embedded in the element.
+ * @param key A pointer to the key to compare with.
+ * @return 0 if the keys are equal, else a non-zero value.
+ */
+typedef int (*IntrusiveHashMapKeyCompareFunction)(struct IntrusiveHashMapNode *,
+                                                  void *);
+
+/**
+ * @brief A function that frees an element of an intrusive hashmap.
+ * @param node A pointer to the node embedded in the element to free.
+ * @return void
+ */
+typedef void (*IntrusiveHashMapNodeFreeFunction)(struct IntrusiveHashMapNode *);
+
+/**
+ * @struct IntrusiveHashMap
+ * @brief An intrusive hashmap.
+ *
+ * This intrusive hashmap contains a capacity, a size, an array of buckets, a
+ * pointer to a function that hashes keys, a pointer to a function that compares the
+ * key of an element to a key, as well as a pointer to the allocator it was
+ * allocated from.
+ *
+ * Each bucket is a singly linked chain threaded through the nodes of its elements,
+ * so inserting and removing never allocate. Only the bucket array is allocated,
+ * when the hashmap is created or grows past HM_MAX_LOAD_PERCENT. Growing relinks
+ * nodes using their cached hash, and leaves the hashmap as it was if the
+ * allocation fails.
+ */
+struct IntrusiveHashMap
+{
+    size_t capacity;
+    size_t size;
+    struct IntrusiveHashMapNode **buckets;
+    HashMapHashFunction hash_function;
+    IntrusiveHashMapKeyCompareFunction key_compare_function;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new intrusive hashmap.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares the key of an element to a
+ *                             key.
+ * @return A pointer to the created intrusive hashmap.
+ */
+struct IntrusiveHashMap *
+ihm_create(size_t capacity, HashMapHashFunction hash_function,
+           IntrusiveHashMapKeyCompareFunction key_compare_function);
+
+/**
+ * @brief Creates a new intrusive hashmap that allocates from an allocator.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares the key of an element to a
+ *                             key.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created intrusive hashmap.
+ */
+struct IntrusiveHashMap *
+ihm_create_with_allocator(size_t capacity, HashMapHashFunction hash_function,
+                          IntrusiveHashMapKeyCompareFunction key_compare_function,
+                          const struct Allocator *allocator);
+
+/**
+ * @brief Frees an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to free.
+ * @param node_free_function A function that frees an element of the hashmap. Pass
+ *                           NULL if the elements do not need to be freed.
+ * @return void
+ */
+void ihm_free(struct IntrusiveHashMap *intrusive_hashmap,
+              IntrusiveHashMapNodeFreeFunction node_free_function);
+
+/**
+ * @brief Sets the element of a key in an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to set in.
+ * @param key A pointer to the key of the element.
+ * @param node A pointer to the node embedded in the element.
+ * @return A pointer to the node of the element that was replaced, or NULL if the key
+ *         was not in the hashmap.
+ */
+struct IntrusiveHashMapNode *ihm_set(struct IntrusiveHashMap *intrusive_hashmap,
+                                     void *key, struct IntrusiveHashMapNode *node);
+
+/**
+ * @brief Gets the element of a key from an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the node of the element, or NULL if the key is not in the
+ *         hashmap.
+ */
+struct IntrusiveHashMapNode *ihm_get(struct IntrusiveHashMap *intrusive_hashmap,
+                                     void *key);
+
+/**
+ * @brief Removes the element of a key from an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the node of the removed element, or NULL if the key is not in
+ *         the hashmap.
+ */
+struct IntrusiveHashMapNode *ihm_remove(struct IntrusiveHashMap *intrusive_hashmap,
+                                        void *key);
+
+/**
+ * @brief Removes an element from an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to remove from.
+ * @param node A pointer to the node embedded in the element.
+ * @return 0 if the element was removed successfully, -1 otherwise.
+ */
+int ihm_remove_node(struct IntrusiveHashMap *intrusive_hashmap,
+                    struct IntrusiveHashMapNode *node);
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @brief An intrusive doubly linked list whose links are embedded in its elements.
+ */
+
+#ifndef __ILIST_H
+#define __ILIST_H
+
+#include <stddef.h>
+
+/**
+ * @brief Gets a pointer to the struct that a member is embedded in.
+ * @param pointer A pointer to the member.
+ * @param type The type of the struct the member is embedded in.
+ * @param member The name of the member in the struct.
+ * @return A pointer to the struct.
+ */
+#ifndef container_of
+#define container_of(pointer, type, member)                                            \
+    ((type *)((char *)(pointer) - offsetof(type, member)))
+#endif
+
+/**
+ * @struct IntrusiveListNode
+ * @brief The links of an element in an intrusive list.
+ *
+ * This node contains pointers to the previous and next nodes in the list. It is
+ * embedded in the element itself, and container_of gets the element back from it.
+ * An element can be in as many lists at once as it has nodes.
+ */
+struct IntrusiveListNode
+{
+    struct IntrusiveListNode *prev;
+    struct IntrusiveListNode *next;
+};
+
+/**
+ * @struct IntrusiveList
+ * @brief An intrusive doubly linked list.
+ *
+ * This intrusive list contains a size, as well as pointers to it's head and tail
+ * nodes.
+ *
+ * The list never allocates. It does not own its elements either, so it can be
+ * embedded in another struct or live on the stack, and is initialized with il_init.
+ */
+struct IntrusiveList
+{
+    size_t size;
+    struct IntrusiveListNode *head;
+    struct IntrusiveListNode *tail;
+};
+
+/**
+ * @brief Initializes an empty intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to initialize.
+ * @return void
+ */
+void il_init(struct IntrusiveList *intrusive_list);
+
+/**
+ * @brief Pushes a node onto the tail of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to push onto.
+ * @param node A pointer to the node to push.
+ * @return void
+ */
+void il_push(struct IntrusiveList *intrusive_list, struct IntrusiveListNode *node);
+
+/**
+ * @brief Pushes a node onto the head of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to push onto.
+ * @param node A pointer to the node to push.
+ * @return void
+ */
+void il_push_front(struct IntrusiveList *intrusive_list,
+                   struct IntrusiveListNode *node);
+
+/**
+ * @brief Pops a node from the tail of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to pop from.
+ * @return A pointer to the popped node, or NULL if the list is empty.
+ */
+struct IntrusiveListNode *il_pop(struct IntrusiveList *intrusive_list);
+
+/**
+ * @brief Pops a node from the head of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to pop from.
+ * @return A pointer to the popped node, or NULL if the list is empty.
+ */
+struct IntrusiveListNode *il_pop_front(struct IntrusiveList *intrusive_list);
+
+/**
+ * @brief Inserts a node before another node in an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to insert into.
+ * @param node A pointer to the node to insert before.
+ * @param new_node A pointer to the node to insert.
+ * @return void
+ */
+void il_insert_before(struct IntrusiveList *intrusive_list,
+                      struct IntrusiveListNode *node,
+                      struct IntrusiveListNode *new_node);
+
+/**
+ * @brief Inserts a node after another node in an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to insert into.
+ * @param node A pointer to the node to insert after.
+ * @param new_node A pointer to the node to insert.
+ * @return void
+ */
+void il_insert_after(struct IntrusiveList *intrusive_list,
+                     struct IntrusiveListNode *node,
+                     struct IntrusiveListNode *new_node);
+
+/**
+ * @brief Removes a node from an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to remove from.
+ * @param node A pointer to the node to remove.
+ * @return void
+ */
+void il_remove(struct IntrusiveList *intrusive_list, struct IntrusiveListNode *node);
+
+#endif
@@ -7,6 +7,9 @@
 
 #include <stddef.h>
 
+#include "lib/allocator.h"
+#include "lib/pool.h"
+
 /**
  * @brief A function that frees a generic value.
  * @param param1 The value to free.
@@ -19,6 +22,9 @@ typedef void (*ValueFreeFunction)(void *);
  * @param param1 The first value to compare.
  * @param param2 The second value to compare.
  * @return 0 if the values are equal, else a non-zero value.
+ *
+ * Ordered containers, such as the skip list, also need the sign of the result to
+ * order the values the way strcmp orders strings.
  */
 typedef int (*ValueCompareFunction)(void *, void *);
 
@@ -39,8 +45,11 @@ struct LinkedListNode
  * @brief A linked list.
  *
  * This linked list contains a size, a pointer to it's head and tail nodes,
- * as well as a pointer to a function compares values contained
- * in the list.
+ * a pointer to a function compares values contained in the list,
+ * a pointer to the pool its nodes are allocated from,
+ * as well as a pointer to the allocator it was allocated from.
+ *
+ * If node_pool is NULL, nodes are allocated from the allocator.
  */
 struct LinkedList
 {
@@ -48,6 +57,27 @@ struct LinkedList
     struct LinkedListNode *head;
     struct LinkedListNode *tail;
     ValueCompareFunction value_compare_function;
+    struct Pool *node_pool;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @struct LinkedListIterator
+ * @brief A cursor over the nodes of a linked list.
+ *
+ * This iterator contains a pointer to the linked list it iterates over, as well as
+ * pointers to the node returned last, the node before it and the node after it.
+ *
+ * Iterators live wherever the caller declares them, so iterating never allocates.
+ * The node returned last can be removed with ll_iter_remove without invalidating
+ * the iterator. Any other change to the list while iterating does.
+ */
+struct LinkedListIterator
+{
+    struct LinkedList *linked_list;
+    struct LinkedListNode *previous;
+    struct LinkedListNode *current;
+    struct LinkedListNode *next;
 };
 
 /**
@@ -57,6 +87,27 @@ struct LinkedList
  */
 struct LinkedList *ll_create(ValueCompareFunction value_compare_function);
 
+/**
+ * @brief Creates a new linked list that allocates from an allocator.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created linked list.
+ */
+struct LinkedList *ll_create_with_allocator(ValueCompareFunction value_compare_function,
+                                            const struct Allocator *allocator);
+
+/**
+ * @brief Creates a new linked list that allocates its nodes from a pool.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param node_pool A pointer to a pool of objects of sizeof(struct LinkedListNode)
+ *                  bytes. The pool may be shared by many lists and must outlive them.
+ * @return A pointer to the created linked list.
+ *
+ * The list itself is allocated from the allocator of the pool.
+ */
+struct LinkedList *ll_create_with_pool(ValueCompareFunction value_compare_function,
+                                       struct Pool *node_pool);
+
 /**
  * @brief Frees a linked list.
  * @param linked_list A pointer to the linked list to free.
@@ -97,6 +148,35 @@ int ll_push(struct LinkedList *linked_list, void *value);
  */
 void *ll_pop(struct LinkedList *linked_list);
 
+/**
+ * @brief Pushes a value onto the head of a linked list.
+ * @param linked_list A pointer to the linked list to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int ll_push_front(struct LinkedList *linked_list, void *value);
+
+/**
+ * @brief Pops a value from the head of a linked list.
+ * @param linked_list A pointer to the linked list to pop from.
+ * @return A pointer to the popped value, or NULL if the list is empty.
+ */
+void *ll_pop_front(struct LinkedList *linked_list);
+
+/**
+ * @brief Gets the value at the head of a linked list without removing it.
+ * @param linked_list A pointer to the linked list to peek at.
+ * @return A pointer to the value, or NULL if the list is empty.
+ */
+void *ll_peek_front(struct LinkedList *linked_list);
+
+/**
+ * @brief Gets the value at the tail of a linked list without removing it.
+ * @param linked_list A pointer to the linked list to peek at.
+ * @return A pointer to the value, or NULL if the list is empty.
+ */
+void *ll_peek_back(struct LinkedList *linked_list);
+
 /**
  * @brief Inserts a value before a node in a linked list.
  * @param linked_list A pointer to the linked list to insert into.
@@ -151,4 +231,27 @@ int ll_remove_node(struct LinkedList *linked_list, struct LinkedListNode *node);
  */
 int ll_remove_value(struct LinkedList *linked_list, void *value);
 
+/**
+ * @brief Starts iterating over a linked list.
+ * @param linked_list A pointer to the linked list to iterate over.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return void
+ */
+void ll_iter_begin(struct LinkedList *linked_list, struct LinkedListIterator *iterator);
+
+/**
+ * @brief Advances an iterator to the next node of its linked list.
+ * @param iterator A pointer to the iterator to advance.
+ * @return A pointer to the next node, or NULL if every node has been returned.
+ */
+struct LinkedListNode *ll_iter_next(struct LinkedListIterator *iterator);
+
+/**
+ * @brief Removes the node last returned by an iterator from its linked list.
+ * @param iterator A pointer to the iterator.
+ * @return A pointer to the value of the removed node, or NULL if there is no node to
+ *         remove.
+ */
+void *ll_iter_remove(struct LinkedListIterator *iterator);
+
 #endif
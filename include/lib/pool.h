@@ -0,0 +1,111 @@
+/**
+ * @brief A fixed size object pool that carves objects out of large slabs.
+ */
+
+#ifndef __POOL_H
+#define __POOL_H
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+
+/**
+ * @brief The alignment of every object handed out by a pool.
+ */
+#define POOL_ALIGNMENT 8
+
+/**
+ * @brief The number of objects in the first slab of a pool.
+ *
+ * Every following slab holds twice as many objects as the previous one, up to the
+ * maximum the pool was created with, so that small pools stay small.
+ */
+#define POOL_MIN_SLAB_OBJECTS 8
+
+/**
+ * @struct PoolSlab
+ * @brief A block of memory that objects are carved out of.
+ *
+ * This slab contains a pointer to the next slab of the pool, as well as the size
+ * of the allocation it lives in. The objects follow the slab header in the same
+ * allocation.
+ */
+struct PoolSlab
+{
+    struct PoolSlab *next;
+    size_t size;
+};
+
+/**
+ * @struct Pool
+ * @brief A pool of fixed size objects.
+ *
+ * This pool contains the size of its objects, the maximum number of objects in a
+ * slab, the number of objects in the newest slab, a pointer to its slabs, a list of
+ * released objects, the unused range at the end of the newest slab, as well as a
+ * pointer to the allocator its slabs are allocated from.
+ *
+ * Released objects are threaded through their own memory into free_list, and are
+ * handed out again before any new memory is used. Objects are never returned to
+ * the system individually. All slabs are released at once by pool_free.
+ */
+struct Pool
+{
+    size_t object_size;
+    size_t max_objects_per_slab;
+    size_t slab_objects;
+    struct PoolSlab *slabs;
+    void *free_list;
+    char *slab_cursor;
+    char *slab_end;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new pool.
+ * @param object_size The size of the objects in the pool.
+ * @param max_objects_per_slab The maximum number of objects allocated at once.
+ * @return A pointer to the created pool.
+ */
+struct Pool *pool_create(size_t object_size, size_t max_objects_per_slab);
+
+/**
+ * @brief Creates a new pool that allocates its slabs from an allocator.
+ * @param object_size The size of the objects in the pool.
+ * @param max_objects_per_slab The maximum number of objects allocated at once.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created pool.
+ */
+struct Pool *pool_create_with_allocator(size_t object_size, size_t max_objects_per_slab,
+                                        const struct Allocator *allocator);
+
+/**
+ * @brief Frees a pool and every object allocated from it.
+ * @param pool A pointer to the pool to free.
+ * @return void
+ */
+void pool_free(struct Pool *pool);
+
+/**
+ * @brief Allocates an object from a pool.
+ * @param pool A pointer to the pool to allocate from.
+ * @return A pointer to the allocated object, or NULL if the allocation failed.
+ */
+void *pool_alloc(struct Pool *pool);
+
+/**
+ * @brief Returns an object to a pool so that it can be allocated again.
+ * @param pool A pointer to the pool the object was allocated from.
+ * @param object A pointer to the object to return.
+ * @return void
+ */
+void pool_release(struct Pool *pool, void *object);
+
+/**
+ * @brief Gets the number of bytes a pool has allocated.
+ * @param pool A pointer to the pool.
+ * @return The size of the pool and all of its slabs, in bytes.
+ */
+size_t pool_bytes(struct Pool *pool);
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @brief Bounded lock-free queues for handing values from one thread to another.
+ */
+
+#ifndef __QUEUE_H
+#define __QUEUE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "lib/allocator.h"
+
+/**
+ * @brief The size of a cache line, which producer and consumer state are kept apart by.
+ */
+#define QUEUE_CACHE_LINE_SIZE 64
+
+/**
+ * @brief The smallest capacity of a multi-producer single-consumer queue.
+ *
+ * With a single cell, the sequence a producer waits for after a full lap equals the
+ * one the cell is published with, so a second push would overwrite a value the
+ * consumer has not popped yet.
+ */
+#define MPSC_MIN_CAPACITY 2
+
+/**
+ * @struct SpscRing
+ * @brief A bounded single-producer single-consumer ring buffer.
+ *
+ * This ring contains a power of two capacity, a pointer to its slots, a pointer to
+ * the allocator it was allocated from, the index the consumer pops from next along
+ * with its last seen tail, as well as the index the producer pushes to next along
+ * with its last seen head.
+ *
+ * Each index is only written by one thread, and is published with a release store.
+ * Both threads keep a cached copy of the other index and only reload it when the
+ * ring looks full or empty, so that they rarely touch each other's cache line.
+ */
+struct SpscRing
+{
+    size_t capacity;
+    void **slots;
+    const struct Allocator *allocator;
+    char padding1[QUEUE_CACHE_LINE_SIZE];
+    atomic_size_t head;
+    size_t cached_tail;
+    char padding2[QUEUE_CACHE_LINE_SIZE];
+    atomic_size_t tail;
+    size_t cached_head;
+    char padding3[QUEUE_CACHE_LINE_SIZE];
+};
+
+/**
+ * @struct MpscQueueCell
+ * @brief A slot in a multi-producer single-consumer queue.
+ *
+ * This cell contains a sequence number that tells whose turn it is to use the cell,
+ * as well as the value stored in it.
+ */
+struct MpscQueueCell
+{
+    atomic_size_t sequence;
+    void *value;
+};
+
+/**
+ * @struct MpscQueue
+ * @brief A bounded multi-producer single-consumer queue.
+ *
+ * This queue contains a power of two capacity, a pointer to its cells, a pointer to
+ * the allocator it was allocated from, the position the consumer pops from next, as
+ * well as the position producers claim next.
+ *
+ * Producers claim a position with a compare and swap on tail, then fill the cell
+ * and publish it by setting its sequence to the position plus one. The consumer
+ * owns head alone, and frees the cell for the producer one lap later by setting its
+ * sequence to the position plus the capacity. Neither side ever blocks the other,
+ * and the cells are allocated once, when the queue is created.
+ */
+struct MpscQueue
+{
+    size_t capacity;
+    struct MpscQueueCell *cells;
+    const struct Allocator *allocator;
+    char padding1[QUEUE_CACHE_LINE_SIZE];
+    atomic_size_t head;
+    char padding2[QUEUE_CACHE_LINE_SIZE];
+    atomic_size_t tail;
+    char padding3[QUEUE_CACHE_LINE_SIZE];
+};
+
+/**
+ * @brief Creates a new single-producer single-consumer ring.
+ * @param capacity The number of values the ring holds, rounded up to a power of two.
+ * @return A pointer to the created ring.
+ */
+struct SpscRing *spsc_create(size_t capacity);
+
+/**
+ * @brief Creates a new single-producer single-consumer ring that allocates from an
+ *        allocator.
+ * @param capacity The number of values the ring holds, rounded up to a power of two.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created ring.
+ */
+struct SpscRing *spsc_create_with_allocator(size_t capacity,
+                                            const struct Allocator *allocator);
+
+/**
+ * @brief Frees a single-producer single-consumer ring.
+ * @param ring A pointer to the ring to free.
+ * @return void
+ */
+void spsc_free(struct SpscRing *ring);
+
+/**
+ * @brief Pushes a value onto a single-producer single-consumer ring.
+ * @param ring A pointer to the ring to push onto. Only one thread may push.
+ * @param value The value to push, which may not be NULL.
+ * @return 0 if the value was pushed, -1 if the ring is full.
+ */
+int spsc_push(struct SpscRing *ring, void *value);
+
+/**
+ * @brief Pops the oldest value from a single-producer single-consumer ring.
+ * @param ring A pointer to the ring to pop from. Only one thread may pop.
+ * @return The popped value, or NULL if the ring is empty.
+ */
+void *spsc_pop(struct SpscRing *ring);
+
+/**
+ * @brief Creates a new multi-producer single-consumer queue.
+ * @param capacity The number of values the queue holds, rounded up to a power of two
+ *                 and to at least MPSC_MIN_CAPACITY.
+ * @return A pointer to the created queue.
+ */
+struct MpscQueue *mpsc_create(size_t capacity);
+
+/**
+ * @brief Creates a new multi-producer single-consumer queue that allocates from an
+ *        allocator.
+ * @param capacity The number of values the queue holds, rounded up to a power of two
+ *                 and to at least MPSC_MIN_CAPACITY.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created queue.
+ */
+struct MpscQueue *mpsc_create_with_allocator(size_t capacity,
+                                             const struct Allocator *allocator);
+
+/**
+ * @brief Frees a multi-producer single-consumer queue.
+ * @param queue A pointer to the queue to free.
+ * @return void
+ */
+void mpsc_free(struct MpscQueue *queue);
+
+/**
+ * @brief Pushes a value onto a multi-producer single-consumer queue.
+ * @param queue A pointer to the queue to push onto. Any number of threads may push.
+ * @param value The value to push, which may not be NULL.
+ * @return 0 if the value was pushed, -1 if the queue is full.
+ */
+int mpsc_push(struct MpscQueue *queue, void *value);
+
+/**
+ * @brief Pops the oldest value from a multi-producer single-consumer queue.
+ * @param queue A pointer to the queue to pop from. Only one thread may pop.
+ * @return The popped value, or NULL if the queue is empty.
+ *
+ * A value whose producer has claimed its cell but not yet filled it counts as not
+ * pushed yet, so the queue may look empty for a moment while a push is underway.
+ */
+void *mpsc_pop(struct MpscQueue *queue);
+
+#endif
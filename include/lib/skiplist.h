@@ -0,0 +1,180 @@
+/**
+ * @brief A lock-free ordered set of generic values, kept in a skip list.
+ */
+
+#ifndef __SKIPLIST_H
+#define __SKIPLIST_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/epoch.h"
+#include "lib/list.h"
+
+/**
+ * @brief The maximum number of levels of a skip list.
+ *
+ * Every node is on the lowest level, and a node on one level is also on the next
+ * one up with a probability of one half, so this many levels keep searches
+ * logarithmic for far more values than fit in memory.
+ */
+#define SL_MAX_HEIGHT 24
+
+/**
+ * @struct SkipListNode
+ * @brief A node in a skip list.
+ *
+ * This node contains a generic value, the number of levels it is on, the number
+ * of threads that still have to let go of it before it can be retired, its
+ * reclamation state once it is retired, as well as a pointer to the next node on
+ * each of its levels.
+ *
+ * The lowest bit of next[i] is set once the node is being removed, which freezes
+ * the pointer, so that no node can be linked after it on that level any more. The
+ * node is removed from the set once the bit is set on next[0].
+ */
+struct SkipListNode
+{
+    void *value;
+    int height;
+    atomic_int references;
+    struct EpochNode epoch_node;
+    _Atomic(uintptr_t) next[];
+};
+
+/**
+ * @struct SkipList
+ * @brief An ordered set of generic values that can be shared by many threads.
+ *
+ * This skip list contains a pointer to its head node, the number of values in it,
+ * a pointer to a function that orders values, as well as a pointer to the
+ * allocator it was allocated from.
+ *
+ * No operation takes a lock. A value is added by linking its node into the lowest
+ * level with a compare-and-swap, which is when it joins the set, and then into the
+ * levels above it one at a time. A value is removed by marking the next pointers
+ * of its node from the top down, which is when it leaves the set once next[0] is
+ * marked. Any thread that walks past a marked node unlinks it, and nodes are
+ * retired through epoch_retire once both the thread adding them and the thread
+ * removing them are done with them, so readers never see freed memory.
+ *
+ * The value compare function has to order values the way strcmp orders strings.
+ * Values that compare equal are only added once, and values may not be NULL.
+ *
+ * The allocator the skip list was created with has to be safe to call from every
+ * thread that uses the skip list.
+ */
+struct SkipList
+{
+    struct SkipListNode *head;
+    atomic_size_t size;
+    ValueCompareFunction value_compare_function;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @struct SkipListIterator
+ * @brief A cursor over the values of a skip list in ascending order.
+ *
+ * This iterator contains a pointer to the skip list it iterates over, as well as a
+ * pointer to the node it looks at next.
+ *
+ * The iterating thread stays inside an epoch critical section from sl_iter_begin to
+ * sl_iter_end. Other threads may add and remove values meanwhile. A value that is
+ * in the skip list for the whole iteration is returned exactly once.
+ */
+struct SkipListIterator
+{
+    struct SkipList *skip_list;
+    struct SkipListNode *next;
+};
+
+/**
+ * @brief Creates a new skip list.
+ * @param value_compare_function A function that orders two values.
+ * @return A pointer to the created skip list.
+ */
+struct SkipList *sl_create(ValueCompareFunction value_compare_function);
+
+/**
+ * @brief Creates a new skip list that allocates from an allocator.
+ * @param value_compare_function A function that orders two values.
+ * @param allocator A pointer to a thread safe allocator to allocate from, or NULL
+ *                  for malloc.
+ * @return A pointer to the created skip list.
+ */
+struct SkipList *sl_create_with_allocator(ValueCompareFunction value_compare_function,
+                                          const struct Allocator *allocator);
+
+/**
+ * @brief Frees a skip list.
+ * @param skip_list A pointer to the skip list to free. No other thread may be using
+ *                  it, and the calling thread may not be inside an epoch critical
+ *                  section.
+ * @param value_free_function A function that frees a value in the skip list. Pass
+ *                            NULL if the values do not need to be freed.
+ * @return void
+ */
+void sl_free(struct SkipList *skip_list, ValueFreeFunction value_free_function);
+
+/**
+ * @brief Adds a value to a skip list.
+ * @param skip_list A pointer to the skip list to add to.
+ * @param value A pointer to the value to add.
+ * @return 0 if the value was added, 1 if an equal value is already in the skip
+ *         list, or -1 if an allocation failed.
+ */
+int sl_insert(struct SkipList *skip_list, void *value);
+
+/**
+ * @brief Gets the value of a skip list that is equal to a value.
+ * @param skip_list A pointer to the skip list to search.
+ * @param value A pointer to the value to search for.
+ * @return A pointer to the value in the skip list, or NULL if there is none.
+ */
+void *sl_get(struct SkipList *skip_list, void *value);
+
+/**
+ * @brief Removes the value of a skip list that is equal to a value.
+ * @param skip_list A pointer to the skip list to remove from.
+ * @param value A pointer to the value to remove.
+ * @return A pointer to the removed value, or NULL if there is none.
+ */
+void *sl_remove(struct SkipList *skip_list, void *value);
+
+/**
+ * @brief Gets the number of values in a skip list.
+ * @param skip_list A pointer to the skip list.
+ * @return The number of values, which other threads may change at any time.
+ */
+size_t sl_size(struct SkipList *skip_list);
+
+/**
+ * @brief Starts iterating over the values of a skip list from a given value.
+ * @param skip_list A pointer to the skip list to iterate over.
+ * @param from The smallest value to return. Pass NULL to iterate over every value.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return 0 if the iterator was initialized, -1 if the calling thread could not
+ *         enter an epoch critical section, in which case sl_iter_end must not be
+ *         called.
+ */
+int sl_iter_begin(struct SkipList *skip_list, void *from,
+                  struct SkipListIterator *iterator);
+
+/**
+ * @brief Advances an iterator to the next value of a skip list.
+ * @param iterator A pointer to the iterator to advance.
+ * @return A pointer to the next value, or NULL if every value has been returned.
+ */
+void *sl_iter_next(struct SkipListIterator *iterator);
+
+/**
+ * @brief Stops iterating over a skip list.
+ * @param iterator A pointer to the iterator to stop.
+ * @return void
+ */
+void sl_iter_end(struct SkipListIterator *iterator);
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @brief A generic growable vector that stores its elements contiguously.
+ */
+
+#ifndef __VEC_H
+#define __VEC_H
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+#include "lib/list.h"
+
+/**
+ * @brief The capacity a vector grows to when its first element is added.
+ */
+#define VEC_MIN_CAPACITY 8
+
+/**
+ * @brief A function that orders two elements of a vector, as used by qsort.
+ * @param element1 A pointer to the first element to compare.
+ * @param element2 A pointer to the second element to compare.
+ * @return A negative value if the first element comes first, a positive value if the
+ *         second element comes first, or 0 if they are equal.
+ */
+typedef int (*VectorOrderFunction)(const void *, const void *);
+
+/**
+ * @struct Vector
+ * @brief A growable vector.
+ *
+ * This vector contains the size of its elements, the number of elements in it, the
+ * number of elements it has room for, a pointer to its elements, as well as a
+ * pointer to the allocator it was allocated from.
+ *
+ * Elements are copied into the vector and stored back to back, so iterating over
+ * them walks memory sequentially. The capacity doubles whenever the vector is full,
+ * so pushing takes amortized constant time. Growing may move the elements, so
+ * pointers into the vector are only valid until the next push, append or reserve.
+ */
+struct Vector
+{
+    size_t element_size;
+    size_t size;
+    size_t capacity;
+    void *data;
+    const struct Allocator *allocator;
+};
+
+/**
+ * @brief Creates a new vector.
+ * @param element_size The size of the elements in the vector, which may not be 0.
+ * @return A pointer to the created vector, or NULL if element_size is 0 or the
+ *         allocation failed.
+ */
+struct Vector *vec_create(size_t element_size);
+
+/**
+ * @brief Creates a new vector that allocates from an allocator.
+ * @param element_size The size of the elements in the vector, which may not be 0.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created vector, or NULL if element_size is 0 or the
+ *         allocation failed.
+ */
+struct Vector *vec_create_with_allocator(size_t element_size,
+                                         const struct Allocator *allocator);
+
+/**
+ * @brief Frees a vector.
+ * @param vector A pointer to the vector to free.
+ * @param value_free_function A function that is passed a pointer to each element
+ *                            to free what it owns. Pass NULL if the elements do not
+ *                            need to be freed.
+ * @return void
+ */
+void vec_free(struct Vector *vector, ValueFreeFunction value_free_function);
+
+/**
+ * @brief Makes sure a vector has room for a number of elements.
+ * @param vector A pointer to the vector to reserve in.
+ * @param capacity The number of elements to make room for.
+ * @return 0 if the vector has room for the elements, -1 otherwise.
+ */
+int vec_reserve(struct Vector *vector, size_t capacity);
+
+/**
+ * @brief Gets an element of a vector.
+ * @param vector A pointer to the vector to get from.
+ * @param index The index of the element to get.
+ * @return A pointer to the element, or NULL if the index is out of bounds.
+ */
+void *vec_get(struct Vector *vector, size_t index);
+
+/**
+ * @brief Pushes a copy of an element onto the end of a vector.
+ * @param vector A pointer to the vector to push onto.
+ * @param element A pointer to the element to copy.
+ * @return 0 if the element was pushed successfully, -1 otherwise.
+ */
+int vec_push(struct Vector *vector, const void *element);
+
+/**
+ * @brief Appends copies of an array of elements to the end of a vector.
+ * @param vector A pointer to the vector to append to.
+ * @param elements A pointer to the first element to copy.
+ * @param count The number of elements to copy.
+ * @return 0 if the elements were appended successfully, -1 otherwise.
+ */
+int vec_append(struct Vector *vector, const void *elements, size_t count);
+
+/**
+ * @brief Pops the last element of a vector.
+ * @param vector A pointer to the vector to pop from.
+ * @param element A pointer to copy the popped element to, or NULL to discard it.
+ * @return 0 if an element was popped, -1 if the vector is empty.
+ */
+int vec_pop(struct Vector *vector, void *element);
+
+/**
+ * @brief Removes an element from a vector, keeping the order of the others.
+ * @param vector A pointer to the vector to remove from.
+ * @param index The index of the element to remove.
+ * @return 0 if the element was removed successfully, -1 otherwise.
+ */
+int vec_remove(struct Vector *vector, size_t index);
+
+/**
+ * @brief Removes an element from a vector by moving the last element into its place.
+ * @param vector A pointer to the vector to remove from.
+ * @param index The index of the element to remove.
+ * @return 0 if the element was removed successfully, -1 otherwise.
+ */
+int vec_swap_remove(struct Vector *vector, size_t index);
+
+/**
+ * @brief Removes every element from a vector, keeping its capacity.
+ * @param vector A pointer to the vector to clear.
+ * @return void
+ */
+void vec_clear(struct Vector *vector);
+
+/**
+ * @brief Sorts the elements of a vector.
+ * @param vector A pointer to the vector to sort.
+ * @param order_function A function that orders two elements of the vector.
+ * @return void
+ */
+void vec_sort(struct Vector *vector, VectorOrderFunction order_function);
+
+#endif
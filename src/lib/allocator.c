@@ -0,0 +1,207 @@
+/**
+ * @brief A pluggable memory allocator interface used by every container.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+
+/**
+ * @brief Allocates memory from an allocator.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+void *allocator_alloc(const struct Allocator *allocator, size_t size)
+{
+    if (allocator == NULL)
+    {
+        return malloc(size);
+    }
+
+    return allocator->alloc(allocator->context, size);
+}
+
+/**
+ * @brief Resizes memory allocated from an allocator.
+ * @param allocator A pointer to the allocator the memory was allocated from, or NULL
+ *                  for malloc.
+ * @param pointer A pointer to the memory to resize, or NULL to allocate.
+ * @param old_size The size the memory was allocated with.
+ * @param new_size The size to resize the memory to.
+ * @return A pointer to the resized memory, or NULL if the allocation failed, in which
+ *         case the original memory is left untouched.
+ */
+void *allocator_realloc(const struct Allocator *allocator, void *pointer,
+                        size_t old_size, size_t new_size)
+{
+    if (allocator == NULL)
+    {
+        return realloc(pointer, new_size);
+    }
+
+    if (pointer == NULL)
+    {
+        return allocator->alloc(allocator->context, new_size);
+    }
+
+    if (allocator->realloc != NULL)
+    {
+        return allocator->realloc(allocator->context, pointer, old_size, new_size);
+    }
+
+    void *new_pointer = allocator->alloc(allocator->context, new_size);
+    if (new_pointer == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(new_pointer, pointer, old_size < new_size ? old_size : new_size);
+    allocator_free(allocator, pointer, old_size);
+
+    return new_pointer;
+}
+
+/**
+ * @brief Frees memory allocated from an allocator.
+ * @param allocator A pointer to the allocator the memory was allocated from, or NULL
+ *                  for malloc.
+ * @param pointer A pointer to the memory to free.
+ * @param size The size the memory was allocated with.
+ * @return void
+ */
+void allocator_free(const struct Allocator *allocator, void *pointer, size_t size)
+{
+    if (allocator == NULL)
+    {
+        free(pointer);
+
+        return;
+    }
+
+    if (allocator->free != NULL)
+    {
+        allocator->free(allocator->context, pointer, size);
+    }
+
+    return;
+}
+
+/**
+ * @brief Checks if an allocator frees its allocations one at a time.
+ * @param allocator A pointer to the allocator to check, or NULL for malloc.
+ * @return 1 if the allocator has a free function, 0 if it only releases memory in bulk.
+ */
+int allocator_frees_individually(const struct Allocator *allocator)
+{
+    return allocator == NULL || allocator->free != NULL;
+}
+
+/**
+ * @brief Allocates memory through a counting allocator.
+ * @param context A pointer to the counting allocator.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+static void *counting_allocator_alloc(void *context, size_t size)
+{
+    struct CountingAllocator *counting_allocator = context;
+
+    void *pointer = allocator_alloc(counting_allocator->parent, size);
+    if (pointer == NULL)
+    {
+        return NULL;
+    }
+
+    counting_allocator->allocations++;
+    counting_allocator->bytes_in_use += size;
+
+    if (counting_allocator->bytes_in_use > counting_allocator->peak_bytes_in_use)
+    {
+        counting_allocator->peak_bytes_in_use = counting_allocator->bytes_in_use;
+    }
+
+    return pointer;
+}
+
+/**
+ * @brief Resizes memory through a counting allocator.
+ * @param context A pointer to the counting allocator.
+ * @param pointer A pointer to the memory to resize.
+ * @param old_size The size the memory was allocated with.
+ * @param new_size The size to resize the memory to.
+ * @return A pointer to the resized memory, or NULL if the allocation failed.
+ *
+ * A resize is counted as one allocation and one free.
+ */
+static void *counting_allocator_realloc(void *context, void *pointer, size_t old_size,
+                                        size_t new_size)
+{
+    struct CountingAllocator *counting_allocator = context;
+
+    void *new_pointer =
+        allocator_realloc(counting_allocator->parent, pointer, old_size, new_size);
+    if (new_pointer == NULL)
+    {
+        return NULL;
+    }
+
+    counting_allocator->allocations++;
+    counting_allocator->frees++;
+    counting_allocator->bytes_in_use += new_size - old_size;
+
+    if (counting_allocator->bytes_in_use > counting_allocator->peak_bytes_in_use)
+    {
+        counting_allocator->peak_bytes_in_use = counting_allocator->bytes_in_use;
+    }
+
+    return new_pointer;
+}
+
+/**
+ * @brief Frees memory through a counting allocator.
+ * @param context A pointer to the counting allocator.
+ * @param pointer A pointer to the memory to free.
+ * @param size The size the memory was allocated with.
+ * @return void
+ */
+static void counting_allocator_free(void *context, void *pointer, size_t size)
+{
+    struct CountingAllocator *counting_allocator = context;
+
+    allocator_free(counting_allocator->parent, pointer, size);
+
+    counting_allocator->frees++;
+    counting_allocator->bytes_in_use -= size;
+
+    return;
+}
+
+/**
+ * @brief Initializes a counting allocator.
+ * @param counting_allocator A pointer to the counting allocator to initialize.
+ * @param parent A pointer to the allocator to forward to, or NULL for malloc.
+ * @return A pointer to the allocator interface to pass to containers.
+ *
+ * If the parent only releases memory in bulk, the counting allocator has no free
+ * function either, so containers skip their frees as they would with the parent and
+ * bytes_in_use keeps counting the memory the parent still holds.
+ */
+struct Allocator *counting_allocator_init(struct CountingAllocator *counting_allocator,
+                                          const struct Allocator *parent)
+{
+    counting_allocator->allocator.alloc = counting_allocator_alloc;
+    counting_allocator->allocator.realloc = counting_allocator_realloc;
+    counting_allocator->allocator.free =
+        allocator_frees_individually(parent) ? counting_allocator_free : NULL;
+    counting_allocator->allocator.context = counting_allocator;
+    counting_allocator->parent = parent;
+    counting_allocator->allocations = 0;
+    counting_allocator->frees = 0;
+    counting_allocator->bytes_in_use = 0;
+    counting_allocator->peak_bytes_in_use = 0;
+
+    return &counting_allocator->allocator;
+}
@@ -0,0 +1,246 @@
+/**
+ * @brief A bump pointer arena allocator that frees everything at once.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+#include "lib/arena.h"
+
+/**
+ * @brief Rounds a size up to a multiple of ARENA_ALIGNMENT.
+ * @param size The size to round up.
+ * @return The rounded size.
+ */
+static size_t arena_align(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Gets the first usable byte of an arena block.
+ * @param block A pointer to the block.
+ * @return A pointer to the first byte after the block header.
+ */
+static char *arena_block_data(struct ArenaBlock *block)
+{
+    return (char *)block + arena_align(sizeof(struct ArenaBlock));
+}
+
+/**
+ * @brief Moves an arena on to a block with room for an allocation.
+ * @param arena A pointer to the arena to move on.
+ * @param size The aligned size of the allocation that did not fit.
+ * @return 0 if the arena moved on to a block, -1 if allocating a block failed.
+ *
+ * The block after the current one is reused if it is large enough, which is the case
+ * after a reset. Otherwise a new block of at least block_size bytes is allocated and
+ * linked in after the current block.
+ */
+static int arena_next_block(struct Arena *arena, size_t size)
+{
+    struct ArenaBlock *next_block =
+        arena->current_block == NULL ? arena->first_block : arena->current_block->next;
+
+    if (next_block == NULL || next_block->size < size)
+    {
+        size_t block_size = size > arena->block_size ? size : arena->block_size;
+        size_t header_size = arena_align(sizeof(struct ArenaBlock));
+
+        struct ArenaBlock *block =
+            allocator_alloc(arena->parent, header_size + block_size);
+        if (block == NULL)
+        {
+            return -1;
+        }
+
+        block->size = block_size;
+        block->next = next_block;
+
+        if (arena->current_block == NULL)
+        {
+            arena->first_block = block;
+        }
+        else
+        {
+            arena->current_block->next = block;
+        }
+
+        next_block = block;
+    }
+
+    arena->current_block = next_block;
+    arena->cursor = arena_block_data(next_block);
+    arena->end = arena->cursor + next_block->size;
+
+    return 0;
+}
+
+/**
+ * @brief Allocates memory through the allocator interface of an arena.
+ * @param context A pointer to the arena.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+static void *arena_allocator_alloc(void *context, size_t size)
+{
+    return arena_alloc(context, size);
+}
+
+/**
+ * @brief Resizes memory through the allocator interface of an arena.
+ * @param context A pointer to the arena.
+ * @param pointer A pointer to the memory to resize.
+ * @param old_size The size the memory was allocated with.
+ * @param new_size The size to resize the memory to.
+ * @return A pointer to the resized memory, or NULL if the allocation failed.
+ *
+ * The most recent allocation is resized in place if it fits in the current block.
+ * Shrinking never moves the memory.
+ */
+static void *arena_allocator_realloc(void *context, void *pointer, size_t old_size,
+                                     size_t new_size)
+{
+    struct Arena *arena = context;
+    char *start = pointer;
+
+    if (start + arena_align(old_size) == arena->cursor &&
+        arena_align(new_size) <= (size_t)(arena->end - start))
+    {
+        arena->cursor = start + arena_align(new_size);
+
+        return pointer;
+    }
+
+    if (new_size <= old_size)
+    {
+        return pointer;
+    }
+
+    void *new_pointer = arena_alloc(arena, new_size);
+    if (new_pointer == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(new_pointer, pointer, old_size);
+
+    return new_pointer;
+}
+
+/**
+ * @brief Creates a new arena.
+ * @param block_size The number of bytes to allocate for each block.
+ * @return A pointer to the created arena.
+ */
+struct Arena *arena_create(size_t block_size)
+{
+    return arena_create_with_allocator(block_size, NULL);
+}
+
+/**
+ * @brief Creates a new arena that allocates its blocks from an allocator.
+ * @param block_size The number of bytes to allocate for each block.
+ * @param parent A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created arena.
+ *
+ * No block is allocated until the first call to arena_alloc.
+ */
+struct Arena *arena_create_with_allocator(size_t block_size,
+                                          const struct Allocator *parent)
+{
+    struct Arena *arena = allocator_alloc(parent, sizeof(struct Arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena->block_size = arena_align(block_size);
+    arena->first_block = NULL;
+    arena->current_block = NULL;
+    arena->cursor = NULL;
+    arena->end = NULL;
+    arena->allocator.alloc = arena_allocator_alloc;
+    arena->allocator.realloc = arena_allocator_realloc;
+    arena->allocator.free = NULL;
+    arena->allocator.context = arena;
+    arena->parent = parent;
+
+    return arena;
+}
+
+/**
+ * @brief Frees an arena and everything allocated from it.
+ * @param arena A pointer to the arena to free.
+ * @return void
+ */
+void arena_free(struct Arena *arena)
+{
+    struct ArenaBlock *current_block = arena->first_block;
+
+    while (current_block != NULL)
+    {
+        struct ArenaBlock *next_block = current_block->next;
+
+        allocator_free(arena->parent, current_block,
+                       arena_align(sizeof(struct ArenaBlock)) + current_block->size);
+        current_block = next_block;
+    }
+
+    allocator_free(arena->parent, arena, sizeof(struct Arena));
+
+    return;
+}
+
+/**
+ * @brief Allocates memory from an arena.
+ * @param arena A pointer to the arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if the allocation failed.
+ */
+void *arena_alloc(struct Arena *arena, size_t size)
+{
+    size = arena_align(size);
+
+    if (arena->cursor == NULL || (size_t)(arena->end - arena->cursor) < size)
+    {
+        if (arena_next_block(arena, size) != 0)
+        {
+            return NULL;
+        }
+    }
+
+    void *pointer = arena->cursor;
+    arena->cursor += size;
+
+    return pointer;
+}
+
+/**
+ * @brief Frees everything allocated from an arena, keeping its blocks for reuse.
+ * @param arena A pointer to the arena to reset.
+ * @return void
+ */
+void arena_reset(struct Arena *arena)
+{
+    arena->current_block = arena->first_block;
+
+    if (arena->first_block != NULL)
+    {
+        arena->cursor = arena_block_data(arena->first_block);
+        arena->end = arena->cursor + arena->first_block->size;
+    }
+
+    return;
+}
+
+/**
+ * @brief Gets the allocator interface of an arena.
+ * @param arena A pointer to the arena.
+ * @return A pointer to the allocator interface to pass to containers.
+ */
+struct Allocator *arena_allocator(struct Arena *arena)
+{
+    return &arena->allocator;
+}
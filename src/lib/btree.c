@@ -0,0 +1,689 @@
+/**
+ * @brief An ordered map from 64-bit integer keys to generic values, kept in a B+tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+#include "lib/btree.h"
+#include "lib/list.h"
+
+/**
+ * @brief Gets the index of the first key of a node that is not smaller than a key.
+ * @param node A pointer to the node to search.
+ * @param key The key to search for.
+ * @return The index of the key, or the number of keys if every key is smaller.
+ *
+ * Nodes are small enough that a linear scan over their contiguous keys, which is
+ * easy to predict, beats a binary search.
+ */
+static size_t bt_lower_bound(struct BTreeNode *node, uint64_t key)
+{
+    size_t index = 0;
+
+    while (index < node->count && node->keys[index] < key)
+    {
+        index++;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Gets the index of the child of an internal node that a key belongs in.
+ * @param node A pointer to the internal node to search.
+ * @param key The key to search for.
+ * @return The index of the child.
+ */
+static size_t bt_child_index(struct BTreeNode *node, uint64_t key)
+{
+    size_t index = 0;
+
+    while (index < node->count && node->keys[index] <= key)
+    {
+        index++;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Gets a child of an internal node.
+ * @param node A pointer to the internal node.
+ * @param index The index of the child.
+ * @return A pointer to the child.
+ */
+static struct BTreeNode *bt_child(struct BTreeNode *node, size_t index)
+{
+    return ((struct BTreeInternal *)node)->children[index];
+}
+
+/**
+ * @brief Allocates an empty node of a B+tree.
+ * @param tree A pointer to the tree the node belongs to.
+ * @param is_leaf 1 to allocate a leaf, 0 to allocate an internal node.
+ * @return A pointer to the node, or NULL if the allocation failed.
+ */
+static struct BTreeNode *bt_create_node(struct BTree *tree, int is_leaf)
+{
+    size_t size = is_leaf ? sizeof(struct BTreeLeaf) : sizeof(struct BTreeInternal);
+
+    struct BTreeNode *node = allocator_alloc(tree->allocator, size);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    node->count = 0;
+    node->is_leaf = is_leaf;
+
+    if (is_leaf)
+    {
+        ((struct BTreeLeaf *)node)->next = NULL;
+    }
+
+    return node;
+}
+
+/**
+ * @brief Frees a single node of a B+tree.
+ * @param tree A pointer to the tree the node belongs to.
+ * @param node A pointer to the node to free.
+ * @return void
+ */
+static void bt_free_node(struct BTree *tree, struct BTreeNode *node)
+{
+    allocator_free(tree->allocator, node,
+                   node->is_leaf ? sizeof(struct BTreeLeaf)
+                                 : sizeof(struct BTreeInternal));
+
+    return;
+}
+
+/**
+ * @brief Frees a node of a B+tree and every node below it.
+ * @param tree A pointer to the tree the node belongs to.
+ * @param node A pointer to the node to free.
+ * @param value_free_function A function that frees a value in the tree. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+static void bt_free_subtree(struct BTree *tree, struct BTreeNode *node,
+                            ValueFreeFunction value_free_function)
+{
+    if (node->is_leaf)
+    {
+        if (value_free_function != NULL)
+        {
+            for (size_t i = 0; i < node->count; i++)
+            {
+                value_free_function(((struct BTreeLeaf *)node)->values[i]);
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i <= node->count; i++)
+        {
+            bt_free_subtree(tree, bt_child(node, i), value_free_function);
+        }
+    }
+
+    bt_free_node(tree, node);
+
+    return;
+}
+
+/**
+ * @brief Finds the leaf of a B+tree that a key belongs in.
+ * @param tree A pointer to the tree to search, which must not be empty.
+ * @param key The key to search for.
+ * @return A pointer to the leaf.
+ */
+static struct BTreeLeaf *bt_find_leaf(struct BTree *tree, uint64_t key)
+{
+    struct BTreeNode *node = tree->root;
+
+    while (!node->is_leaf)
+    {
+        node = bt_child(node, bt_child_index(node, key));
+    }
+
+    return (struct BTreeLeaf *)node;
+}
+
+/**
+ * @brief Moves the upper half of an overflowing leaf into an empty leaf.
+ * @param leaf A pointer to the leaf to split, which holds BT_NODE_KEYS + 1 keys.
+ * @param right A pointer to the empty leaf that follows it afterwards.
+ * @return The smallest key in right, which separates the two leaves in their parent.
+ */
+static uint64_t bt_split_leaf(struct BTreeLeaf *leaf, struct BTreeLeaf *right)
+{
+    size_t left_count = leaf->node.count / 2;
+
+    right->node.count = leaf->node.count - left_count;
+    memcpy(right->node.keys, &leaf->node.keys[left_count],
+           right->node.count * sizeof(uint64_t));
+    memcpy(right->values, &leaf->values[left_count],
+           right->node.count * sizeof(void *));
+
+    leaf->node.count = left_count;
+    right->next = leaf->next;
+    leaf->next = right;
+
+    return right->node.keys[0];
+}
+
+/**
+ * @brief Moves the upper half of an overflowing internal node into an empty one.
+ * @param node A pointer to the node to split, which holds BT_NODE_KEYS + 1 keys.
+ * @param right A pointer to the empty internal node that follows it afterwards.
+ * @return The middle key, which is removed from both nodes and separates them in
+ *         their parent.
+ */
+static uint64_t bt_split_internal(struct BTreeInternal *node,
+                                  struct BTreeInternal *right)
+{
+    size_t left_count = node->node.count / 2;
+    uint64_t separator = node->node.keys[left_count];
+
+    right->node.count = node->node.count - left_count - 1;
+    memcpy(right->node.keys, &node->node.keys[left_count + 1],
+           right->node.count * sizeof(uint64_t));
+    memcpy(right->children, &node->children[left_count + 1],
+           (right->node.count + 1) * sizeof(struct BTreeNode *));
+
+    node->node.count = left_count;
+
+    return separator;
+}
+
+/**
+ * @brief Moves the largest key of the left sibling of a node into the node.
+ * @param parent A pointer to the parent of the node.
+ * @param index The index of the node in its parent, which is greater than 0.
+ * @return void
+ */
+static void bt_borrow_from_left(struct BTreeInternal *parent, size_t index)
+{
+    struct BTreeNode *node = parent->children[index];
+    struct BTreeNode *left = parent->children[index - 1];
+
+    memmove(&node->keys[1], node->keys, node->count * sizeof(uint64_t));
+
+    if (node->is_leaf)
+    {
+        struct BTreeLeaf *leaf = (struct BTreeLeaf *)node;
+
+        memmove(&leaf->values[1], leaf->values, node->count * sizeof(void *));
+        node->keys[0] = left->keys[left->count - 1];
+        leaf->values[0] = ((struct BTreeLeaf *)left)->values[left->count - 1];
+        parent->node.keys[index - 1] = node->keys[0];
+    }
+    else
+    {
+        struct BTreeInternal *internal = (struct BTreeInternal *)node;
+
+        memmove(&internal->children[1], internal->children,
+                (node->count + 1) * sizeof(struct BTreeNode *));
+        node->keys[0] = parent->node.keys[index - 1];
+        internal->children[0] = ((struct BTreeInternal *)left)->children[left->count];
+        parent->node.keys[index - 1] = left->keys[left->count - 1];
+    }
+
+    node->count++;
+    left->count--;
+
+    return;
+}
+
+/**
+ * @brief Moves the smallest key of the right sibling of a node into the node.
+ * @param parent A pointer to the parent of the node.
+ * @param index The index of the node in its parent, which is smaller than the
+ *              number of keys in the parent.
+ * @return void
+ */
+static void bt_borrow_from_right(struct BTreeInternal *parent, size_t index)
+{
+    struct BTreeNode *node = parent->children[index];
+    struct BTreeNode *right = parent->children[index + 1];
+
+    if (node->is_leaf)
+    {
+        struct BTreeLeaf *right_leaf = (struct BTreeLeaf *)right;
+
+        node->keys[node->count] = right->keys[0];
+        ((struct BTreeLeaf *)node)->values[node->count] = right_leaf->values[0];
+        memmove(right_leaf->values, &right_leaf->values[1],
+                (right->count - 1) * sizeof(void *));
+        memmove(right->keys, &right->keys[1], (right->count - 1) * sizeof(uint64_t));
+        parent->node.keys[index] = right->keys[0];
+    }
+    else
+    {
+        struct BTreeInternal *right_internal = (struct BTreeInternal *)right;
+
+        node->keys[node->count] = parent->node.keys[index];
+        ((struct BTreeInternal *)node)->children[node->count + 1] =
+            right_internal->children[0];
+        parent->node.keys[index] = right->keys[0];
+        memmove(right->keys, &right->keys[1], (right->count - 1) * sizeof(uint64_t));
+        memmove(right_internal->children, &right_internal->children[1],
+                right->count * sizeof(struct BTreeNode *));
+    }
+
+    node->count++;
+    right->count--;
+
+    return;
+}
+
+/**
+ * @brief Merges a child of an internal node with the child after it.
+ * @param tree A pointer to the tree the nodes belong to.
+ * @param parent A pointer to the parent of both children.
+ * @param index The index of the left child.
+ * @return void
+ *
+ * The right child is freed, and the key that separated the two is removed from the
+ * parent, so the parent may fall below BT_MIN_KEYS afterwards.
+ */
+static void bt_merge(struct BTree *tree, struct BTreeInternal *parent, size_t index)
+{
+    struct BTreeNode *left = parent->children[index];
+    struct BTreeNode *right = parent->children[index + 1];
+
+    if (left->is_leaf)
+    {
+        struct BTreeLeaf *left_leaf = (struct BTreeLeaf *)left;
+        struct BTreeLeaf *right_leaf = (struct BTreeLeaf *)right;
+
+        memcpy(&left->keys[left->count], right->keys, right->count * sizeof(uint64_t));
+        memcpy(&left_leaf->values[left->count], right_leaf->values,
+               right->count * sizeof(void *));
+        left->count += right->count;
+        left_leaf->next = right_leaf->next;
+    }
+    else
+    {
+        left->keys[left->count] = parent->node.keys[index];
+        memcpy(&left->keys[left->count + 1], right->keys,
+               right->count * sizeof(uint64_t));
+        memcpy(&((struct BTreeInternal *)left)->children[left->count + 1],
+               ((struct BTreeInternal *)right)->children,
+               (right->count + 1) * sizeof(struct BTreeNode *));
+        left->count += right->count + 1;
+    }
+
+    bt_free_node(tree, right);
+
+    memmove(&parent->node.keys[index], &parent->node.keys[index + 1],
+            (parent->node.count - index - 1) * sizeof(uint64_t));
+    memmove(&parent->children[index + 1], &parent->children[index + 2],
+            (parent->node.count - index - 1) * sizeof(struct BTreeNode *));
+    parent->node.count--;
+
+    return;
+}
+
+/**
+ * @brief Creates a new B+tree.
+ * @return A pointer to the created tree.
+ */
+struct BTree *bt_create(void)
+{
+    return bt_create_with_allocator(NULL);
+}
+
+/**
+ * @brief Creates a new B+tree that allocates from an allocator.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created tree.
+ *
+ * No nodes are allocated until the first key is inserted.
+ */
+struct BTree *bt_create_with_allocator(const struct Allocator *allocator)
+{
+    struct BTree *tree = allocator_alloc(allocator, sizeof(struct BTree));
+    if (tree == NULL)
+    {
+        return NULL;
+    }
+
+    tree->root = NULL;
+    tree->size = 0;
+    tree->allocator = allocator;
+
+    return tree;
+}
+
+/**
+ * @brief Frees a B+tree.
+ * @param tree A pointer to the tree to free.
+ * @param value_free_function A function that frees a value in the tree. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+void bt_free(struct BTree *tree, ValueFreeFunction value_free_function)
+{
+    if (tree->root != NULL)
+    {
+        bt_free_subtree(tree, tree->root, value_free_function);
+    }
+
+    allocator_free(tree->allocator, tree, sizeof(struct BTree));
+
+    return;
+}
+
+/**
+ * @brief Inserts a key-value pair into a B+tree, replacing the value if the key is
+ *        already in it.
+ * @param tree A pointer to the tree to insert into.
+ * @param key The key to insert.
+ * @param value A pointer to the value to insert.
+ * @return 0 if the key-value pair was inserted successfully, -1 otherwise.
+ *
+ * The path from the root is recorded on the way down. Every node that a new key
+ * makes overflow is full already, so the nodes needed to split them are allocated
+ * before anything is changed, and a failed allocation leaves the tree untouched.
+ */
+int bt_insert(struct BTree *tree, uint64_t key, void *value)
+{
+    if (tree->root == NULL)
+    {
+        tree->root = bt_create_node(tree, 1);
+        if (tree->root == NULL)
+        {
+            return -1;
+        }
+    }
+
+    struct BTreeInternal *path[BT_MAX_HEIGHT];
+    size_t path_indices[BT_MAX_HEIGHT];
+    size_t depth = 0;
+    struct BTreeNode *node = tree->root;
+
+    while (!node->is_leaf)
+    {
+        path[depth] = (struct BTreeInternal *)node;
+        path_indices[depth] = bt_child_index(node, key);
+        node = bt_child(node, path_indices[depth]);
+        depth++;
+    }
+
+    struct BTreeLeaf *leaf = (struct BTreeLeaf *)node;
+    size_t index = bt_lower_bound(node, key);
+
+    if (index < node->count && node->keys[index] == key)
+    {
+        leaf->values[index] = value;
+
+        return 0;
+    }
+
+    struct BTreeNode *spares[BT_MAX_HEIGHT + 1];
+    size_t spare_count = 0;
+
+    if (node->count == BT_NODE_KEYS)
+    {
+        size_t level = depth;
+
+        spare_count = 1;
+
+        while (level > 0 && path[level - 1]->node.count == BT_NODE_KEYS)
+        {
+            spare_count++;
+            level--;
+        }
+
+        if (level == 0)
+        {
+            spare_count++;
+        }
+
+        for (size_t i = 0; i < spare_count; i++)
+        {
+            spares[i] = bt_create_node(tree, i == 0);
+            if (spares[i] == NULL)
+            {
+                while (i > 0)
+                {
+                    bt_free_node(tree, spares[--i]);
+                }
+
+                return -1;
+            }
+        }
+    }
+
+    memmove(&node->keys[index + 1], &node->keys[index],
+            (node->count - index) * sizeof(uint64_t));
+    memmove(&leaf->values[index + 1], &leaf->values[index],
+            (node->count - index) * sizeof(void *));
+    node->keys[index] = key;
+    leaf->values[index] = value;
+    node->count++;
+    tree->size++;
+
+    if (spare_count == 0)
+    {
+        return 0;
+    }
+
+    struct BTreeNode *carry = spares[0];
+    uint64_t separator = bt_split_leaf(leaf, (struct BTreeLeaf *)carry);
+    size_t spare = 1;
+
+    while (depth > 0)
+    {
+        struct BTreeInternal *parent = path[--depth];
+        size_t child = path_indices[depth];
+
+        memmove(&parent->node.keys[child + 1], &parent->node.keys[child],
+                (parent->node.count - child) * sizeof(uint64_t));
+        memmove(&parent->children[child + 2], &parent->children[child + 1],
+                (parent->node.count - child) * sizeof(struct BTreeNode *));
+        parent->node.keys[child] = separator;
+        parent->children[child + 1] = carry;
+        parent->node.count++;
+
+        if (parent->node.count <= BT_NODE_KEYS)
+        {
+            return 0;
+        }
+
+        carry = spares[spare++];
+        separator = bt_split_internal(parent, (struct BTreeInternal *)carry);
+    }
+
+    struct BTreeInternal *root = (struct BTreeInternal *)spares[spare];
+
+    root->node.keys[0] = separator;
+    root->node.count = 1;
+    root->children[0] = tree->root;
+    root->children[1] = carry;
+    tree->root = &root->node;
+
+    return 0;
+}
+
+/**
+ * @brief Gets a value from a B+tree.
+ * @param tree A pointer to the tree to get from.
+ * @param key The key to get.
+ * @return A pointer to the value, or NULL if the key is not in the tree.
+ */
+void *bt_get(struct BTree *tree, uint64_t key)
+{
+    if (tree->root == NULL)
+    {
+        return NULL;
+    }
+
+    struct BTreeLeaf *leaf = bt_find_leaf(tree, key);
+    size_t index = bt_lower_bound(&leaf->node, key);
+
+    if (index == leaf->node.count || leaf->node.keys[index] != key)
+    {
+        return NULL;
+    }
+
+    return leaf->values[index];
+}
+
+/**
+ * @brief Removes a key-value pair from a B+tree.
+ * @param tree A pointer to the tree to remove from.
+ * @param key The key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the tree.
+ *
+ * A node that falls below BT_MIN_KEYS borrows a key from a sibling that can spare
+ * one, or is merged with a sibling otherwise, which may leave its parent short in
+ * turn. Keys in internal nodes only route searches, so they are left alone when
+ * the key they were copied from is removed.
+ */
+void *bt_remove(struct BTree *tree, uint64_t key)
+{
+    if (tree->root == NULL)
+    {
+        return NULL;
+    }
+
+    struct BTreeInternal *path[BT_MAX_HEIGHT];
+    size_t path_indices[BT_MAX_HEIGHT];
+    size_t depth = 0;
+    struct BTreeNode *node = tree->root;
+
+    while (!node->is_leaf)
+    {
+        path[depth] = (struct BTreeInternal *)node;
+        path_indices[depth] = bt_child_index(node, key);
+        node = bt_child(node, path_indices[depth]);
+        depth++;
+    }
+
+    struct BTreeLeaf *leaf = (struct BTreeLeaf *)node;
+    size_t index = bt_lower_bound(node, key);
+
+    if (index == node->count || node->keys[index] != key)
+    {
+        return NULL;
+    }
+
+    void *value = leaf->values[index];
+
+    memmove(&node->keys[index], &node->keys[index + 1],
+            (node->count - index - 1) * sizeof(uint64_t));
+    memmove(&leaf->values[index], &leaf->values[index + 1],
+            (node->count - index - 1) * sizeof(void *));
+    node->count--;
+    tree->size--;
+
+    while (depth > 0 && node->count < BT_MIN_KEYS)
+    {
+        struct BTreeInternal *parent = path[--depth];
+        size_t child = path_indices[depth];
+
+        if (child > 0 && parent->children[child - 1]->count > BT_MIN_KEYS)
+        {
+            bt_borrow_from_left(parent, child);
+        }
+        else if (child < parent->node.count &&
+                 parent->children[child + 1]->count > BT_MIN_KEYS)
+        {
+            bt_borrow_from_right(parent, child);
+        }
+        else
+        {
+            bt_merge(tree, parent, child > 0 ? child - 1 : child);
+        }
+
+        node = &parent->node;
+    }
+
+    if (tree->root->count == 0)
+    {
+        struct BTreeNode *root = tree->root;
+
+        tree->root = root->is_leaf ? NULL : bt_child(root, 0);
+        bt_free_node(tree, root);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Gets the number of keys in a B+tree.
+ * @param tree A pointer to the tree.
+ * @return The number of keys.
+ */
+size_t bt_size(struct BTree *tree)
+{
+    return tree->size;
+}
+
+/**
+ * @brief Starts iterating over the keys of a B+tree from a given key.
+ * @param tree A pointer to the tree to iterate over.
+ * @param from The smallest key to return. Pass 0 to iterate over every key.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return void
+ *
+ * Finding the first key takes O(log n) time, and every call to bt_iter_next after
+ * that takes constant time, so walking k keys of a range takes O(log n + k).
+ */
+void bt_iter_begin(struct BTree *tree, uint64_t from, struct BTreeIterator *iterator)
+{
+    if (tree->root == NULL)
+    {
+        iterator->leaf = NULL;
+        iterator->index = 0;
+
+        return;
+    }
+
+    iterator->leaf = bt_find_leaf(tree, from);
+    iterator->index = bt_lower_bound(&iterator->leaf->node, from);
+
+    return;
+}
+
+/**
+ * @brief Advances an iterator to the next key of a B+tree.
+ * @param iterator A pointer to the iterator to advance.
+ * @param key A pointer that is set to the key. Pass NULL if it is not needed.
+ * @param value A pointer that is set to the value. Pass NULL if it is not needed.
+ * @return 1 if a key was returned, 0 if every key has been returned.
+ */
+int bt_iter_next(struct BTreeIterator *iterator, uint64_t *key, void **value)
+{
+    while (iterator->leaf != NULL && iterator->index == iterator->leaf->node.count)
+    {
+        iterator->leaf = iterator->leaf->next;
+        iterator->index = 0;
+    }
+
+    if (iterator->leaf == NULL)
+    {
+        return 0;
+    }
+
+    if (key != NULL)
+    {
+        *key = iterator->leaf->node.keys[iterator->index];
+    }
+
+    if (value != NULL)
+    {
+        *value = iterator->leaf->values[iterator->index];
+    }
+
+    iterator->index++;
+
+    return 1;
+}
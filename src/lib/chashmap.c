@@ -0,0 +1,676 @@
+/**
+ * @brief A concurrent hashmap with lock-free lookups and striped writer locks.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/chashmap.h"
+#include "lib/epoch.h"
+#include "lib/hashmap.h"
+#include "lib/ilist.h"
+
+/**
+ * @brief Rounds a capacity up to a power of two of at least CHM_STRIPES.
+ * @param capacity The capacity to round up.
+ * @return The rounded capacity, or 0 if it does not fit in a size_t.
+ */
+static size_t chm_round_capacity(size_t capacity)
+{
+    size_t rounded_capacity = CHM_STRIPES;
+
+    while (rounded_capacity < capacity)
+    {
+        if (rounded_capacity > SIZE_MAX / 2)
+        {
+            return 0;
+        }
+
+        rounded_capacity *= 2;
+    }
+
+    return rounded_capacity;
+}
+
+/**
+ * @brief Gets the lock guarding the bucket of a hash.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap.
+ * @param hash The hash to get the lock for.
+ * @return A pointer to the lock.
+ */
+static pthread_rwlock_t *chm_lock(struct ConcurrentHashMap *concurrent_hashmap,
+                                  uint64_t hash)
+{
+    return &concurrent_hashmap->stripes[hash & (CHM_STRIPES - 1)].lock;
+}
+
+/**
+ * @brief Gets the size of the allocation holding a table.
+ * @param capacity The capacity of the table.
+ * @return The size of the table header and its buckets.
+ */
+static size_t chm_table_size(size_t capacity)
+{
+    return sizeof(struct ConcurrentHashMapTable) +
+           capacity * sizeof(_Atomic(struct ConcurrentHashMapEntry *));
+}
+
+/**
+ * @brief Allocates a table of empty buckets.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @param capacity The number of buckets to allocate.
+ * @return A pointer to the table, or NULL if the allocation failed.
+ */
+static struct ConcurrentHashMapTable *
+chm_create_table(const struct Allocator *allocator, size_t capacity)
+{
+    struct ConcurrentHashMapTable *table =
+        allocator_alloc(allocator, chm_table_size(capacity));
+    if (table == NULL)
+    {
+        return NULL;
+    }
+
+    table->capacity = capacity;
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        atomic_init(&table->buckets[i], NULL);
+    }
+
+    return table;
+}
+
+/**
+ * @brief Frees a retired entry of a concurrent hashmap.
+ * @param node A pointer to the reclamation state of the entry.
+ * @param context A pointer to the concurrent hashmap the entry belonged to.
+ * @return void
+ */
+static void chm_free_entry(struct EpochNode *node, void *context)
+{
+    struct ConcurrentHashMap *concurrent_hashmap = context;
+
+    allocator_free(concurrent_hashmap->allocator,
+                   container_of(node, struct ConcurrentHashMapEntry, epoch_node),
+                   sizeof(struct ConcurrentHashMapEntry));
+
+    return;
+}
+
+/**
+ * @brief Frees a table of a concurrent hashmap, together with every entry in it.
+ * @param node A pointer to the reclamation state of the table.
+ * @param context A pointer to the concurrent hashmap the table belonged to.
+ * @return void
+ *
+ * An outgrown table is retired through this function as a whole. No writer can
+ * reach it once its replacement is published, so its chains no longer change and
+ * the entries in it are exactly the ones that were copied.
+ */
+static void chm_free_table(struct EpochNode *node, void *context)
+{
+    struct ConcurrentHashMap *concurrent_hashmap = context;
+    struct ConcurrentHashMapTable *table =
+        container_of(node, struct ConcurrentHashMapTable, epoch_node);
+
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        struct ConcurrentHashMapEntry *current_entry =
+            atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+
+        while (current_entry != NULL)
+        {
+            struct ConcurrentHashMapEntry *next_entry =
+                atomic_load_explicit(&current_entry->next, memory_order_relaxed);
+
+            chm_free_entry(&current_entry->epoch_node, concurrent_hashmap);
+            current_entry = next_entry;
+        }
+    }
+
+    allocator_free(concurrent_hashmap->allocator, table,
+                   chm_table_size(table->capacity));
+
+    return;
+}
+
+/**
+ * @brief Allocates entries onto a list of spare entries.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to allocate for.
+ * @param spare_entries A pointer to the list of spare entries, linked through
+ *                      their next pointers.
+ * @param count The number of entries to allocate.
+ * @return 0 if every entry was allocated, -1 otherwise. The entries allocated
+ *         before the failure stay on the list.
+ */
+static int chm_alloc_entries(struct ConcurrentHashMap *concurrent_hashmap,
+                             struct ConcurrentHashMapEntry **spare_entries,
+                             size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        struct ConcurrentHashMapEntry *entry = allocator_alloc(
+            concurrent_hashmap->allocator, sizeof(struct ConcurrentHashMapEntry));
+        if (entry == NULL)
+        {
+            return -1;
+        }
+
+        atomic_init(&entry->next, *spare_entries);
+        *spare_entries = entry;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Frees a list of spare entries.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap they were
+ *                           allocated for.
+ * @param spare_entries A pointer to the first spare entry, or NULL.
+ * @return void
+ */
+static void chm_free_entries(struct ConcurrentHashMap *concurrent_hashmap,
+                             struct ConcurrentHashMapEntry *spare_entries)
+{
+    while (spare_entries != NULL)
+    {
+        struct ConcurrentHashMapEntry *next_entry =
+            atomic_load_explicit(&spare_entries->next, memory_order_relaxed);
+
+        chm_free_entry(&spare_entries->epoch_node, concurrent_hashmap);
+        spare_entries = next_entry;
+    }
+
+    return;
+}
+
+/**
+ * @brief Gets the link that points to the entry holding a key.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to search. The
+ *                           caller holds the lock of the stripe of the hash.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @return A pointer to the bucket head or next pointer that points to the entry
+ *         holding the key, or to the NULL that ends the bucket if the key is not in
+ *         the hashmap.
+ */
+static _Atomic(struct ConcurrentHashMapEntry *) *
+chm_find(struct ConcurrentHashMap *concurrent_hashmap, void *key, uint64_t hash)
+{
+    struct ConcurrentHashMapTable *table =
+        atomic_load_explicit(&concurrent_hashmap->table, memory_order_relaxed);
+    _Atomic(struct ConcurrentHashMapEntry *) *link =
+        &table->buckets[hash & (table->capacity - 1)];
+
+    HashMapKeyCompareFunction key_compare_function =
+        concurrent_hashmap->key_compare_function;
+    struct ConcurrentHashMapEntry *current_entry =
+        atomic_load_explicit(link, memory_order_relaxed);
+
+    while (current_entry != NULL)
+    {
+        if (current_entry->entry.hash == hash &&
+            key_compare_function(current_entry->entry.key, key) == 0)
+        {
+            break;
+        }
+
+        link = &current_entry->next;
+        current_entry = atomic_load_explicit(link, memory_order_relaxed);
+    }
+
+    return link;
+}
+
+/**
+ * @brief Looks up the value of a key without taking a lock.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to search. The
+ *                           caller is inside an epoch critical section, or holds
+ *                           the lock of the stripe of the hash.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ */
+static void *chm_lookup(struct ConcurrentHashMap *concurrent_hashmap, void *key,
+                        uint64_t hash)
+{
+    struct ConcurrentHashMapTable *table =
+        atomic_load_explicit(&concurrent_hashmap->table, memory_order_acquire);
+    HashMapKeyCompareFunction key_compare_function =
+        concurrent_hashmap->key_compare_function;
+    struct ConcurrentHashMapEntry *current_entry = atomic_load_explicit(
+        &table->buckets[hash & (table->capacity - 1)], memory_order_acquire);
+
+    while (current_entry != NULL)
+    {
+        if (current_entry->entry.hash == hash &&
+            key_compare_function(current_entry->entry.key, key) == 0)
+        {
+            return current_entry->entry.value;
+        }
+
+        current_entry =
+            atomic_load_explicit(&current_entry->next, memory_order_acquire);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Copies every entry of a table into an empty table of twice the capacity.
+ * @param table A pointer to the table to copy.
+ * @param new_table A pointer to the table to copy into.
+ * @param spare_entries A pointer to a list of spare entries to copy into. It holds
+ *                      at least as many entries as the table does.
+ * @return void
+ */
+static void chm_copy_table(struct ConcurrentHashMapTable *table,
+                           struct ConcurrentHashMapTable *new_table,
+                           struct ConcurrentHashMapEntry **spare_entries)
+{
+    size_t capacity = new_table->capacity;
+
+    for (size_t i = 0; i < table->capacity; i++)
+    {
+        struct ConcurrentHashMapEntry *current_entry =
+            atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+
+        while (current_entry != NULL)
+        {
+            struct ConcurrentHashMapEntry *new_entry = *spare_entries;
+            _Atomic(struct ConcurrentHashMapEntry *) *bucket =
+                &new_table->buckets[current_entry->entry.hash & (capacity - 1)];
+
+            *spare_entries =
+                atomic_load_explicit(&new_entry->next, memory_order_relaxed);
+
+            new_entry->entry = current_entry->entry;
+            atomic_init(&new_entry->next,
+                        atomic_load_explicit(bucket, memory_order_relaxed));
+            atomic_init(bucket, new_entry);
+
+            current_entry =
+                atomic_load_explicit(&current_entry->next, memory_order_relaxed);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Doubles the capacity of a concurrent hashmap if it is over its load factor.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to grow. The caller
+ *                           holds none of its locks.
+ * @return void
+ *
+ * The new table, and an entry for every entry the hashmap holds plus one for each
+ * stripe, are allocated before any stripe is taken, so that writers never wait on
+ * the allocator. Every stripe is then taken for writing in order, so two growing
+ * threads cannot deadlock, and the second one sees that the first already grew the
+ * hashmap. If other writers added more entries than were allocated in the
+ * meantime, the stripes are released and the missing entries allocated before
+ * trying again.
+ *
+ * The old table is retired once the stripes are released, as a single node that
+ * frees its entries along with it. If an allocation fails, the hashmap keeps its
+ * current table and only gets slower.
+ */
+static void chm_maybe_grow(struct ConcurrentHashMap *concurrent_hashmap)
+{
+    struct ConcurrentHashMapTable *new_table = NULL;
+    struct ConcurrentHashMapEntry *spare_entries = NULL;
+    size_t spare_count = 0;
+    struct ConcurrentHashMapTable *retired_table = NULL;
+
+    for (;;)
+    {
+        struct ConcurrentHashMapTable *table =
+            atomic_load_explicit(&concurrent_hashmap->table, memory_order_acquire);
+        size_t size = atomic_load(&concurrent_hashmap->size);
+
+        if (size * 100 <= table->capacity * HM_MAX_LOAD_PERCENT)
+        {
+            break;
+        }
+
+        if (new_table != NULL && new_table->capacity != table->capacity * 2)
+        {
+            chm_free_table(&new_table->epoch_node, concurrent_hashmap);
+            new_table = NULL;
+        }
+
+        if (new_table == NULL)
+        {
+            new_table = chm_create_table(concurrent_hashmap->allocator,
+                                         table->capacity * 2);
+            if (new_table == NULL)
+            {
+                break;
+            }
+        }
+
+        if (spare_count < size + CHM_STRIPES)
+        {
+            size_t count = size + CHM_STRIPES - spare_count;
+
+            if (chm_alloc_entries(concurrent_hashmap, &spare_entries, count) != 0)
+            {
+                break;
+            }
+
+            spare_count += count;
+        }
+
+        for (size_t i = 0; i < CHM_STRIPES; i++)
+        {
+            pthread_rwlock_wrlock(&concurrent_hashmap->stripes[i].lock);
+        }
+
+        struct ConcurrentHashMapTable *current_table =
+            atomic_load_explicit(&concurrent_hashmap->table, memory_order_relaxed);
+        size = atomic_load(&concurrent_hashmap->size);
+
+        int is_ready = current_table == table && size <= spare_count &&
+                       size * 100 > table->capacity * HM_MAX_LOAD_PERCENT;
+
+        if (is_ready)
+        {
+            chm_copy_table(table, new_table, &spare_entries);
+            atomic_store_explicit(&concurrent_hashmap->table, new_table,
+                                  memory_order_release);
+        }
+
+        for (size_t i = CHM_STRIPES; i > 0; i--)
+        {
+            pthread_rwlock_unlock(&concurrent_hashmap->stripes[i - 1].lock);
+        }
+
+        if (is_ready)
+        {
+            retired_table = table;
+            new_table = NULL;
+
+            break;
+        }
+    }
+
+    if (new_table != NULL)
+    {
+        chm_free_table(&new_table->epoch_node, concurrent_hashmap);
+    }
+
+    chm_free_entries(concurrent_hashmap, spare_entries);
+
+    if (retired_table != NULL)
+    {
+        epoch_retire(&retired_table->epoch_node, chm_free_table, concurrent_hashmap);
+    }
+
+    return;
+}
+
+/**
+ * @brief Creates a new concurrent hashmap.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two
+ *                 of at least CHM_STRIPES.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @return A pointer to the created concurrent hashmap, or NULL if the capacity has
+ *         no power of two that fits in a size_t or an allocation failed.
+ */
+struct ConcurrentHashMap *chm_create(size_t capacity, HashMapHashFunction hash_function,
+                                     HashMapKeyCompareFunction key_compare_function)
+{
+    return chm_create_with_allocator(capacity, hash_function, key_compare_function,
+                                     NULL);
+}
+
+/**
+ * @brief Creates a new concurrent hashmap that allocates from an allocator.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two
+ *                 of at least CHM_STRIPES.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @param allocator A pointer to a thread safe allocator to allocate from, or NULL
+ *                  for malloc.
+ * @return A pointer to the created concurrent hashmap, or NULL if the capacity has
+ *         no power of two that fits in a size_t or an allocation failed.
+ */
+struct ConcurrentHashMap *
+chm_create_with_allocator(size_t capacity, HashMapHashFunction hash_function,
+                          HashMapKeyCompareFunction key_compare_function,
+                          const struct Allocator *allocator)
+{
+    size_t rounded_capacity = chm_round_capacity(capacity);
+    if (rounded_capacity == 0)
+    {
+        return NULL;
+    }
+
+    struct ConcurrentHashMap *concurrent_hashmap =
+        allocator_alloc(allocator, sizeof(struct ConcurrentHashMap));
+    if (concurrent_hashmap == NULL)
+    {
+        return NULL;
+    }
+
+    struct ConcurrentHashMapTable *table =
+        chm_create_table(allocator, rounded_capacity);
+    if (table == NULL)
+    {
+        allocator_free(allocator, concurrent_hashmap, sizeof(struct ConcurrentHashMap));
+
+        return NULL;
+    }
+
+    for (size_t i = 0; i < CHM_STRIPES; i++)
+    {
+        pthread_rwlock_init(&concurrent_hashmap->stripes[i].lock, NULL);
+    }
+
+    atomic_init(&concurrent_hashmap->table, table);
+    atomic_init(&concurrent_hashmap->size, 0);
+    concurrent_hashmap->hash_function = hash_function;
+    concurrent_hashmap->key_compare_function = key_compare_function;
+    concurrent_hashmap->allocator = allocator;
+
+    return concurrent_hashmap;
+}
+
+/**
+ * @brief Frees a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to free. No other
+ *                           thread may be using it, and the calling thread may not
+ *                           be inside an epoch critical section.
+ * @param entry_free_function A function that frees an entry in the hashmap.
+ *                            Pass NULL if the entries do not need to be freed.
+ * @return void
+ *
+ * Entries and tables the hashmap retired are freed first, since freeing them uses
+ * the hashmap.
+ */
+void chm_free(struct ConcurrentHashMap *concurrent_hashmap,
+              HashMapEntryFreeFunction entry_free_function)
+{
+    epoch_synchronize();
+
+    struct ConcurrentHashMapTable *table =
+        atomic_load_explicit(&concurrent_hashmap->table, memory_order_relaxed);
+
+    if (entry_free_function != NULL)
+    {
+        for (size_t i = 0; i < table->capacity; i++)
+        {
+            struct ConcurrentHashMapEntry *current_entry =
+                atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+
+            while (current_entry != NULL)
+            {
+                entry_free_function(&current_entry->entry);
+                current_entry =
+                    atomic_load_explicit(&current_entry->next, memory_order_relaxed);
+            }
+        }
+    }
+
+    chm_free_table(&table->epoch_node, concurrent_hashmap);
+
+    for (size_t i = 0; i < CHM_STRIPES; i++)
+    {
+        pthread_rwlock_destroy(&concurrent_hashmap->stripes[i].lock);
+    }
+
+    allocator_free(concurrent_hashmap->allocator, concurrent_hashmap,
+                   sizeof(struct ConcurrentHashMap));
+
+    return;
+}
+
+/**
+ * @brief Sets a key-value pair in a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ *
+ * The new entry is allocated before the stripe is locked, so that the lock is never
+ * held across a call to the allocator. If the key is already in the hashmap, the
+ * new entry takes the place of the old one, which is retired.
+ */
+int chm_set(struct ConcurrentHashMap *concurrent_hashmap, void *key, void *value)
+{
+    uint64_t hash = concurrent_hashmap->hash_function(key);
+    pthread_rwlock_t *lock = chm_lock(concurrent_hashmap, hash);
+
+    struct ConcurrentHashMapEntry *new_entry = allocator_alloc(
+        concurrent_hashmap->allocator, sizeof(struct ConcurrentHashMapEntry));
+    if (new_entry == NULL)
+    {
+        return -1;
+    }
+
+    new_entry->entry.key = key;
+    new_entry->entry.value = value;
+    new_entry->entry.hash = hash;
+
+    pthread_rwlock_wrlock(lock);
+
+    _Atomic(struct ConcurrentHashMapEntry *) *link =
+        chm_find(concurrent_hashmap, key, hash);
+    struct ConcurrentHashMapEntry *replaced_entry =
+        atomic_load_explicit(link, memory_order_relaxed);
+
+    if (replaced_entry != NULL)
+    {
+        atomic_init(&new_entry->next,
+                    atomic_load_explicit(&replaced_entry->next, memory_order_relaxed));
+        atomic_store_explicit(link, new_entry, memory_order_release);
+
+        pthread_rwlock_unlock(lock);
+
+        epoch_retire(&replaced_entry->epoch_node, chm_free_entry, concurrent_hashmap);
+
+        return 0;
+    }
+
+    atomic_init(&new_entry->next, NULL);
+    atomic_store_explicit(link, new_entry, memory_order_release);
+
+    struct ConcurrentHashMapTable *table =
+        atomic_load_explicit(&concurrent_hashmap->table, memory_order_relaxed);
+    size_t size = atomic_fetch_add(&concurrent_hashmap->size, 1) + 1;
+    size_t capacity = table->capacity;
+
+    pthread_rwlock_unlock(lock);
+
+    if (size * 100 > capacity * HM_MAX_LOAD_PERCENT)
+    {
+        chm_maybe_grow(concurrent_hashmap);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gets a value from a concurrent hashmap without taking a lock.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ *
+ * If the calling thread cannot enter an epoch critical section because allocating
+ * its record failed, the lookup falls back to taking the lock of its stripe.
+ */
+void *chm_get(struct ConcurrentHashMap *concurrent_hashmap, void *key)
+{
+    uint64_t hash = concurrent_hashmap->hash_function(key);
+
+    if (epoch_enter() != 0)
+    {
+        pthread_rwlock_t *lock = chm_lock(concurrent_hashmap, hash);
+
+        pthread_rwlock_rdlock(lock);
+        void *value = chm_lookup(concurrent_hashmap, key, hash);
+        pthread_rwlock_unlock(lock);
+
+        return value;
+    }
+
+    void *value = chm_lookup(concurrent_hashmap, key, hash);
+
+    epoch_exit();
+
+    return value;
+}
+
+/**
+ * @brief Removes a key-value pair from a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ */
+void *chm_remove(struct ConcurrentHashMap *concurrent_hashmap, void *key)
+{
+    uint64_t hash = concurrent_hashmap->hash_function(key);
+    pthread_rwlock_t *lock = chm_lock(concurrent_hashmap, hash);
+
+    pthread_rwlock_wrlock(lock);
+
+    _Atomic(struct ConcurrentHashMapEntry *) *link =
+        chm_find(concurrent_hashmap, key, hash);
+    struct ConcurrentHashMapEntry *removed_entry =
+        atomic_load_explicit(link, memory_order_relaxed);
+    if (removed_entry == NULL)
+    {
+        pthread_rwlock_unlock(lock);
+
+        return NULL;
+    }
+
+    atomic_store_explicit(
+        link, atomic_load_explicit(&removed_entry->next, memory_order_relaxed),
+        memory_order_release);
+    atomic_fetch_sub(&concurrent_hashmap->size, 1);
+
+    pthread_rwlock_unlock(lock);
+
+    void *value = removed_entry->entry.value;
+
+    epoch_retire(&removed_entry->epoch_node, chm_free_entry, concurrent_hashmap);
+
+    return value;
+}
+
+/**
+ * @brief Gets the number of entries in a concurrent hashmap.
+ * @param concurrent_hashmap A pointer to the concurrent hashmap.
+ * @return The number of entries, which other threads may change at any time.
+ */
+size_t chm_size(struct ConcurrentHashMap *concurrent_hashmap)
+{
+    return atomic_load(&concurrent_hashmap->size);
+}
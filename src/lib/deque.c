@@ -0,0 +1,247 @@
+/**
+ * @brief A generic double-ended queue backed by a ring buffer.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+#include "lib/deque.h"
+
+/**
+ * @brief Gets the slot index of a value of a deque.
+ * @param deque A pointer to the deque.
+ * @param index The index of the value, counting from the front.
+ * @return The index of the slot holding the value.
+ */
+static size_t dq_slot(struct Deque *deque, size_t index)
+{
+    return (deque->head + index) & (deque->capacity - 1);
+}
+
+/**
+ * @brief Doubles the capacity of a deque if it is full.
+ * @param deque A pointer to the deque to grow.
+ * @return 0 if the deque has room for another value, -1 otherwise.
+ *
+ * The values are copied to the start of the new slots in order, which unwraps them.
+ */
+static int dq_maybe_grow(struct Deque *deque)
+{
+    if (deque->size < deque->capacity)
+    {
+        return 0;
+    }
+
+    size_t capacity = deque->capacity == 0 ? DQ_MIN_CAPACITY : deque->capacity * 2;
+
+    void **slots = allocator_alloc(deque->allocator, capacity * sizeof(void *));
+    if (slots == NULL)
+    {
+        return -1;
+    }
+
+    if (deque->size > 0)
+    {
+        size_t first_part = deque->capacity - deque->head;
+
+        if (first_part > deque->size)
+        {
+            first_part = deque->size;
+        }
+
+        memcpy(slots, &deque->slots[deque->head], first_part * sizeof(void *));
+        memcpy(&slots[first_part], deque->slots,
+               (deque->size - first_part) * sizeof(void *));
+    }
+
+    if (deque->slots != NULL)
+    {
+        allocator_free(deque->allocator, deque->slots,
+                       deque->capacity * sizeof(void *));
+    }
+
+    deque->slots = slots;
+    deque->capacity = capacity;
+    deque->head = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Creates a new deque.
+ * @return A pointer to the created deque.
+ */
+struct Deque *dq_create(void)
+{
+    return dq_create_with_allocator(NULL);
+}
+
+/**
+ * @brief Creates a new deque that allocates from an allocator.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created deque.
+ *
+ * No slots are allocated until the first value is pushed.
+ */
+struct Deque *dq_create_with_allocator(const struct Allocator *allocator)
+{
+    struct Deque *deque = allocator_alloc(allocator, sizeof(struct Deque));
+    if (deque == NULL)
+    {
+        return NULL;
+    }
+
+    deque->capacity = 0;
+    deque->head = 0;
+    deque->size = 0;
+    deque->slots = NULL;
+    deque->allocator = allocator;
+
+    return deque;
+}
+
+/**
+ * @brief Frees a deque.
+ * @param deque A pointer to the deque to free.
+ * @param value_free_function A function that frees a value in the deque. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+void dq_free(struct Deque *deque, ValueFreeFunction value_free_function)
+{
+    if (value_free_function != NULL)
+    {
+        for (size_t i = 0; i < deque->size; i++)
+        {
+            value_free_function(deque->slots[dq_slot(deque, i)]);
+        }
+    }
+
+    if (deque->slots != NULL)
+    {
+        allocator_free(deque->allocator, deque->slots,
+                       deque->capacity * sizeof(void *));
+    }
+
+    allocator_free(deque->allocator, deque, sizeof(struct Deque));
+
+    return;
+}
+
+/**
+ * @brief Gets a value of a deque.
+ * @param deque A pointer to the deque to get from.
+ * @param index The index of the value to get, counting from the front.
+ * @return A pointer to the value, or NULL if the index is out of bounds.
+ */
+void *dq_get(struct Deque *deque, size_t index)
+{
+    if (index >= deque->size)
+    {
+        return NULL;
+    }
+
+    return deque->slots[dq_slot(deque, index)];
+}
+
+/**
+ * @brief Pushes a value onto the back of a deque.
+ * @param deque A pointer to the deque to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dq_push_back(struct Deque *deque, void *value)
+{
+    if (dq_maybe_grow(deque) != 0)
+    {
+        return -1;
+    }
+
+    deque->slots[dq_slot(deque, deque->size)] = value;
+    deque->size++;
+
+    return 0;
+}
+
+/**
+ * @brief Pushes a value onto the front of a deque.
+ * @param deque A pointer to the deque to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dq_push_front(struct Deque *deque, void *value)
+{
+    if (dq_maybe_grow(deque) != 0)
+    {
+        return -1;
+    }
+
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->slots[deque->head] = value;
+    deque->size++;
+
+    return 0;
+}
+
+/**
+ * @brief Pops a value from the back of a deque.
+ * @param deque A pointer to the deque to pop from.
+ * @return A pointer to the popped value, or NULL if the deque is empty.
+ */
+void *dq_pop_back(struct Deque *deque)
+{
+    if (deque->size == 0)
+    {
+        return NULL;
+    }
+
+    deque->size--;
+
+    return deque->slots[dq_slot(deque, deque->size)];
+}
+
+/**
+ * @brief Pops a value from the front of a deque.
+ * @param deque A pointer to the deque to pop from.
+ * @return A pointer to the popped value, or NULL if the deque is empty.
+ */
+void *dq_pop_front(struct Deque *deque)
+{
+    if (deque->size == 0)
+    {
+        return NULL;
+    }
+
+    void *value = deque->slots[deque->head];
+
+    deque->head = dq_slot(deque, 1);
+    deque->size--;
+
+    return value;
+}
+
+/**
+ * @brief Gets the value at the front of a deque without removing it.
+ * @param deque A pointer to the deque to peek at.
+ * @return A pointer to the value, or NULL if the deque is empty.
+ */
+void *dq_peek_front(struct Deque *deque)
+{
+    return dq_get(deque, 0);
+}
+
+/**
+ * @brief Gets the value at the back of a deque without removing it.
+ * @param deque A pointer to the deque to peek at.
+ * @return A pointer to the value, or NULL if the deque is empty.
+ */
+void *dq_peek_back(struct Deque *deque)
+{
+    if (deque->size == 0)
+    {
+        return NULL;
+    }
+
+    return dq_get(deque, deque->size - 1);
+}
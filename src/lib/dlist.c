@@ -0,0 +1,443 @@
+/**
+ * @brief A generic doubly linked list implementation.
+ */
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+#include "lib/dlist.h"
+#include "lib/pool.h"
+
+/**
+ * @brief Allocates a node for a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list the node is for.
+ * @param value A pointer to the value of the node.
+ * @return A pointer to the allocated node, or NULL if the allocation failed.
+ */
+static struct DoublyLinkedListNode *
+dll_alloc_node(struct DoublyLinkedList *doubly_linked_list, void *value)
+{
+    struct DoublyLinkedListNode *node;
+
+    if (doubly_linked_list->node_pool != NULL)
+    {
+        node = pool_alloc(doubly_linked_list->node_pool);
+    }
+    else
+    {
+        node = allocator_alloc(doubly_linked_list->allocator,
+                               sizeof(struct DoublyLinkedListNode));
+    }
+
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    node->value = value;
+    node->prev = NULL;
+    node->next = NULL;
+
+    return node;
+}
+
+/**
+ * @brief Frees a node of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list the node was
+ *                           allocated for.
+ * @param node A pointer to the node to free.
+ * @return void
+ */
+static void dll_free_node(struct DoublyLinkedList *doubly_linked_list,
+                          struct DoublyLinkedListNode *node)
+{
+    if (doubly_linked_list->node_pool != NULL)
+    {
+        pool_release(doubly_linked_list->node_pool, node);
+    }
+    else
+    {
+        allocator_free(doubly_linked_list->allocator, node,
+                       sizeof(struct DoublyLinkedListNode));
+    }
+
+    return;
+}
+
+/**
+ * @brief Links a detached node into a doubly linked list between two nodes.
+ * @param doubly_linked_list A pointer to the doubly linked list to link into.
+ * @param prev A pointer to the node to link after, or NULL to link at the head.
+ * @param next A pointer to the node to link before, or NULL to link at the tail.
+ * @param node A pointer to the node to link.
+ * @return void
+ */
+static void dll_link_node(struct DoublyLinkedList *doubly_linked_list,
+                          struct DoublyLinkedListNode *prev,
+                          struct DoublyLinkedListNode *next,
+                          struct DoublyLinkedListNode *node)
+{
+    node->prev = prev;
+    node->next = next;
+
+    if (prev == NULL)
+    {
+        doubly_linked_list->head = node;
+    }
+    else
+    {
+        prev->next = node;
+    }
+
+    if (next == NULL)
+    {
+        doubly_linked_list->tail = node;
+    }
+    else
+    {
+        next->prev = node;
+    }
+
+    doubly_linked_list->size++;
+
+    return;
+}
+
+/**
+ * @brief Unlinks a node from a doubly linked list without freeing it.
+ * @param doubly_linked_list A pointer to the doubly linked list to unlink from.
+ * @param node A pointer to the node to unlink.
+ * @return void
+ */
+static void dll_unlink_node(struct DoublyLinkedList *doubly_linked_list,
+                            struct DoublyLinkedListNode *node)
+{
+    if (node->prev == NULL)
+    {
+        doubly_linked_list->head = node->next;
+    }
+    else
+    {
+        node->prev->next = node->next;
+    }
+
+    if (node->next == NULL)
+    {
+        doubly_linked_list->tail = node->prev;
+    }
+    else
+    {
+        node->next->prev = node->prev;
+    }
+
+    node->prev = NULL;
+    node->next = NULL;
+
+    doubly_linked_list->size--;
+
+    return;
+}
+
+/**
+ * @brief Creates a new doubly linked list.
+ * @param value_compare_function A function that compares two values in the list.
+ * @return A pointer to the created doubly linked list.
+ */
+struct DoublyLinkedList *dll_create(ValueCompareFunction value_compare_function)
+{
+    return dll_create_with_allocator(value_compare_function, NULL);
+}
+
+/**
+ * @brief Creates a new doubly linked list that allocates from an allocator.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created doubly linked list.
+ */
+struct DoublyLinkedList *
+dll_create_with_allocator(ValueCompareFunction value_compare_function,
+                          const struct Allocator *allocator)
+{
+    struct DoublyLinkedList *doubly_linked_list =
+        allocator_alloc(allocator, sizeof(struct DoublyLinkedList));
+    if (doubly_linked_list == NULL)
+    {
+        return NULL;
+    }
+
+    doubly_linked_list->size = 0;
+    doubly_linked_list->head = NULL;
+    doubly_linked_list->tail = NULL;
+    doubly_linked_list->value_compare_function = value_compare_function;
+    doubly_linked_list->node_pool = NULL;
+    doubly_linked_list->allocator = allocator;
+
+    return doubly_linked_list;
+}
+
+/**
+ * @brief Creates a new doubly linked list that allocates its nodes from a pool.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param node_pool A pointer to a pool of objects of
+ *                  sizeof(struct DoublyLinkedListNode) bytes. The pool may be shared
+ *                  by many lists and must outlive them.
+ * @return A pointer to the created doubly linked list.
+ *
+ * The list itself is allocated from the allocator of the pool.
+ */
+struct DoublyLinkedList *
+dll_create_with_pool(ValueCompareFunction value_compare_function,
+                     struct Pool *node_pool)
+{
+    struct DoublyLinkedList *doubly_linked_list =
+        dll_create_with_allocator(value_compare_function, node_pool->allocator);
+    if (doubly_linked_list == NULL)
+    {
+        return NULL;
+    }
+
+    doubly_linked_list->node_pool = node_pool;
+
+    return doubly_linked_list;
+}
+
+/**
+ * @brief Frees a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to free.
+ * @param value_free_function A function that frees a value in the list. Pass NULL
+ *                            if the values do not need to be freed.
+ * @return void
+ */
+void dll_free(struct DoublyLinkedList *doubly_linked_list,
+              ValueFreeFunction value_free_function)
+{
+    if (value_free_function == NULL &&
+        !allocator_frees_individually(doubly_linked_list->allocator))
+    {
+        return;
+    }
+
+    struct DoublyLinkedListNode *current_node = doubly_linked_list->head;
+
+    while (current_node != NULL)
+    {
+        struct DoublyLinkedListNode *next_node = current_node->next;
+        if (value_free_function != NULL)
+        {
+            value_free_function(current_node->value);
+        }
+
+        dll_free_node(doubly_linked_list, current_node);
+        current_node = next_node;
+    }
+
+    allocator_free(doubly_linked_list->allocator, doubly_linked_list,
+                   sizeof(struct DoublyLinkedList));
+
+    return;
+}
+
+/**
+ * @brief Gets a node from a doubly linked list by its value.
+ * @param doubly_linked_list A pointer to the doubly linked list to search.
+ * @param value A pointer to the value to search for.
+ * @return A pointer to the node with the value, or NULL if the value is not found.
+ */
+struct DoublyLinkedListNode *
+dll_get_node_by_value(struct DoublyLinkedList *doubly_linked_list, void *value)
+{
+    struct DoublyLinkedListNode *current_node = doubly_linked_list->head;
+
+    while (current_node != NULL)
+    {
+        if (doubly_linked_list->value_compare_function(current_node->value, value) ==
+            0)
+        {
+            return current_node;
+        }
+
+        current_node = current_node->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Pushes a value onto the tail of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dll_push(struct DoublyLinkedList *doubly_linked_list, void *value)
+{
+    struct DoublyLinkedListNode *new_node = dll_alloc_node(doubly_linked_list, value);
+    if (new_node == NULL)
+    {
+        return -1;
+    }
+
+    dll_link_node(doubly_linked_list, doubly_linked_list->tail, NULL, new_node);
+
+    return 0;
+}
+
+/**
+ * @brief Pushes a value onto the head of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int dll_push_front(struct DoublyLinkedList *doubly_linked_list, void *value)
+{
+    struct DoublyLinkedListNode *new_node = dll_alloc_node(doubly_linked_list, value);
+    if (new_node == NULL)
+    {
+        return -1;
+    }
+
+    dll_link_node(doubly_linked_list, NULL, doubly_linked_list->head, new_node);
+
+    return 0;
+}
+
+/**
+ * @brief Pops a value from the tail of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to pop from.
+ * @return A pointer to the popped value, or NULL if the list is empty.
+ */
+void *dll_pop(struct DoublyLinkedList *doubly_linked_list)
+{
+    struct DoublyLinkedListNode *popped_node = doubly_linked_list->tail;
+    if (popped_node == NULL)
+    {
+        return NULL;
+    }
+
+    void *value = popped_node->value;
+
+    dll_unlink_node(doubly_linked_list, popped_node);
+    dll_free_node(doubly_linked_list, popped_node);
+
+    return value;
+}
+
+/**
+ * @brief Pops a value from the head of a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to pop from.
+ * @return A pointer to the popped value, or NULL if the list is empty.
+ */
+void *dll_pop_front(struct DoublyLinkedList *doubly_linked_list)
+{
+    struct DoublyLinkedListNode *popped_node = doubly_linked_list->head;
+    if (popped_node == NULL)
+    {
+        return NULL;
+    }
+
+    void *value = popped_node->value;
+
+    dll_unlink_node(doubly_linked_list, popped_node);
+    dll_free_node(doubly_linked_list, popped_node);
+
+    return value;
+}
+
+/**
+ * @brief Inserts a value before a node in a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to insert into.
+ * @param node A pointer to the node to insert before.
+ * @param value A pointer to the value to insert.
+ * @return 0 if the value was inserted successfully, -1 otherwise.
+ */
+int dll_insert_before_node(struct DoublyLinkedList *doubly_linked_list,
+                           struct DoublyLinkedListNode *node, void *value)
+{
+    struct DoublyLinkedListNode *new_node = dll_alloc_node(doubly_linked_list, value);
+    if (new_node == NULL)
+    {
+        return -1;
+    }
+
+    dll_link_node(doubly_linked_list, node->prev, node, new_node);
+
+    return 0;
+}
+
+/**
+ * @brief Inserts a value after a node in a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to insert into.
+ * @param node A pointer to the node to insert after.
+ * @param value A pointer to the value to insert.
+ * @return 0 if the value was inserted successfully, -1 otherwise.
+ */
+int dll_insert_after_node(struct DoublyLinkedList *doubly_linked_list,
+                          struct DoublyLinkedListNode *node, void *value)
+{
+    struct DoublyLinkedListNode *new_node = dll_alloc_node(doubly_linked_list, value);
+    if (new_node == NULL)
+    {
+        return -1;
+    }
+
+    dll_link_node(doubly_linked_list, node, node->next, new_node);
+
+    return 0;
+}
+
+/**
+ * @brief Moves a node of a doubly linked list to its head.
+ * @param doubly_linked_list A pointer to the doubly linked list to move in.
+ * @param node A pointer to the node to move.
+ * @return void
+ *
+ * The node is relinked rather than reallocated, so pointers to it stay valid. This
+ * is the touch operation of an LRU list.
+ */
+void dll_move_to_front(struct DoublyLinkedList *doubly_linked_list,
+                       struct DoublyLinkedListNode *node)
+{
+    if (node == doubly_linked_list->head)
+    {
+        return;
+    }
+
+    dll_unlink_node(doubly_linked_list, node);
+    dll_link_node(doubly_linked_list, NULL, doubly_linked_list->head, node);
+
+    return;
+}
+
+/**
+ * @brief Removes a node from a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to remove from.
+ * @param node A pointer to the node to remove.
+ * @return void
+ */
+void dll_remove_node(struct DoublyLinkedList *doubly_linked_list,
+                     struct DoublyLinkedListNode *node)
+{
+    dll_unlink_node(doubly_linked_list, node);
+    dll_free_node(doubly_linked_list, node);
+
+    return;
+}
+
+/**
+ * @brief Removes the first occurrence of a value from a doubly linked list.
+ * @param doubly_linked_list A pointer to the doubly linked list to remove from.
+ * @param value A pointer to the value to remove.
+ * @return 0 if the value was removed successfully, -1 otherwise.
+ */
+int dll_remove_value(struct DoublyLinkedList *doubly_linked_list, void *value)
+{
+    struct DoublyLinkedListNode *node =
+        dll_get_node_by_value(doubly_linked_list, value);
+    if (node == NULL)
+    {
+        return -1;
+    }
+
+    dll_remove_node(doubly_linked_list, node);
+
+    return 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * @brief Epoch based reclamation of memory that lock-free readers may still see.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "lib/epoch.h"
+
+/**
+ * @brief The global epoch. Readers announce it, and reclamation advances it.
+ */
+static atomic_uint_fast64_t epoch_global = 0;
+
+/**
+ * @brief The records of every thread that ever entered a critical section.
+ */
+static _Atomic(struct EpochRecord *) epoch_records = NULL;
+
+/**
+ * @brief The lock guarding the retired lists and advancing the epoch.
+ */
+static pthread_mutex_t epoch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief The memory retired in each of the last three epochs, indexed by epoch % 3.
+ */
+static struct EpochNode *epoch_retired[3];
+
+/**
+ * @brief The number of nodes in the retired lists.
+ */
+static size_t epoch_retired_count = 0;
+
+/**
+ * @brief The key whose destructor hands the record of an exiting thread back.
+ */
+static pthread_key_t epoch_record_key;
+
+/**
+ * @brief Makes sure epoch_record_key is only created once.
+ */
+static pthread_once_t epoch_record_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief The record of the calling thread, or NULL if it has none yet.
+ */
+static _Thread_local struct EpochRecord *epoch_record = NULL;
+
+/**
+ * @brief The number of critical sections the calling thread is nested in.
+ */
+static _Thread_local unsigned int epoch_nesting = 0;
+
+/**
+ * @brief Hands the record of an exiting thread back for reuse.
+ * @param record A pointer to the record of the exiting thread.
+ * @return void
+ */
+static void epoch_release_record(void *record)
+{
+    struct EpochRecord *released_record = record;
+
+    atomic_store_explicit(&released_record->state, 0, memory_order_release);
+    atomic_store_explicit(&released_record->in_use, 0, memory_order_release);
+
+    return;
+}
+
+/**
+ * @brief Creates the key whose destructor hands records back.
+ * @return void
+ */
+static void epoch_create_record_key(void)
+{
+    pthread_key_create(&epoch_record_key, epoch_release_record);
+
+    return;
+}
+
+/**
+ * @brief Gets a record for the calling thread.
+ * @return A pointer to the record, or NULL if allocating one failed.
+ *
+ * A record released by an exited thread is reused if there is one. Otherwise a new
+ * record is pushed onto epoch_records.
+ */
+static struct EpochRecord *epoch_acquire_record(void)
+{
+    pthread_once(&epoch_record_key_once, epoch_create_record_key);
+
+    struct EpochRecord *record = atomic_load(&epoch_records);
+
+    while (record != NULL)
+    {
+        int in_use = 0;
+
+        if (atomic_compare_exchange_strong(&record->in_use, &in_use, 1))
+        {
+            break;
+        }
+
+        record = record->next;
+    }
+
+    if (record == NULL)
+    {
+        record = malloc(sizeof(struct EpochRecord));
+        if (record == NULL)
+        {
+            return NULL;
+        }
+
+        atomic_init(&record->state, 0);
+        atomic_init(&record->in_use, 1);
+        record->next = atomic_load(&epoch_records);
+
+        while (!atomic_compare_exchange_weak(&epoch_records, &record->next, record))
+        {
+        }
+    }
+
+    pthread_setspecific(epoch_record_key, record);
+
+    return record;
+}
+
+/**
+ * @brief Frees a list of retired nodes.
+ * @param node A pointer to the first node of the list.
+ * @return void
+ */
+static void epoch_free_list(struct EpochNode *node)
+{
+    while (node != NULL)
+    {
+        struct EpochNode *next_node = node->next;
+
+        node->free_function(node, node->context);
+        node = next_node;
+    }
+
+    return;
+}
+
+/**
+ * @brief Advances the global epoch if every reader has caught up with it.
+ * @param reclaimed A pointer to set to the list of nodes that are now safe to free.
+ * @return 1 if the epoch was advanced, 0 if a reader is still in an older epoch.
+ *
+ * The caller holds epoch_lock. Memory retired in epoch e can only be seen by
+ * readers that announced e - 1 or e, so it is safe to free once the global epoch
+ * has moved on to e + 2, which is when its list is reused.
+ */
+static int epoch_try_advance(struct EpochNode **reclaimed)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint64_t epoch = atomic_load(&epoch_global);
+
+    for (struct EpochRecord *record = atomic_load(&epoch_records); record != NULL;
+         record = record->next)
+    {
+        uint64_t state = atomic_load(&record->state);
+
+        if ((state & 1) && (state >> 1) != epoch)
+        {
+            return 0;
+        }
+    }
+
+    epoch++;
+    atomic_store(&epoch_global, epoch);
+
+    struct EpochNode *node = epoch_retired[(epoch + 1) % 3];
+    *reclaimed = node;
+    epoch_retired[(epoch + 1) % 3] = NULL;
+
+    while (node != NULL)
+    {
+        epoch_retired_count--;
+        node = node->next;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Enters a read-side critical section on the calling thread.
+ * @return 0 if the critical section was entered, -1 if the thread has no record
+ *         and allocating one failed.
+ *
+ * Memory retired after this call is not freed until the matching epoch_exit.
+ * Critical sections may be nested. Entering is wait-free once the thread has a
+ * record.
+ */
+int epoch_enter(void)
+{
+    if (epoch_nesting > 0)
+    {
+        epoch_nesting++;
+
+        return 0;
+    }
+
+    if (epoch_record == NULL)
+    {
+        epoch_record = epoch_acquire_record();
+        if (epoch_record == NULL)
+        {
+            return -1;
+        }
+    }
+
+    uint64_t epoch = atomic_load_explicit(&epoch_global, memory_order_relaxed);
+
+    atomic_store_explicit(&epoch_record->state, (epoch << 1) | 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    epoch_nesting = 1;
+
+    return 0;
+}
+
+/**
+ * @brief Leaves a read-side critical section on the calling thread.
+ * @return void
+ */
+void epoch_exit(void)
+{
+    if (--epoch_nesting > 0)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&epoch_record->state, 0, memory_order_release);
+
+    return;
+}
+
+/**
+ * @brief Retires memory that has been unlinked from every shared structure.
+ * @param node A pointer to the node embedded in the memory to retire.
+ * @param free_function A function that frees the memory.
+ * @param context A context pointer to pass to free_function.
+ * @return void
+ *
+ * The memory is freed by whichever thread advances the epoch far enough that every
+ * reader that could have seen it has left its critical section.
+ */
+void epoch_retire(struct EpochNode *node, EpochFreeFunction free_function,
+                  void *context)
+{
+    struct EpochNode *reclaimed = NULL;
+
+    node->free_function = free_function;
+    node->context = context;
+
+    pthread_mutex_lock(&epoch_lock);
+
+    uint64_t epoch = atomic_load(&epoch_global);
+
+    node->next = epoch_retired[epoch % 3];
+    epoch_retired[epoch % 3] = node;
+    epoch_retired_count++;
+
+    if (epoch_retired_count >= EPOCH_RECLAIM_THRESHOLD)
+    {
+        epoch_try_advance(&reclaimed);
+    }
+
+    pthread_mutex_unlock(&epoch_lock);
+
+    epoch_free_list(reclaimed);
+
+    return;
+}
+
+/**
+ * @brief Waits until every memory retired so far has been freed.
+ * @return void
+ *
+ * The calling thread may not be inside a critical section.
+ */
+void epoch_synchronize(void)
+{
+    for (int advanced = 0; advanced < 3;)
+    {
+        struct EpochNode *reclaimed = NULL;
+
+        pthread_mutex_lock(&epoch_lock);
+        int result = epoch_try_advance(&reclaimed);
+        pthread_mutex_unlock(&epoch_lock);
+
+        if (result)
+        {
+            epoch_free_list(reclaimed);
+            advanced++;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+
+    return;
+}
@@ -0,0 +1,492 @@
+/**
+ * @brief A generic open addressing hashmap that stores its entries in one flat array.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+#include "lib/flatmap.h"
+#include "lib/hashmap.h"
+
+#if FM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define FM_CONTROL_EMPTY ((int8_t)-128)
+#define FM_CONTROL_DELETED ((int8_t)-2)
+#define FM_NOT_FOUND SIZE_MAX
+
+/**
+ * @brief Gets the number of entries a flat hashmap with a given capacity can hold.
+ * @param capacity The capacity of the hashmap in slots.
+ * @return The number of entries, which keeps the load factor at or below 7/8.
+ */
+static size_t fm_max_size(size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+/**
+ * @brief Gets the smallest valid capacity that can hold a number of entries.
+ * @param size The number of entries.
+ * @return A power of two capacity of at least FM_GROUP_WIDTH slots, or 0 if no
+ *         capacity that fits in a size_t can hold that many entries.
+ */
+static size_t fm_capacity_for_size(size_t size)
+{
+    size_t capacity = FM_GROUP_WIDTH;
+
+    while (fm_max_size(capacity) < size)
+    {
+        if (capacity > SIZE_MAX / 2)
+        {
+            return 0;
+        }
+
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+/**
+ * @brief Gets the tag stored in the control byte of a full slot.
+ * @param hash The hash of the key in the slot.
+ * @return The low 7 bits of the hash.
+ */
+static int8_t fm_tag(uint64_t hash)
+{
+    return (int8_t)(hash & 0x7F);
+}
+
+#if FM_USE_SSE2
+
+/**
+ * @brief Finds the slots in a group whose control byte equals a given value.
+ * @param group A pointer to the first control byte of the group.
+ * @param control The control byte to match.
+ * @return A bitmask with bit i set if slot i of the group matches.
+ *
+ * All 16 control bytes are compared with one instruction, and the sign bit of each
+ * comparison result is gathered into the mask with another.
+ */
+static uint32_t fm_group_match(const int8_t *group, int8_t control)
+{
+    __m128i bytes = _mm_loadu_si128((const __m128i *)group);
+
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(control)));
+}
+
+/**
+ * @brief Finds the slots in a group that are empty or deleted.
+ * @param group A pointer to the first control byte of the group.
+ * @return A bitmask with bit i set if slot i of the group is free.
+ *
+ * Free control bytes are exactly the negative ones, so their sign bits are the mask.
+ */
+static uint32_t fm_group_match_free(const int8_t *group)
+{
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+#else
+
+/**
+ * @brief Finds the slots in a group whose control byte equals a given value.
+ * @param group A pointer to the first control byte of the group.
+ * @param control The control byte to match.
+ * @return A bitmask with bit i set if slot i of the group matches.
+ */
+static uint32_t fm_group_match(const int8_t *group, int8_t control)
+{
+    uint32_t matches = 0;
+
+    for (size_t i = 0; i < FM_GROUP_WIDTH; i++)
+    {
+        if (group[i] == control)
+        {
+            matches |= (uint32_t)1 << i;
+        }
+    }
+
+    return matches;
+}
+
+/**
+ * @brief Finds the slots in a group that are empty or deleted.
+ * @param group A pointer to the first control byte of the group.
+ * @return A bitmask with bit i set if slot i of the group is free.
+ */
+static uint32_t fm_group_match_free(const int8_t *group)
+{
+    uint32_t matches = 0;
+
+    for (size_t i = 0; i < FM_GROUP_WIDTH; i++)
+    {
+        if (group[i] < 0)
+        {
+            matches |= (uint32_t)1 << i;
+        }
+    }
+
+    return matches;
+}
+
+#endif
+
+/**
+ * @brief Gets the size of the allocation holding the control bytes and slots.
+ * @param capacity The capacity of the hashmap in slots.
+ * @return The size of the allocation in bytes.
+ */
+static size_t fm_block_size(size_t capacity)
+{
+    return capacity + capacity * sizeof(struct HashMapEntry);
+}
+
+/**
+ * @brief Allocates the control bytes and slots of a flat hashmap.
+ * @param flatmap A pointer to the hashmap to allocate for.
+ * @param capacity The capacity of the hashmap in slots.
+ * @param control A pointer to where to store the control bytes.
+ * @param slots A pointer to where to store the slots.
+ * @return 0 if the allocation succeeded, -1 otherwise.
+ *
+ * The control bytes and slots share one allocation, which starts at the control
+ * bytes. Every control byte is set to empty.
+ */
+static int fm_allocate(struct FlatMap *flatmap, size_t capacity, int8_t **control,
+                       struct HashMapEntry **slots)
+{
+    int8_t *block = allocator_alloc(flatmap->allocator, fm_block_size(capacity));
+    if (block == NULL)
+    {
+        return -1;
+    }
+
+    memset(block, FM_CONTROL_EMPTY, capacity);
+
+    *control = block;
+    *slots = (struct HashMapEntry *)(block + capacity);
+
+    return 0;
+}
+
+/**
+ * @brief Finds the slot holding a key in a flat hashmap.
+ * @param flatmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @return The index of the slot holding the key, or FM_NOT_FOUND.
+ */
+static size_t fm_find(struct FlatMap *flatmap, void *key, uint64_t hash)
+{
+    size_t group_mask = flatmap->capacity / FM_GROUP_WIDTH - 1;
+    size_t group_index = (hash >> 7) & group_mask;
+    int8_t tag = fm_tag(hash);
+
+    for (size_t probe = 1;; probe++)
+    {
+        const int8_t *group = flatmap->control + group_index * FM_GROUP_WIDTH;
+        uint32_t matches = fm_group_match(group, tag);
+
+        while (matches != 0)
+        {
+            size_t slot_index = group_index * FM_GROUP_WIDTH + __builtin_ctz(matches);
+            struct HashMapEntry *slot = &flatmap->slots[slot_index];
+
+            if (slot->hash == hash &&
+                flatmap->key_compare_function(slot->key, key) == 0)
+            {
+                return slot_index;
+            }
+
+            matches &= matches - 1;
+        }
+
+        if (fm_group_match(group, FM_CONTROL_EMPTY) != 0)
+        {
+            return FM_NOT_FOUND;
+        }
+
+        group_index = (group_index + probe) & group_mask;
+    }
+}
+
+/**
+ * @brief Finds the first free slot on the probe sequence of a hash.
+ * @param flatmap A pointer to the hashmap to search.
+ * @param hash The hash to follow the probe sequence of.
+ * @return The index of the first empty or deleted slot.
+ *
+ * The hashmap always has at least one empty slot, so this always finds a slot.
+ */
+static size_t fm_find_free(struct FlatMap *flatmap, uint64_t hash)
+{
+    size_t group_mask = flatmap->capacity / FM_GROUP_WIDTH - 1;
+    size_t group_index = (hash >> 7) & group_mask;
+
+    for (size_t probe = 1;; probe++)
+    {
+        uint32_t matches =
+            fm_group_match_free(flatmap->control + group_index * FM_GROUP_WIDTH);
+
+        if (matches != 0)
+        {
+            return group_index * FM_GROUP_WIDTH + __builtin_ctz(matches);
+        }
+
+        group_index = (group_index + probe) & group_mask;
+    }
+}
+
+/**
+ * @brief Moves the entries of a flat hashmap into a new slot array.
+ * @param flatmap A pointer to the hashmap to rehash.
+ * @return 0 if the hashmap was rehashed successfully, -1 otherwise.
+ *
+ * The capacity is doubled if the hashmap is more than half full, otherwise it is
+ * kept and the rehash only clears deleted slots. The cached hashes are reused, so
+ * the hash function is never called.
+ */
+static int fm_rehash(struct FlatMap *flatmap)
+{
+    size_t old_capacity = flatmap->capacity;
+    int8_t *old_control = flatmap->control;
+    struct HashMapEntry *old_slots = flatmap->slots;
+
+    size_t new_capacity = old_capacity;
+    if (flatmap->size > fm_max_size(old_capacity) / 2)
+    {
+        if (old_capacity > SIZE_MAX / 2)
+        {
+            return -1;
+        }
+
+        new_capacity *= 2;
+    }
+
+    if (fm_allocate(flatmap, new_capacity, &flatmap->control, &flatmap->slots) != 0)
+    {
+        flatmap->control = old_control;
+        flatmap->slots = old_slots;
+
+        return -1;
+    }
+
+    flatmap->capacity = new_capacity;
+    flatmap->growth_left = fm_max_size(new_capacity) - flatmap->size;
+
+    for (size_t i = 0; i < old_capacity; i++)
+    {
+        if (old_control[i] < 0)
+        {
+            continue;
+        }
+
+        size_t slot_index = fm_find_free(flatmap, old_slots[i].hash);
+
+        flatmap->control[slot_index] = old_control[i];
+        flatmap->slots[slot_index] = old_slots[i];
+    }
+
+    allocator_free(flatmap->allocator, old_control, fm_block_size(old_capacity));
+
+    return 0;
+}
+
+/**
+ * @brief Creates a new flat hashmap.
+ * @param capacity The number of entries the hashmap should hold without growing.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @return A pointer to the created hashmap, or NULL if no capacity that fits in a
+ *         size_t can hold that many entries or an allocation failed.
+ */
+struct FlatMap *fm_create(size_t capacity, HashMapHashFunction hash_function,
+                          HashMapKeyCompareFunction key_compare_function)
+{
+    return fm_create_with_allocator(capacity, hash_function, key_compare_function,
+                                    NULL);
+}
+
+/**
+ * @brief Creates a new flat hashmap that allocates from an allocator.
+ * @param capacity The number of entries the hashmap should hold without growing.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created hashmap, or NULL if no capacity that fits in a
+ *         size_t can hold that many entries or an allocation failed.
+ */
+struct FlatMap *fm_create_with_allocator(size_t capacity,
+                                         HashMapHashFunction hash_function,
+                                         HashMapKeyCompareFunction key_compare_function,
+                                         const struct Allocator *allocator)
+{
+    size_t slot_capacity = fm_capacity_for_size(capacity);
+    if (slot_capacity == 0)
+    {
+        return NULL;
+    }
+
+    struct FlatMap *flatmap = allocator_alloc(allocator, sizeof(struct FlatMap));
+    if (flatmap == NULL)
+    {
+        return NULL;
+    }
+
+    flatmap->capacity = slot_capacity;
+    flatmap->size = 0;
+    flatmap->growth_left = fm_max_size(flatmap->capacity);
+    flatmap->hash_function = hash_function;
+    flatmap->key_compare_function = key_compare_function;
+    flatmap->allocator = allocator;
+
+    if (fm_allocate(flatmap, flatmap->capacity, &flatmap->control,
+                    &flatmap->slots) != 0)
+    {
+        allocator_free(allocator, flatmap, sizeof(struct FlatMap));
+
+        return NULL;
+    }
+
+    return flatmap;
+}
+
+/**
+ * @brief Frees a flat hashmap.
+ * @param flatmap A pointer to the hashmap to free.
+ * @param entry_free_function A function that frees an entry in the hashmap.
+ *                            Pass NULL if the entries do not need to be freed.
+ * @return void
+ */
+void fm_free(struct FlatMap *flatmap, HashMapEntryFreeFunction entry_free_function)
+{
+    if (entry_free_function == NULL &&
+        !allocator_frees_individually(flatmap->allocator))
+    {
+        return;
+    }
+
+    if (entry_free_function != NULL)
+    {
+        for (size_t i = 0; i < flatmap->capacity; i++)
+        {
+            if (flatmap->control[i] < 0)
+            {
+                continue;
+            }
+
+            entry_free_function(&flatmap->slots[i]);
+        }
+    }
+
+    allocator_free(flatmap->allocator, flatmap->control,
+                   fm_block_size(flatmap->capacity));
+    allocator_free(flatmap->allocator, flatmap, sizeof(struct FlatMap));
+
+    return;
+}
+
+/**
+ * @brief Sets a key-value pair in a flat hashmap.
+ * @param flatmap A pointer to the hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ */
+int fm_set(struct FlatMap *flatmap, void *key, void *value)
+{
+    uint64_t hash = flatmap->hash_function(key);
+
+    size_t slot_index = fm_find(flatmap, key, hash);
+    if (slot_index != FM_NOT_FOUND)
+    {
+        flatmap->slots[slot_index].key = key;
+        flatmap->slots[slot_index].value = value;
+
+        return 0;
+    }
+
+    slot_index = fm_find_free(flatmap, hash);
+
+    if (flatmap->growth_left == 0 && flatmap->control[slot_index] == FM_CONTROL_EMPTY)
+    {
+        if (fm_rehash(flatmap) != 0)
+        {
+            return -1;
+        }
+
+        slot_index = fm_find_free(flatmap, hash);
+    }
+
+    if (flatmap->control[slot_index] == FM_CONTROL_EMPTY)
+    {
+        flatmap->growth_left--;
+    }
+
+    flatmap->control[slot_index] = fm_tag(hash);
+    flatmap->slots[slot_index].key = key;
+    flatmap->slots[slot_index].value = value;
+    flatmap->slots[slot_index].hash = hash;
+    flatmap->size++;
+
+    return 0;
+}
+
+/**
+ * @brief Gets a value from a flat hashmap.
+ * @param flatmap A pointer to the hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ */
+void *fm_get(struct FlatMap *flatmap, void *key)
+{
+    size_t slot_index = fm_find(flatmap, key, flatmap->hash_function(key));
+    if (slot_index == FM_NOT_FOUND)
+    {
+        return NULL;
+    }
+
+    return flatmap->slots[slot_index].value;
+}
+
+/**
+ * @brief Removes a key-value pair from a flat hashmap.
+ * @param flatmap A pointer to the hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ *
+ * A slot in a group that still has an empty slot is marked empty, since no probe
+ * sequence can have passed through that group. Otherwise it is marked deleted so
+ * that lookups keep probing past it.
+ */
+void *fm_remove(struct FlatMap *flatmap, void *key)
+{
+    size_t slot_index = fm_find(flatmap, key, flatmap->hash_function(key));
+    if (slot_index == FM_NOT_FOUND)
+    {
+        return NULL;
+    }
+
+    void *value = flatmap->slots[slot_index].value;
+    size_t group_index = slot_index / FM_GROUP_WIDTH;
+    const int8_t *group = flatmap->control + group_index * FM_GROUP_WIDTH;
+
+    if (fm_group_match(group, FM_CONTROL_EMPTY) != 0)
+    {
+        flatmap->control[slot_index] = FM_CONTROL_EMPTY;
+        flatmap->growth_left++;
+    }
+    else
+    {
+        flatmap->control[slot_index] = FM_CONTROL_DELETED;
+    }
+
+    flatmap->size--;
+
+    return value;
+}
@@ -3,169 +3,384 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "lib/allocator.h"
 #include "lib/hashmap.h"
 #include "lib/list.h"
+#include "lib/pool.h"
 
 /**
- * @brief Creates a new hashmap.
- * @param capacity The capacity of the hashmap.
- * @param hash_function A function that hashes a key to an index in the hashmap.
- * @param key_compare_function A function that compares two keys in the hashmap.
- * @return A pointer to the created hashmap.
+ * @brief The secret constants mixed into every hash by the built-in hash functions.
  */
-struct HashMap *hm_create(size_t capacity, HashMapHashFunction hash_function,
-                          HashMapKeyCompareFunction key_compare_function)
+static const uint64_t hm_hash_secret[4] = {
+    0x2d358dccaa6c78a5ULL,
+    0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL,
+};
+
+/**
+ * @brief The seed used by the built-in hash functions, set with hm_set_hash_seed.
+ */
+static uint64_t hm_hash_seed = 0x9e3779b97f4a7c15ULL;
+
+/**
+ * @brief Frees a bucket without freeing its nodes.
+ * @param hashmap A pointer to the hashmap the bucket belongs to.
+ * @param bucket A pointer to the bucket to free.
+ * @return void
+ *
+ * The nodes of a bucket belong to the node pool of its hashmap, so they are either
+ * relinked into another bucket or released together with the pool.
+ */
+static void hm_free_bucket(struct HashMap *hashmap, HashMapBucket *bucket)
 {
-    struct HashMap *hashmap = malloc(sizeof(struct HashMap));
-    if (hashmap == NULL)
-    {
-        return NULL;
-    }
+    pool_release(hashmap->bucket_pool, bucket);
 
-    hashmap->capacity = capacity;
-    hashmap->hash_function = hash_function;
-    hashmap->key_compare_function = key_compare_function;
-    hashmap->buckets = malloc(capacity * sizeof(HashMapBucket));
-    if (hashmap->buckets == NULL)
-    {
-        free(hashmap);
+    return;
+}
 
+/**
+ * @brief Creates an array of empty buckets.
+ * @param hashmap A pointer to the hashmap the buckets are for.
+ * @param capacity The number of buckets to create.
+ * @return A pointer to the created bucket array, or NULL if the allocation failed.
+ *
+ * Every bucket starts out as NULL and is only created by hm_get_or_create_bucket
+ * when the first entry is added to it, so creating a bucket array is a single
+ * allocation no matter its capacity.
+ */
+static HashMapBucket **hm_create_buckets(struct HashMap *hashmap, size_t capacity)
+{
+    HashMapBucket **buckets =
+        allocator_alloc(hashmap->allocator, capacity * sizeof(HashMapBucket *));
+    if (buckets == NULL)
+    {
         return NULL;
     }
 
     for (size_t i = 0; i < capacity; i++)
     {
-        hashmap->buckets[i] = ll_create(NULL);
-        if (hashmap->buckets[i] == NULL)
-        {
-            for (size_t j = 0; j < i; j++)
-            {
-                ll_free(hashmap->buckets[j], free);
-            }
+        buckets[i] = NULL;
+    }
 
-            free(hashmap->buckets);
-            free(hashmap);
+    return buckets;
+}
 
+/**
+ * @brief Gets a bucket of a hashmap, creating it if it does not exist yet.
+ * @param hashmap A pointer to the hashmap.
+ * @param index The index of the bucket.
+ * @return A pointer to the bucket, or NULL if creating it failed.
+ *
+ * Buckets are allocated from the bucket pool of the hashmap, and are empty linked
+ * lists whose nodes come from its node pool.
+ */
+static HashMapBucket *hm_get_or_create_bucket(struct HashMap *hashmap, size_t index)
+{
+    if (hashmap->buckets[index] == NULL)
+    {
+        HashMapBucket *bucket = pool_alloc(hashmap->bucket_pool);
+        if (bucket == NULL)
+        {
             return NULL;
         }
+
+        bucket->size = 0;
+        bucket->head = NULL;
+        bucket->tail = NULL;
+        bucket->value_compare_function = NULL;
+        bucket->node_pool = hashmap->node_pool;
+        bucket->allocator = hashmap->allocator;
+
+        hashmap->buckets[index] = bucket;
     }
 
-    return hashmap;
+    return hashmap->buckets[index];
 }
 
 /**
- * @brief Frees a hashmap.
- * @param hashmap A pointer to the hashmap to free.
- * @param entry_free_function A function that frees an entry in the hashmap.
- *                            Pass NULL if the entries do not need to be freed.
+ * @brief Frees the entries of a bucket without freeing the bucket.
+ * @param bucket A pointer to the bucket whose entries to free.
+ * @param entry_free_function A function that frees an entry in the bucket.
  * @return void
  */
-void hm_free(struct HashMap *hashmap, HashMapEntryFreeFunction entry_free_function)
+static void hm_free_bucket_entries(HashMapBucket *bucket,
+                                   HashMapEntryFreeFunction entry_free_function)
 {
-    for (size_t i = 0; i < hashmap->capacity; i++)
+    struct LinkedListNode *current_node = bucket->head;
+
+    while (current_node != NULL)
     {
+        entry_free_function(current_node->value);
+        current_node = current_node->next;
+    }
 
-        if (entry_free_function != NULL)
+    return;
+}
+
+/**
+ * @brief Frees an array of buckets.
+ * @param hashmap A pointer to the hashmap the buckets belong to.
+ * @param buckets A pointer to the bucket array to free.
+ * @param capacity The number of buckets in the array.
+ * @param occupied A pointer to the occupancy bitmap of the buckets, or NULL if they
+ *                 do not have one.
+ * @param entry_free_function A function that frees an entry in the buckets.
+ *                            Pass NULL if the entries do not need to be freed.
+ * @return void
+ *
+ * The buckets themselves, their nodes and their entries are released together with
+ * the pools of the hashmap, so only the entries have to be visited, and only if
+ * they need to be freed. With an occupancy bitmap, only the buckets whose bits are
+ * set are walked, so freeing a sparse hashmap takes time proportional to the
+ * number of buckets holding entries rather than to its capacity. Buckets that are
+ * NULL were never created or have already been migrated and freed, and are skipped.
+ */
+static void hm_free_buckets(struct HashMap *hashmap, HashMapBucket **buckets,
+                            size_t capacity, const uint64_t *occupied,
+                            HashMapEntryFreeFunction entry_free_function)
+{
+    if (entry_free_function != NULL && occupied != NULL)
+    {
+        for (size_t word_index = 0; word_index < HM_OCCUPIED_WORDS(capacity);
+             word_index++)
         {
-            struct LinkedListNode *current_node = hashmap->buckets[i]->head;
+            uint64_t word = occupied[word_index];
 
-            while (current_node != NULL)
+            while (word != 0)
             {
-                struct LinkedListNode *next_node = current_node->next;
-                struct HashMapEntry *current_hashmap_node = current_node->value;
+                size_t index = word_index * 64 + __builtin_ctzll(word);
 
-                if (entry_free_function != NULL)
-                {
-                    entry_free_function(current_hashmap_node);
-                }
-
-                free(current_node);
-                current_node = next_node;
+                hm_free_bucket_entries(buckets[index], entry_free_function);
+                word &= word - 1;
             }
         }
-        else
+    }
+    else if (entry_free_function != NULL)
+    {
+        for (size_t i = 0; i < capacity; i++)
         {
-            ll_free(hashmap->buckets[i], free);
+            if (buckets[i] != NULL)
+            {
+                hm_free_bucket_entries(buckets[i], entry_free_function);
+            }
         }
     }
 
-    free(hashmap->buckets);
-    free(hashmap);
+    allocator_free(hashmap->allocator, buckets, capacity * sizeof(HashMapBucket *));
 
     return;
 }
 
 /**
- * @brief Sets a key-value pair in a hashmap.
- * @param hashmap A pointer to the hashmap to set in.
- * @param key A pointer to the key to set.
- * @param value A pointer to the value to set.
- * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ * @brief Creates an empty occupancy bitmap for an array of buckets.
+ * @param hashmap A pointer to the hashmap the bitmap is for.
+ * @param capacity The number of buckets the bitmap covers.
+ * @return A pointer to the created bitmap, or NULL if the allocation failed.
  */
-int hm_set(struct HashMap *hashmap, void *key, void *value)
+static uint64_t *hm_create_occupied(struct HashMap *hashmap, size_t capacity)
 {
-    size_t index = hashmap->hash_function(hashmap, key);
+    size_t size = HM_OCCUPIED_WORDS(capacity) * sizeof(uint64_t);
 
-    struct HashMapEntry *node_value = malloc(sizeof(struct HashMapEntry));
-    if (node_value == NULL)
+    uint64_t *occupied = allocator_alloc(hashmap->allocator, size);
+    if (occupied == NULL)
     {
-        return -1;
+        return NULL;
     }
 
-    node_value->key = key;
-    node_value->value = value;
+    memset(occupied, 0, size);
 
-    struct LinkedListNode *existing_node_with_key = NULL;
-    struct LinkedListNode *current_node = hashmap->buckets[index]->head;
+    return occupied;
+}
 
-    while (current_node != NULL)
+/**
+ * @brief Marks a bucket of a hashmap as holding at least one entry.
+ * @param hashmap A pointer to the hashmap.
+ * @param index The index of the bucket.
+ * @return void
+ */
+static void hm_set_occupied(struct HashMap *hashmap, size_t index)
+{
+    hashmap->occupied[index / 64] |= (uint64_t)1 << (index % 64);
+
+    return;
+}
+
+/**
+ * @brief Marks a bucket of a hashmap as empty.
+ * @param hashmap A pointer to the hashmap.
+ * @param index The index of the bucket.
+ * @return void
+ */
+static void hm_clear_occupied(struct HashMap *hashmap, size_t index)
+{
+    hashmap->occupied[index / 64] &= ~((uint64_t)1 << (index % 64));
+
+    return;
+}
+
+/**
+ * @brief Checks if a bucket of a hashmap holds at least one entry.
+ * @param hashmap A pointer to the hashmap.
+ * @param index The index of the bucket.
+ * @return 1 if the bucket holds an entry, 0 otherwise.
+ */
+static int hm_is_occupied(struct HashMap *hashmap, size_t index)
+{
+    return (hashmap->occupied[index / 64] >> (index % 64)) & 1;
+}
+
+/**
+ * @brief Finds the next bucket of a hashmap that holds at least one entry.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param index The index of the first bucket to look at.
+ * @return The index of the bucket, or the capacity of the hashmap if there is none.
+ */
+static size_t hm_next_occupied(struct HashMap *hashmap, size_t index)
+{
+    size_t words = HM_OCCUPIED_WORDS(hashmap->capacity);
+    size_t word_index = index / 64;
+
+    if (word_index >= words)
     {
-        struct HashMapEntry *current_hashmap_node = current_node->value;
+        return hashmap->capacity;
+    }
+
+    uint64_t word = hashmap->occupied[word_index] & (~(uint64_t)0 << (index % 64));
 
-        if (hashmap->key_compare_function(current_hashmap_node->key, key) == 0)
+    while (word == 0)
+    {
+        word_index++;
+
+        if (word_index == words)
         {
-            existing_node_with_key = current_node;
-            break;
+            return hashmap->capacity;
         }
 
-        current_node = current_node->next;
+        word = hashmap->occupied[word_index];
     }
 
-    if (existing_node_with_key == NULL)
+    return word_index * 64 + __builtin_ctzll(word);
+}
+
+/**
+ * @brief Rounds a capacity up to the next power of two.
+ * @param capacity The capacity to round up.
+ * @return The smallest power of two that is at least capacity, and at least 1, or 0
+ *         if that power of two does not fit in a size_t.
+ */
+static size_t hm_round_capacity(size_t capacity)
+{
+    size_t rounded_capacity = 1;
+
+    while (rounded_capacity < capacity)
     {
-        ll_push(hashmap->buckets[index], node_value);
+        if (rounded_capacity > SIZE_MAX / 2)
+        {
+            return 0;
+        }
+
+        rounded_capacity *= 2;
     }
-    else
+
+    return rounded_capacity;
+}
+
+/**
+ * @brief Gets the histogram bin that a length is counted in.
+ * @param length The length to count.
+ * @return The index of the bin, clamped to the last bin.
+ */
+static inline size_t hm_stats_bin(size_t length)
+{
+    if (length >= HM_STATS_HISTOGRAM_SIZE)
     {
-        existing_node_with_key->value = node_value;
+        return HM_STATS_HISTOGRAM_SIZE - 1;
     }
 
-    return 0;
+    return length;
 }
 
 /**
- * @brief Gets a value from a hashmap.
- * @param hashmap A pointer to the hashmap to get from.
- * @param key A pointer to the key to get.
- * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ * @brief Records a lookup in the statistics of a hashmap.
+ * @param hashmap A pointer to the hashmap the lookup was made in.
+ * @param probes The number of entries looked at.
+ * @param hit 1 if the key was found, 0 otherwise.
+ * @return void
+ *
+ * This does nothing unless HM_STATS is enabled, and compiles away entirely then.
  */
-void *hm_get(struct HashMap *hashmap, void *key)
+static inline void hm_record_lookup(struct HashMap *hashmap, size_t probes, int hit)
+{
+#if HM_STATS
+    hashmap->stats.lookups++;
+    hashmap->stats.hits += hit;
+    hashmap->stats.probes += probes;
+    hashmap->stats.probe_histogram[hm_stats_bin(probes)]++;
+#else
+    (void)hashmap;
+    (void)probes;
+    (void)hit;
+#endif
+
+    return;
+}
+
+/**
+ * @brief Records that a hashmap grew in the statistics of the hashmap.
+ * @param hashmap A pointer to the hashmap that grew.
+ * @return void
+ *
+ * This does nothing unless HM_STATS is enabled, and compiles away entirely then.
+ */
+static inline void hm_record_resize(struct HashMap *hashmap)
+{
+#if HM_STATS
+    hashmap->stats.resizes++;
+#else
+    (void)hashmap;
+#endif
+
+    return;
+}
+
+/**
+ * @brief Finds the node holding a key in a bucket.
+ * @param hashmap A pointer to the hashmap the bucket belongs to.
+ * @param bucket A pointer to the bucket to search.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @param probes A pointer to a count that is increased by every entry looked at.
+ * @return A pointer to the node holding the key, or NULL if it is not in the bucket.
+ *
+ * The key compare function is only called for entries with the same cached hash.
+ */
+static struct LinkedListNode *hm_find_in_bucket(struct HashMap *hashmap,
+                                                HashMapBucket *bucket, void *key,
+                                                uint64_t hash, size_t *probes)
 {
-    size_t index = hashmap->hash_function(hashmap, key);
+    if (bucket == NULL)
+    {
+        return NULL;
+    }
 
-    HashMapBucket *bucket = hashmap->buckets[index];
     struct LinkedListNode *current_node = bucket->head;
 
     while (current_node != NULL)
     {
         struct HashMapEntry *current_hashmap_node = current_node->value;
 
-        if (hashmap->key_compare_function(current_hashmap_node->key, key) == 0)
+        (*probes)++;
+
+        if (current_hashmap_node->hash == hash &&
+            hashmap->key_compare_function(current_hashmap_node->key, key) == 0)
         {
-            return current_hashmap_node->value;
+            return current_node;
         }
 
         current_node = current_node->next;
@@ -175,34 +390,1574 @@ void *hm_get(struct HashMap *hashmap, void *key)
 }
 
 /**
- * @brief Removes a key-value pair from a hashmap.
- * @param hashmap A pointer to the hashmap to remove from.
- * @param key A pointer to the key to remove.
- * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ * @brief Finds the node holding a key in a hashmap.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @param bucket A pointer to where to store the bucket the key was found in.
+ * @return A pointer to the node holding the key, or NULL if it is not in the hashmap.
+ *
+ * While the hashmap is rehashing, a key whose old bucket has not been migrated yet
+ * may still live in the old bucket, so that bucket is searched first.
  */
-void *hm_remove(struct HashMap *hashmap, void *key)
+static struct LinkedListNode *hm_find(struct HashMap *hashmap, void *key,
+                                      uint64_t hash, HashMapBucket **bucket)
 {
-    size_t index = hashmap->hash_function(hashmap, key);
+    struct LinkedListNode *node = NULL;
+    size_t probes = 0;
 
-    HashMapBucket *bucket = hashmap->buckets[index];
-    struct LinkedListNode *current_node = bucket->head;
+    if (hashmap->old_buckets != NULL)
+    {
+        size_t old_index = hash & (hashmap->old_capacity - 1);
 
-    while (current_node != NULL)
+        if (old_index >= hashmap->rehash_index)
+        {
+            node = hm_find_in_bucket(hashmap, hashmap->old_buckets[old_index], key,
+                                     hash, &probes);
+            *bucket = hashmap->old_buckets[old_index];
+        }
+    }
+
+    if (node == NULL)
+    {
+        *bucket = hashmap->buckets[hash & (hashmap->capacity - 1)];
+        node = hm_find_in_bucket(hashmap, *bucket, key, hash, &probes);
+    }
+
+    hm_record_lookup(hashmap, probes, node != NULL);
+
+    return node;
+}
+
+/**
+ * @brief Moves the entries of an old bucket of a rehashing hashmap into its buckets.
+ * @param hashmap A pointer to the rehashing hashmap.
+ * @param old_index The index of the old bucket to migrate.
+ * @return 0 if the old bucket was migrated, -1 if creating a new bucket failed, in
+ *         which case the old bucket is left untouched.
+ *
+ * The entries of old bucket i can only move to buckets i and i + old_capacity, and
+ * the ones they need are created before any node is moved, so a failed migration
+ * moves nothing. The nodes are relinked using their cached hashes, so migrating
+ * never calls the hash function. The old bucket is freed and set to NULL, which
+ * hm_find skips, so old buckets can be migrated in any order.
+ */
+static int hm_migrate_bucket(struct HashMap *hashmap, size_t old_index)
+{
+    HashMapBucket *old_bucket = hashmap->old_buckets[old_index];
+
+    if (old_bucket == NULL)
+    {
+        return 0;
+    }
+
+    for (struct LinkedListNode *current_node = old_bucket->head; current_node != NULL;
+         current_node = current_node->next)
     {
         struct HashMapEntry *current_hashmap_node = current_node->value;
+        size_t index = current_hashmap_node->hash & (hashmap->capacity - 1);
 
-        if (hashmap->key_compare_function(current_hashmap_node->key, key) == 0)
+        if (hm_get_or_create_bucket(hashmap, index) == NULL)
         {
-            void *value = current_hashmap_node->value;
+            return -1;
+        }
+    }
 
-            free(current_hashmap_node);
-            ll_remove_node(bucket, current_node);
+    while (old_bucket->head != NULL)
+    {
+        struct LinkedListNode *current_node = old_bucket->head;
+        struct HashMapEntry *current_hashmap_node = current_node->value;
+
+        size_t index = current_hashmap_node->hash & (hashmap->capacity - 1);
+        HashMapBucket *bucket = hashmap->buckets[index];
+
+        old_bucket->head = current_node->next;
+        current_node->next = NULL;
 
-            return value;
+        if (bucket->size == 0)
+        {
+            bucket->head = current_node;
+        }
+        else
+        {
+            bucket->tail->next = current_node;
         }
 
-        current_node = current_node->next;
+        bucket->tail = current_node;
+        bucket->size++;
+        hm_set_occupied(hashmap, index);
+    }
+
+    hm_free_bucket(hashmap, old_bucket);
+
+    hashmap->old_buckets[old_index] = NULL;
+
+    return 0;
+}
+
+/**
+ * @brief Migrates up to HM_REHASH_STEP old buckets of a rehashing hashmap.
+ * @param hashmap A pointer to the hashmap to migrate.
+ * @return 0 if the buckets were migrated, -1 if creating a new bucket failed.
+ *
+ * Old buckets are migrated in order, starting at rehash_index. If migrating one
+ * fails, it stays where it is, hm_find still looks there, and a later call tries
+ * again. Once every old bucket has been migrated, the old bucket array is freed.
+ */
+static int hm_rehash_step(struct HashMap *hashmap)
+{
+    if (hashmap->old_buckets == NULL)
+    {
+        return 0;
+    }
+
+    for (size_t step = 0;
+         step < HM_REHASH_STEP && hashmap->rehash_index < hashmap->old_capacity; step++)
+    {
+        if (hm_migrate_bucket(hashmap, hashmap->rehash_index) != 0)
+        {
+            return -1;
+        }
+
+        hashmap->rehash_index++;
+    }
+
+    if (hashmap->rehash_index == hashmap->old_capacity)
+    {
+        allocator_free(hashmap->allocator, hashmap->old_buckets,
+                       hashmap->old_capacity * sizeof(HashMapBucket *));
+
+        hashmap->old_buckets = NULL;
+        hashmap->old_capacity = 0;
+        hashmap->rehash_index = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Starts growing a hashmap if its load factor exceeds HM_MAX_LOAD_PERCENT.
+ * @param hashmap A pointer to the hashmap to grow.
+ * @return void
+ *
+ * Only the new bucket array is allocated here. The entries are migrated by later
+ * calls to hm_rehash_step. If the allocation fails the hashmap keeps its capacity.
+ */
+static void hm_maybe_grow(struct HashMap *hashmap)
+{
+    if (hashmap->old_buckets != NULL ||
+        hashmap->size * 100 <= hashmap->capacity * HM_MAX_LOAD_PERCENT)
+    {
+        return;
+    }
+
+    HashMapBucket **buckets = hm_create_buckets(hashmap, hashmap->capacity * 2);
+    if (buckets == NULL)
+    {
+        return;
+    }
+
+    uint64_t *occupied = hm_create_occupied(hashmap, hashmap->capacity * 2);
+    if (occupied == NULL)
+    {
+        hm_free_buckets(hashmap, buckets, hashmap->capacity * 2, NULL, NULL);
+
+        return;
+    }
+
+    allocator_free(hashmap->allocator, hashmap->occupied,
+                   HM_OCCUPIED_WORDS(hashmap->capacity) * sizeof(uint64_t));
+
+    hashmap->occupied = occupied;
+    hashmap->old_buckets = hashmap->buckets;
+    hashmap->old_capacity = hashmap->capacity;
+    hashmap->rehash_index = 0;
+    hashmap->buckets = buckets;
+    hashmap->capacity *= 2;
+
+    hm_record_resize(hashmap);
+
+    return;
+}
+
+/**
+ * @brief Checks if a hashmap keeps its entries inline instead of in buckets.
+ * @param hashmap A pointer to the hashmap to check.
+ * @return 1 if the hashmap is in small mode, 0 otherwise.
+ */
+static int hm_is_small(struct HashMap *hashmap)
+{
+    return hashmap->is_small;
+}
+
+/**
+ * @brief Finds the inline entry holding a key in a small hashmap.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @return A pointer to the entry holding the key, or NULL if it is not in the hashmap.
+ *
+ * The key compare function is only called for entries with the same cached hash.
+ */
+static struct HashMapEntry *hm_small_find(struct HashMap *hashmap, void *key,
+                                          uint64_t hash)
+{
+    for (size_t i = 0; i < hashmap->size; i++)
+    {
+        struct HashMapEntry *entry = &hashmap->small_entries[i];
+
+        if (entry->hash == hash && hashmap->key_compare_function(entry->key, key) == 0)
+        {
+            hm_record_lookup(hashmap, i + 1, 1);
+
+            return entry;
+        }
     }
 
+    hm_record_lookup(hashmap, hashmap->size, 0);
+
     return NULL;
 }
+
+/**
+ * @brief Frees the pools, buckets and occupancy bitmap of a hashmap.
+ * @param hashmap A pointer to the hashmap.
+ * @return void
+ *
+ * The entries in the buckets are not freed, and the hashmap is left in small mode
+ * with no entries. Whatever is NULL was never allocated and is skipped, so this
+ * also cleans up after hm_init_buckets fails part of the way through.
+ */
+static void hm_release_buckets(struct HashMap *hashmap)
+{
+    if (hashmap->buckets != NULL)
+    {
+        hm_free_buckets(hashmap, hashmap->buckets, hashmap->capacity, NULL, NULL);
+    }
+
+    if (hashmap->occupied != NULL)
+    {
+        allocator_free(hashmap->allocator, hashmap->occupied,
+                       HM_OCCUPIED_WORDS(hashmap->capacity) * sizeof(uint64_t));
+    }
+
+    if (hashmap->entry_pool != NULL)
+    {
+        pool_free(hashmap->entry_pool);
+    }
+
+    if (hashmap->node_pool != NULL)
+    {
+        pool_free(hashmap->node_pool);
+    }
+
+    if (hashmap->bucket_pool != NULL)
+    {
+        pool_free(hashmap->bucket_pool);
+    }
+
+    hashmap->capacity = HM_SMALL_CAPACITY;
+    hashmap->size = 0;
+    hashmap->is_small = 1;
+
+    return;
+}
+
+/**
+ * @brief Allocates the pools, buckets and occupancy bitmap of a hashmap.
+ * @param hashmap A pointer to the hashmap, which must be in small mode.
+ * @param capacity The number of buckets to allocate, a power of two.
+ * @return 0 if everything was allocated, -1 if an allocation failed, in which case
+ *         the hashmap is left in small mode with no entries.
+ *
+ * This overwrites the inline entries, which share their memory with the buckets.
+ */
+static int hm_init_buckets(struct HashMap *hashmap, size_t capacity)
+{
+    hashmap->capacity = capacity;
+    hashmap->is_small = 0;
+    hashmap->old_capacity = 0;
+    hashmap->old_buckets = NULL;
+    hashmap->rehash_index = 0;
+    hashmap->entry_pool = pool_create_with_allocator(
+        sizeof(struct HashMapEntry), HM_POOL_MAX_SLAB_OBJECTS, hashmap->allocator);
+    hashmap->node_pool = pool_create_with_allocator(
+        sizeof(struct LinkedListNode), HM_POOL_MAX_SLAB_OBJECTS, hashmap->allocator);
+    hashmap->bucket_pool = pool_create_with_allocator(
+        sizeof(HashMapBucket), HM_POOL_MAX_SLAB_OBJECTS, hashmap->allocator);
+    hashmap->buckets = hm_create_buckets(hashmap, capacity);
+    hashmap->occupied = hm_create_occupied(hashmap, capacity);
+
+    if (hashmap->entry_pool == NULL || hashmap->node_pool == NULL ||
+        hashmap->bucket_pool == NULL || hashmap->buckets == NULL ||
+        hashmap->occupied == NULL)
+    {
+        hm_release_buckets(hashmap);
+
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Adds entries to the buckets of a hashmap.
+ * @param hashmap A pointer to the hashmap, which must not be in small mode.
+ * @param entries An array of the entries to add, which are copied.
+ * @param count The number of entries to add.
+ * @return 0 if every entry was added, -1 if an allocation failed.
+ *
+ * The entries are placed using their cached hashes, so this does not call the hash
+ * function. The size of the hashmap is left to the caller.
+ */
+static int hm_add_entries(struct HashMap *hashmap, const struct HashMapEntry *entries,
+                          size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        struct HashMapEntry *entry = pool_alloc(hashmap->entry_pool);
+        if (entry == NULL)
+        {
+            return -1;
+        }
+
+        *entry = entries[i];
+
+        size_t index = entry->hash & (hashmap->capacity - 1);
+        HashMapBucket *bucket = hm_get_or_create_bucket(hashmap, index);
+
+        if (bucket == NULL || ll_push(bucket, entry) != 0)
+        {
+            pool_release(hashmap->entry_pool, entry);
+
+            return -1;
+        }
+
+        hm_set_occupied(hashmap, index);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Moves the inline entries of a small hashmap into buckets.
+ * @param hashmap A pointer to the hashmap to upgrade.
+ * @return 0 if the hashmap was upgraded, -1 if an allocation failed, in which case
+ *         the hashmap is left in small mode with its entries untouched.
+ *
+ * The hashmap gets twice HM_SMALL_CAPACITY buckets, so it is only about half full
+ * afterwards. The inline entries are copied aside first, as the buckets take over
+ * their memory, and copied back if an allocation fails.
+ */
+static int hm_upgrade(struct HashMap *hashmap)
+{
+    struct HashMapEntry small_entries[HM_SMALL_CAPACITY];
+    size_t size = hashmap->size;
+
+    memcpy(small_entries, hashmap->small_entries, sizeof(small_entries));
+
+    if (hm_init_buckets(hashmap, HM_SMALL_CAPACITY * 2) != 0 ||
+        hm_add_entries(hashmap, small_entries, size) != 0)
+    {
+        if (!hm_is_small(hashmap))
+        {
+            hm_release_buckets(hashmap);
+        }
+
+        memcpy(hashmap->small_entries, small_entries, sizeof(small_entries));
+        hashmap->size = size;
+
+        return -1;
+    }
+
+    hm_record_resize(hashmap);
+
+    return 0;
+}
+
+/**
+ * @brief Adds a chain to a chain length histogram.
+ * @param histogram The histogram to add to, with HM_STATS_HISTOGRAM_SIZE bins.
+ * @param longest_chain A pointer to the longest chain seen so far, which is updated.
+ * @param length The length of the chain.
+ * @return void
+ */
+static void hm_stats_count_chain(size_t *histogram, size_t *longest_chain,
+                                 size_t length)
+{
+    histogram[hm_stats_bin(length)]++;
+
+    if (length > *longest_chain)
+    {
+        *longest_chain = length;
+    }
+
+    return;
+}
+
+/**
+ * @brief Adds the chains of a bucket array to a chain length histogram.
+ * @param buckets The bucket array to walk.
+ * @param capacity The number of buckets in the array.
+ * @param start The index of the first bucket to walk.
+ * @param histogram The histogram to add to, with HM_STATS_HISTOGRAM_SIZE bins.
+ * @param longest_chain A pointer to the longest chain seen so far, which is updated.
+ * @return The number of bytes allocated for the array. The buckets in it come from
+ *         the bucket pool of the hashmap.
+ */
+static size_t hm_stats_bucket_bytes(HashMapBucket **buckets, size_t capacity,
+                                    size_t start, size_t *histogram,
+                                    size_t *longest_chain)
+{
+    for (size_t i = start; i < capacity; i++)
+    {
+        hm_stats_count_chain(histogram, longest_chain,
+                             buckets[i] == NULL ? 0 : buckets[i]->size);
+    }
+
+    return capacity * sizeof(HashMapBucket *);
+}
+
+/**
+ * @brief Writes a histogram to a stream as a named JSON array.
+ * @param stream The stream to write to.
+ * @param name The name of the histogram.
+ * @param histogram The histogram to write, with HM_STATS_HISTOGRAM_SIZE bins.
+ * @return 0 if the histogram was written successfully, -1 otherwise.
+ */
+static int hm_stats_write_histogram(FILE *stream, const char *name,
+                                    const size_t *histogram)
+{
+    if (fprintf(stream, "\"%s\":[", name) < 0)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < HM_STATS_HISTOGRAM_SIZE; i++)
+    {
+        if (fprintf(stream, i == 0 ? "%zu" : ",%zu", histogram[i]) < 0)
+        {
+            return -1;
+        }
+    }
+
+    if (fprintf(stream, "]") < 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Creates a new hashmap.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @return A pointer to the created hashmap, or NULL if the capacity has no power of
+ *         two that fits in a size_t or an allocation failed.
+ */
+struct HashMap *hm_create(size_t capacity, HashMapHashFunction hash_function,
+                          HashMapKeyCompareFunction key_compare_function)
+{
+    return hm_create_with_allocator(capacity, hash_function, key_compare_function,
+                                    NULL);
+}
+
+/**
+ * @brief Creates a new hashmap that allocates from an allocator.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares two keys in the hashmap.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created hashmap, or NULL if the capacity has no power of
+ *         two that fits in a size_t or an allocation failed.
+ *
+ * A hashmap with a capacity of at most HM_SMALL_CAPACITY starts out in small mode,
+ * which makes creating it a single allocation.
+ */
+struct HashMap *hm_create_with_allocator(size_t capacity,
+                                         HashMapHashFunction hash_function,
+                                         HashMapKeyCompareFunction key_compare_function,
+                                         const struct Allocator *allocator)
+{
+    struct HashMap *hashmap = allocator_alloc(allocator, sizeof(struct HashMap));
+    if (hashmap == NULL)
+    {
+        return NULL;
+    }
+
+    hashmap->capacity = HM_SMALL_CAPACITY;
+    hashmap->size = 0;
+    hashmap->is_small = 1;
+    hashmap->hash_function = hash_function;
+    hashmap->key_compare_function = key_compare_function;
+    hashmap->allocator = allocator;
+    memset(&hashmap->stats, 0, sizeof(struct HashMapStats));
+
+    if (capacity > HM_SMALL_CAPACITY)
+    {
+        size_t rounded_capacity = hm_round_capacity(capacity);
+
+        if (rounded_capacity == 0 || hm_init_buckets(hashmap, rounded_capacity) != 0)
+        {
+            allocator_free(allocator, hashmap, sizeof(struct HashMap));
+
+            return NULL;
+        }
+    }
+
+    return hashmap;
+}
+
+/**
+ * @brief Frees a hashmap.
+ * @param hashmap A pointer to the hashmap to free.
+ * @param entry_free_function A function that frees an entry in the hashmap.
+ *                            Pass NULL if the entries do not need to be freed.
+ * @return void
+ */
+void hm_free(struct HashMap *hashmap, HashMapEntryFreeFunction entry_free_function)
+{
+    if (entry_free_function == NULL &&
+        !allocator_frees_individually(hashmap->allocator))
+    {
+        return;
+    }
+
+    if (hm_is_small(hashmap))
+    {
+        if (entry_free_function != NULL)
+        {
+            for (size_t i = 0; i < hashmap->size; i++)
+            {
+                entry_free_function(&hashmap->small_entries[i]);
+            }
+        }
+
+        allocator_free(hashmap->allocator, hashmap, sizeof(struct HashMap));
+
+        return;
+    }
+
+    if (hashmap->old_buckets != NULL)
+    {
+        hm_free_buckets(hashmap, hashmap->old_buckets, hashmap->old_capacity, NULL,
+                        entry_free_function);
+    }
+
+    hm_free_buckets(hashmap, hashmap->buckets, hashmap->capacity, hashmap->occupied,
+                    entry_free_function);
+    allocator_free(hashmap->allocator, hashmap->occupied,
+                   HM_OCCUPIED_WORDS(hashmap->capacity) * sizeof(uint64_t));
+    pool_free(hashmap->entry_pool);
+    pool_free(hashmap->node_pool);
+    pool_free(hashmap->bucket_pool);
+    allocator_free(hashmap->allocator, hashmap, sizeof(struct HashMap));
+
+    return;
+}
+
+/**
+ * @brief Finds the entry for a key with a precomputed hash, adding it if it is missing.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to find.
+ * @param hash The hash of the key.
+ * @param inserted A pointer that is set to 1 if the entry was added, 0 otherwise.
+ * @return A pointer to the entry, or NULL if adding it failed.
+ *
+ * The key is hashed by the caller and its chain is walked once. An entry is only
+ * allocated when the key is missing, in which case it holds the key and a NULL
+ * value. The entry stays where it is until the hashmap is next changed.
+ *
+ * A small hashmap that is full is upgraded once its inline entries are known not
+ * to hold the key, so the key is added to the new buckets without looking for it
+ * again, and the lookup is only counted once.
+ */
+static struct HashMapEntry *hm_entry_hashed(struct HashMap *hashmap, void *key,
+                                            uint64_t hash, int *inserted)
+{
+    *inserted = 0;
+
+    if (hm_is_small(hashmap))
+    {
+        struct HashMapEntry *entry = hm_small_find(hashmap, key, hash);
+
+        if (entry != NULL)
+        {
+            return entry;
+        }
+
+        if (hashmap->size < HM_SMALL_CAPACITY)
+        {
+            entry = &hashmap->small_entries[hashmap->size];
+            entry->key = key;
+            entry->value = NULL;
+            entry->hash = hash;
+            hashmap->size++;
+            *inserted = 1;
+
+            return entry;
+        }
+
+        if (hm_upgrade(hashmap) != 0)
+        {
+            return NULL;
+        }
+    }
+    else
+    {
+        hm_rehash_step(hashmap);
+
+        HashMapBucket *bucket = NULL;
+        struct LinkedListNode *existing_node_with_key =
+            hm_find(hashmap, key, hash, &bucket);
+
+        if (existing_node_with_key != NULL)
+        {
+            return existing_node_with_key->value;
+        }
+    }
+
+    struct HashMapEntry *node_value = pool_alloc(hashmap->entry_pool);
+    if (node_value == NULL)
+    {
+        return NULL;
+    }
+
+    node_value->key = key;
+    node_value->value = NULL;
+    node_value->hash = hash;
+
+    size_t index = hash & (hashmap->capacity - 1);
+    HashMapBucket *bucket = hm_get_or_create_bucket(hashmap, index);
+
+    if (bucket == NULL || ll_push(bucket, node_value) != 0)
+    {
+        pool_release(hashmap->entry_pool, node_value);
+
+        return NULL;
+    }
+
+    hm_set_occupied(hashmap, index);
+    hashmap->size++;
+    hm_maybe_grow(hashmap);
+    *inserted = 1;
+
+    return node_value;
+}
+
+/**
+ * @brief Sets a key-value pair with a precomputed hash in a hashmap.
+ * @param hashmap A pointer to the hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @param hash The hash of the key.
+ * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ */
+static int hm_set_hashed(struct HashMap *hashmap, void *key, void *value,
+                         uint64_t hash)
+{
+    int inserted;
+    struct HashMapEntry *entry = hm_entry_hashed(hashmap, key, hash, &inserted);
+    if (entry == NULL)
+    {
+        return -1;
+    }
+
+    entry->key = key;
+    entry->value = value;
+
+    return 0;
+}
+
+/**
+ * @brief Gets a value with a precomputed hash from a hashmap.
+ * @param hashmap A pointer to the hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @param hash The hash of the key.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ */
+static void *hm_get_hashed(struct HashMap *hashmap, void *key, uint64_t hash)
+{
+    if (hm_is_small(hashmap))
+    {
+        struct HashMapEntry *entry = hm_small_find(hashmap, key, hash);
+
+        return entry == NULL ? NULL : entry->value;
+    }
+
+    hm_rehash_step(hashmap);
+
+    HashMapBucket *bucket = NULL;
+    struct LinkedListNode *node = hm_find(hashmap, key, hash, &bucket);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    return ((struct HashMapEntry *)node->value)->value;
+}
+
+/**
+ * @brief Removes a key-value pair with a precomputed hash from a hashmap.
+ * @param hashmap A pointer to the hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @param hash The hash of the key.
+ * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ */
+static void *hm_remove_hashed(struct HashMap *hashmap, void *key, uint64_t hash)
+{
+    if (hm_is_small(hashmap))
+    {
+        struct HashMapEntry *entry = hm_small_find(hashmap, key, hash);
+        if (entry == NULL)
+        {
+            return NULL;
+        }
+
+        void *value = entry->value;
+
+        hashmap->size--;
+        *entry = hashmap->small_entries[hashmap->size];
+
+        return value;
+    }
+
+    hm_rehash_step(hashmap);
+
+    HashMapBucket *bucket = NULL;
+    struct LinkedListNode *node = hm_find(hashmap, key, hash, &bucket);
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    struct HashMapEntry *current_hashmap_node = node->value;
+    void *value = current_hashmap_node->value;
+
+    pool_release(hashmap->entry_pool, current_hashmap_node);
+    ll_remove_node(bucket, node);
+
+    size_t index = hash & (hashmap->capacity - 1);
+
+    if (bucket->size == 0 && bucket == hashmap->buckets[index])
+    {
+        hm_clear_occupied(hashmap, index);
+    }
+
+    hashmap->size--;
+
+    return value;
+}
+
+/**
+ * @brief Hashes a batch of keys and prefetches the buckets they map to.
+ * @param hashmap A pointer to the hashmap the keys are for.
+ * @param keys An array of pointers to the keys to hash.
+ * @param count The number of keys, at most HM_BATCH_SIZE.
+ * @param hashes An array to store the hash of each key in.
+ * @return void
+ *
+ * All the hashes are computed before any bucket is touched, so the prefetches of
+ * every bucket in the batch are in flight at the same time instead of each lookup
+ * waiting on its own cache miss. The first node of each bucket cannot be prefetched
+ * without waiting for the bucket, so a second pass prefetches those once the buckets
+ * have had the hashing of the whole batch to arrive. A small hashmap has nothing
+ * to prefetch, as its entries are inline.
+ */
+static void hm_prefetch_batch(struct HashMap *hashmap, void **keys, size_t count,
+                              uint64_t *hashes)
+{
+    if (hm_is_small(hashmap))
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            hashes[i] = hashmap->hash_function(keys[i]);
+        }
+
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hashmap->hash_function(keys[i]);
+
+        __builtin_prefetch(hashmap->buckets[hashes[i] & (hashmap->capacity - 1)]);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        HashMapBucket *bucket = hashmap->buckets[hashes[i] & (hashmap->capacity - 1)];
+
+        if (bucket != NULL && bucket->head != NULL)
+        {
+            __builtin_prefetch(bucket->head);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Sets a key-value pair in a hashmap.
+ * @param hashmap A pointer to the hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @return 0 if the key-value pair was set successfully, -1 otherwise.
+ */
+int hm_set(struct HashMap *hashmap, void *key, void *value)
+{
+    return hm_set_hashed(hashmap, key, value, hashmap->hash_function(key));
+}
+
+/**
+ * @brief Gets a value from a hashmap.
+ * @param hashmap A pointer to the hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the value, or NULL if the key is not in the hashmap.
+ */
+void *hm_get(struct HashMap *hashmap, void *key)
+{
+    return hm_get_hashed(hashmap, key, hashmap->hash_function(key));
+}
+
+/**
+ * @brief Removes a key-value pair from a hashmap.
+ * @param hashmap A pointer to the hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the removed value, or NULL if the key is not in the hashmap.
+ */
+void *hm_remove(struct HashMap *hashmap, void *key)
+{
+    return hm_remove_hashed(hashmap, key, hashmap->hash_function(key));
+}
+
+/**
+ * @brief Gets the value slot of a key in a hashmap, adding the key if it is missing.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to find.
+ * @param inserted A pointer that is set to 1 if the key was added and 0 if it was
+ *                 already in the hashmap. Pass NULL if this is not needed.
+ * @return A pointer to the value of the key, or NULL if adding the key failed.
+ *
+ * A key that is added gets a NULL value, which the caller fills in through the
+ * returned pointer. The key is hashed once and its chain is walked once, so a
+ * value can be created on first use and updated in place with a single lookup.
+ * The pointer is only valid until the hashmap is next changed.
+ */
+void **hm_entry(struct HashMap *hashmap, void *key, int *inserted)
+{
+    int added;
+    struct HashMapEntry *entry =
+        hm_entry_hashed(hashmap, key, hashmap->hash_function(key), &added);
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+
+    if (inserted != NULL)
+    {
+        *inserted = added;
+    }
+
+    return &entry->value;
+}
+
+/**
+ * @brief Gets the value of a key in a hashmap, setting it if the key is missing.
+ * @param hashmap A pointer to the hashmap to search.
+ * @param key A pointer to the key to get.
+ * @param value A pointer to the value to set if the key is missing.
+ * @return A pointer to the value the key has afterwards, or NULL if adding the key
+ *         failed.
+ */
+void *hm_get_or_insert(struct HashMap *hashmap, void *key, void *value)
+{
+    int inserted;
+    void **slot = hm_entry(hashmap, key, &inserted);
+    if (slot == NULL)
+    {
+        return NULL;
+    }
+
+    if (inserted)
+    {
+        *slot = value;
+    }
+
+    return *slot;
+}
+
+/**
+ * @brief Sets a key-value pair in a hashmap and hands back the value it replaced.
+ * @param hashmap A pointer to the hashmap to set in.
+ * @param key A pointer to the key to set.
+ * @param value A pointer to the value to set.
+ * @param old_value A pointer that is set to the replaced value, or to NULL if the
+ *                  key was added. Pass NULL if this is not needed.
+ * @return 1 if an existing value was replaced, 0 if the key was added, or -1 if
+ *         adding the key failed.
+ *
+ * Unlike hm_set, the key the hashmap already holds is kept, so a caller that owns
+ * its keys can free the one it passed in when 1 is returned.
+ */
+int hm_upsert(struct HashMap *hashmap, void *key, void *value, void **old_value)
+{
+    int inserted;
+    void **slot = hm_entry(hashmap, key, &inserted);
+    if (slot == NULL)
+    {
+        return -1;
+    }
+
+    if (old_value != NULL)
+    {
+        *old_value = inserted ? NULL : *slot;
+    }
+
+    *slot = value;
+
+    return !inserted;
+}
+
+/**
+ * @brief Gets the number of entries in a hashmap.
+ * @param hashmap A pointer to the hashmap.
+ * @return The number of entries.
+ */
+size_t hm_size(struct HashMap *hashmap)
+{
+    return hashmap->size;
+}
+
+/**
+ * @brief Writes the statistics of a hashmap to a stream as a single line of JSON.
+ * @param hashmap A pointer to the hashmap to describe.
+ * @param stream The stream to write to.
+ * @return 0 if the statistics were written successfully, -1 otherwise.
+ *
+ * The size, capacity, chain lengths and bytes allocated are worked out by walking
+ * the hashmap, which takes time linear in its capacity, so this is meant to be
+ * called now and then rather than on every request. Chains in old buckets that are
+ * still waiting to be migrated are counted as well. In small mode the inline
+ * entries count as a single chain. The lookup, probe and resize counters are only
+ * written when HM_STATS is enabled.
+ */
+int hm_stats(struct HashMap *hashmap, FILE *stream)
+{
+    size_t chain_histogram[HM_STATS_HISTOGRAM_SIZE] = {0};
+    size_t longest_chain = 0;
+    size_t bytes = sizeof(struct HashMap);
+    int rehashing = !hm_is_small(hashmap) && hashmap->old_buckets != NULL;
+
+    if (hm_is_small(hashmap))
+    {
+        hm_stats_count_chain(chain_histogram, &longest_chain, hashmap->size);
+    }
+    else
+    {
+        bytes += hm_stats_bucket_bytes(hashmap->buckets, hashmap->capacity, 0,
+                                       chain_histogram, &longest_chain);
+        bytes += HM_OCCUPIED_WORDS(hashmap->capacity) * sizeof(uint64_t);
+        bytes += pool_bytes(hashmap->entry_pool);
+        bytes += pool_bytes(hashmap->node_pool);
+        bytes += pool_bytes(hashmap->bucket_pool);
+    }
+
+    if (rehashing)
+    {
+        bytes += hm_stats_bucket_bytes(hashmap->old_buckets, hashmap->old_capacity,
+                                       hashmap->rehash_index, chain_histogram,
+                                       &longest_chain);
+    }
+
+    if (fprintf(stream,
+                "{\"size\":%zu,\"capacity\":%zu,\"small\":%d,\"rehashing\":%d,"
+                "\"bytes\":%zu,\"longest_chain\":%zu,",
+                hashmap->size, hashmap->capacity, hm_is_small(hashmap),
+                rehashing, bytes, longest_chain) < 0 ||
+        hm_stats_write_histogram(stream, "chain_histogram", chain_histogram) != 0)
+    {
+        return -1;
+    }
+
+#if HM_STATS
+    if (fprintf(stream,
+                ",\"lookups\":%zu,\"hits\":%zu,\"misses\":%zu,\"probes\":%zu,"
+                "\"resizes\":%zu,",
+                hashmap->stats.lookups, hashmap->stats.hits,
+                hashmap->stats.lookups - hashmap->stats.hits, hashmap->stats.probes,
+                hashmap->stats.resizes) < 0 ||
+        hm_stats_write_histogram(stream, "probe_histogram",
+                                 hashmap->stats.probe_histogram) != 0)
+    {
+        return -1;
+    }
+#endif
+
+    if (fprintf(stream, "}\n") < 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Sets many key-value pairs in a hashmap.
+ * @param hashmap A pointer to the hashmap to set in.
+ * @param keys An array of pointers to the keys to set.
+ * @param values An array of pointers to the values to set, one for each key.
+ * @param count The number of key-value pairs to set.
+ * @return 0 if every key-value pair was set successfully, -1 otherwise.
+ *
+ * The pairs are set in order, HM_BATCH_SIZE at a time. If setting a pair fails, the
+ * pairs before it stay set and the ones after it are not attempted.
+ */
+int hm_set_many(struct HashMap *hashmap, void **keys, void **values, size_t count)
+{
+    uint64_t hashes[HM_BATCH_SIZE];
+
+    for (size_t start = 0; start < count; start += HM_BATCH_SIZE)
+    {
+        size_t batch_size = count - start;
+
+        if (batch_size > HM_BATCH_SIZE)
+        {
+            batch_size = HM_BATCH_SIZE;
+        }
+
+        hm_prefetch_batch(hashmap, &keys[start], batch_size, hashes);
+
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            void *key = keys[start + i];
+
+            if (hm_set_hashed(hashmap, key, values[start + i], hashes[i]) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gets many values from a hashmap.
+ * @param hashmap A pointer to the hashmap to get from.
+ * @param keys An array of pointers to the keys to get.
+ * @param count The number of keys to get.
+ * @param values An array to store the value of each key in, or NULL for keys that
+ *               are not in the hashmap.
+ * @return void
+ */
+void hm_get_many(struct HashMap *hashmap, void **keys, size_t count, void **values)
+{
+    uint64_t hashes[HM_BATCH_SIZE];
+
+    for (size_t start = 0; start < count; start += HM_BATCH_SIZE)
+    {
+        size_t batch_size = count - start;
+
+        if (batch_size > HM_BATCH_SIZE)
+        {
+            batch_size = HM_BATCH_SIZE;
+        }
+
+        hm_prefetch_batch(hashmap, &keys[start], batch_size, hashes);
+
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            values[start + i] = hm_get_hashed(hashmap, keys[start + i], hashes[i]);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Removes many key-value pairs from a hashmap.
+ * @param hashmap A pointer to the hashmap to remove from.
+ * @param keys An array of pointers to the keys to remove.
+ * @param count The number of keys to remove.
+ * @param values An array to store the removed value of each key in, or NULL for keys
+ *               that are not in the hashmap. Pass NULL if the values are not needed.
+ * @return The number of key-value pairs that were removed.
+ */
+size_t hm_remove_many(struct HashMap *hashmap, void **keys, size_t count,
+                      void **values)
+{
+    uint64_t hashes[HM_BATCH_SIZE];
+    size_t removed = 0;
+
+    for (size_t start = 0; start < count; start += HM_BATCH_SIZE)
+    {
+        size_t batch_size = count - start;
+
+        if (batch_size > HM_BATCH_SIZE)
+        {
+            batch_size = HM_BATCH_SIZE;
+        }
+
+        hm_prefetch_batch(hashmap, &keys[start], batch_size, hashes);
+
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            size_t size = hashmap->size;
+            void *value = hm_remove_hashed(hashmap, keys[start + i], hashes[i]);
+
+            if (values != NULL)
+            {
+                values[start + i] = value;
+            }
+
+            removed += size - hashmap->size;
+        }
+    }
+
+    return removed;
+}
+
+/**
+ * @brief Starts iterating over a hashmap.
+ * @param hashmap A pointer to the hashmap to iterate over.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return void
+ *
+ * Starting to iterate does no work on the hashmap, even while it is rehashing. The
+ * old buckets that are left are migrated one at a time as the iterator reaches
+ * them, by hm_iter_next.
+ */
+void hm_iter_begin(struct HashMap *hashmap, struct HashMapIterator *iterator)
+{
+    iterator->hashmap = hashmap;
+    iterator->next_bucket = 0;
+    iterator->split = hashmap->capacity;
+    iterator->current = NULL;
+    iterator->bucket_iterator.linked_list = NULL;
+    iterator->bucket_iterator.previous = NULL;
+    iterator->bucket_iterator.current = NULL;
+    iterator->bucket_iterator.next = NULL;
+
+    if (!hm_is_small(hashmap) && hashmap->old_buckets != NULL)
+    {
+        iterator->split = hashmap->old_capacity;
+    }
+
+    return;
+}
+
+/**
+ * @brief Finds the next bucket an iterator walks.
+ * @param iterator A pointer to the iterator.
+ * @return A pointer to the bucket, or NULL if every bucket has been walked.
+ *
+ * If the hashmap was not rehashing when the iterator started, the occupancy bitmap
+ * is used to jump straight to the next bucket holding an entry.
+ *
+ * Otherwise the buckets are walked in groups, where group i is old bucket i and
+ * buckets i and i + split, as migrating an old bucket only ever moves entries
+ * within its group. Before a group is walked, its old bucket is migrated, so
+ * nothing can move entries into or out of the group the iterator is in. If that
+ * migration fails to create a bucket, the old bucket is walked where it is.
+ */
+static HashMapBucket *hm_iter_next_bucket(struct HashMapIterator *iterator)
+{
+    struct HashMap *hashmap = iterator->hashmap;
+    size_t split = iterator->split;
+
+    if (split == hashmap->capacity)
+    {
+        size_t index = hm_next_occupied(hashmap, iterator->next_bucket);
+        if (index >= hashmap->capacity)
+        {
+            iterator->next_bucket = hashmap->capacity;
+
+            return NULL;
+        }
+
+        iterator->next_bucket = index + 1;
+
+        return hashmap->buckets[index];
+    }
+
+    while (iterator->next_bucket < split * 3)
+    {
+        size_t group = iterator->next_bucket / 3;
+        size_t member = iterator->next_bucket % 3;
+
+        iterator->next_bucket++;
+
+        if (member == 0)
+        {
+            if (hashmap->old_buckets != NULL && group >= hashmap->rehash_index &&
+                hm_migrate_bucket(hashmap, group) != 0)
+            {
+                return hashmap->old_buckets[group];
+            }
+
+            continue;
+        }
+
+        size_t index = member == 1 ? group : group + split;
+
+        if (hm_is_occupied(hashmap, index))
+        {
+            return hashmap->buckets[index];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Advances an iterator to the next entry of its hashmap.
+ * @param iterator A pointer to the iterator to advance.
+ * @return A pointer to the next entry, or NULL if every entry has been returned.
+ */
+struct HashMapEntry *hm_iter_next(struct HashMapIterator *iterator)
+{
+    struct HashMap *hashmap = iterator->hashmap;
+
+    if (hm_is_small(hashmap))
+    {
+        if (iterator->next_bucket >= hashmap->size)
+        {
+            iterator->current = NULL;
+
+            return NULL;
+        }
+
+        iterator->current = &hashmap->small_entries[iterator->next_bucket];
+        iterator->next_bucket++;
+
+        return iterator->current;
+    }
+
+    struct LinkedListNode *node = ll_iter_next(&iterator->bucket_iterator);
+
+    while (node == NULL)
+    {
+        HashMapBucket *bucket = hm_iter_next_bucket(iterator);
+        if (bucket == NULL)
+        {
+            iterator->current = NULL;
+
+            return NULL;
+        }
+
+        ll_iter_begin(bucket, &iterator->bucket_iterator);
+        node = ll_iter_next(&iterator->bucket_iterator);
+    }
+
+    iterator->current = node->value;
+
+    return iterator->current;
+}
+
+/**
+ * @brief Removes the entry last returned by an iterator from its hashmap.
+ * @param iterator A pointer to the iterator.
+ * @return A pointer to the value of the removed entry, or NULL if there is no entry
+ *         to remove.
+ *
+ * In small mode the last inline entry is moved into the freed slot, so the iterator
+ * steps back to return it next.
+ */
+void *hm_iter_remove(struct HashMapIterator *iterator)
+{
+    struct HashMap *hashmap = iterator->hashmap;
+    struct HashMapEntry *entry = iterator->current;
+
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+
+    void *value = entry->value;
+
+    iterator->current = NULL;
+
+    if (hm_is_small(hashmap))
+    {
+        hashmap->size--;
+        *entry = hashmap->small_entries[hashmap->size];
+        iterator->next_bucket--;
+
+        return value;
+    }
+
+    size_t index = entry->hash & (hashmap->capacity - 1);
+    HashMapBucket *bucket = iterator->bucket_iterator.linked_list;
+
+    pool_release(hashmap->entry_pool, entry);
+    ll_iter_remove(&iterator->bucket_iterator);
+
+    if (bucket->size == 0 && bucket == hashmap->buckets[index])
+    {
+        hm_clear_occupied(hashmap, index);
+    }
+
+    hashmap->size--;
+
+    return value;
+}
+
+/**
+ * @brief Multiplies two 64-bit integers into a 128-bit result.
+ * @param a A pointer to the first integer, which receives the low 64 bits.
+ * @param b A pointer to the second integer, which receives the high 64 bits.
+ * @return void
+ */
+static inline void hm_hash_multiply(uint64_t *a, uint64_t *b)
+{
+    __uint128_t product = (__uint128_t)*a * *b;
+
+    *a = (uint64_t)product;
+    *b = (uint64_t)(product >> 64);
+
+    return;
+}
+
+/**
+ * @brief Mixes two 64-bit integers into one.
+ * @param a The first integer to mix.
+ * @param b The second integer to mix.
+ * @return The low and high halves of the 128-bit product of a and b, xored together.
+ */
+static inline uint64_t hm_hash_mix(uint64_t a, uint64_t b)
+{
+    hm_hash_multiply(&a, &b);
+
+    return a ^ b;
+}
+
+/**
+ * @brief Reads 8 unaligned bytes as a 64-bit integer.
+ * @param data A pointer to the bytes to read.
+ * @return The bytes as a 64-bit integer.
+ */
+static inline uint64_t hm_hash_read64(const uint8_t *data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+/**
+ * @brief Reads 4 unaligned bytes as a 64-bit integer.
+ * @param data A pointer to the bytes to read.
+ * @return The bytes as a 64-bit integer.
+ */
+static inline uint64_t hm_hash_read32(const uint8_t *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+/**
+ * @brief Sets the seed used by the built-in hash functions.
+ * @param seed The new seed.
+ * @return void
+ */
+void hm_set_hash_seed(uint64_t seed)
+{
+    hm_hash_seed = seed;
+
+    return;
+}
+
+/**
+ * @brief Hashes a sequence of bytes with a given seed.
+ * @param data A pointer to the bytes to hash.
+ * @param length The number of bytes to hash.
+ * @param seed The seed to hash with.
+ * @return The 64-bit hash of the bytes.
+ *
+ * Keys of up to 16 bytes are read with at most four overlapping loads and no loop.
+ * Longer keys are consumed 48 bytes at a time by three independent multiply chains,
+ * which the CPU can run in parallel, and the remainder 16 bytes at a time.
+ */
+uint64_t hm_hash_bytes(const void *data, size_t length, uint64_t seed)
+{
+    const uint8_t *bytes = data;
+    uint64_t a;
+    uint64_t b;
+
+    seed ^= hm_hash_mix(seed ^ hm_hash_secret[0], hm_hash_secret[1]);
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            size_t offset = (length >> 3) << 2;
+
+            a = (hm_hash_read32(bytes) << 32) | hm_hash_read32(bytes + offset);
+            b = (hm_hash_read32(bytes + length - 4) << 32) |
+                hm_hash_read32(bytes + length - 4 - offset);
+        }
+        else if (length > 0)
+        {
+            a = ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[length >> 1] << 8) |
+                bytes[length - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        size_t remaining = length;
+
+        if (remaining > 48)
+        {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+
+            do
+            {
+                seed = hm_hash_mix(hm_hash_read64(bytes) ^ hm_hash_secret[1],
+                                   hm_hash_read64(bytes + 8) ^ seed);
+                seed1 = hm_hash_mix(hm_hash_read64(bytes + 16) ^ hm_hash_secret[2],
+                                    hm_hash_read64(bytes + 24) ^ seed1);
+                seed2 = hm_hash_mix(hm_hash_read64(bytes + 32) ^ hm_hash_secret[3],
+                                    hm_hash_read64(bytes + 40) ^ seed2);
+
+                bytes += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16)
+        {
+            seed = hm_hash_mix(hm_hash_read64(bytes) ^ hm_hash_secret[1],
+                               hm_hash_read64(bytes + 8) ^ seed);
+
+            bytes += 16;
+            remaining -= 16;
+        }
+
+        a = hm_hash_read64(bytes + remaining - 16);
+        b = hm_hash_read64(bytes + remaining - 8);
+    }
+
+    a ^= hm_hash_secret[1];
+    b ^= seed;
+    hm_hash_multiply(&a, &b);
+
+    return hm_hash_mix(a ^ hm_hash_secret[0] ^ length, b ^ hm_hash_secret[1]);
+}
+
+/**
+ * @brief Hashes a 64-bit integer with a given seed.
+ * @param value The integer to hash.
+ * @param seed The seed to hash with.
+ * @return The 64-bit hash of the integer, with every bit of the input mixed in.
+ */
+uint64_t hm_hash_integer(uint64_t value, uint64_t seed)
+{
+    return hm_hash_mix(value ^ hm_hash_secret[0], seed ^ hm_hash_secret[1]);
+}
+
+/**
+ * @brief A hash function for keys that are NUL terminated strings.
+ * @param key A pointer to the first character of the string.
+ * @return The 64-bit hash of the string, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_string(void *key)
+{
+    return hm_hash_bytes(key, strlen(key), hm_hash_seed);
+}
+
+/**
+ * @brief A hash function for keys that are pointers to an int.
+ * @param key A pointer to the int.
+ * @return The 64-bit hash of the int, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_int(void *key)
+{
+    return hm_hash_integer((uint64_t)*(int *)key, hm_hash_seed);
+}
+
+/**
+ * @brief A hash function for keys that are pointers to a uint64_t.
+ * @param key A pointer to the uint64_t.
+ * @return The 64-bit hash of the integer, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_uint64(void *key)
+{
+    return hm_hash_integer(*(uint64_t *)key, hm_hash_seed);
+}
+
+/**
+ * @brief A hash function for keys that are compared by their address.
+ * @param key The key.
+ * @return The 64-bit hash of the address, hashed with the seed set by hm_set_hash_seed.
+ */
+uint64_t hm_hash_pointer(void *key)
+{
+    return hm_hash_integer((uint64_t)(uintptr_t)key, hm_hash_seed);
+}
+
+/**
+ * @brief A key compare function for keys that are NUL terminated strings.
+ * @param key1 The first string to compare.
+ * @param key2 The second string to compare.
+ * @return 0 if the strings are equal, else a non-zero value.
+ */
+int hm_compare_string(void *key1, void *key2)
+{
+    return strcmp(key1, key2);
+}
+
+/**
+ * @brief A key compare function for keys that are pointers to an int.
+ * @param key1 A pointer to the first int to compare.
+ * @param key2 A pointer to the second int to compare.
+ * @return 0 if the ints are equal, else a non-zero value.
+ */
+int hm_compare_int(void *key1, void *key2)
+{
+    int a = *(int *)key1;
+    int b = *(int *)key2;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief A key compare function for keys that are pointers to a uint64_t.
+ * @param key1 A pointer to the first integer to compare.
+ * @param key2 A pointer to the second integer to compare.
+ * @return 0 if the integers are equal, else a non-zero value.
+ */
+int hm_compare_uint64(void *key1, void *key2)
+{
+    uint64_t a = *(uint64_t *)key1;
+    uint64_t b = *(uint64_t *)key2;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief A key compare function for keys that are compared by their address.
+ * @param key1 The first key to compare.
+ * @param key2 The second key to compare.
+ * @return 0 if the keys are the same pointer, else a non-zero value.
+ */
+int hm_compare_pointer(void *key1, void *key2)
+{
+    uintptr_t a = (uintptr_t)key1;
+    uintptr_t b = (uintptr_t)key2;
+
+    return (a > b) - (a < b);
+}
@@ -0,0 +1,321 @@
+/**
+ * @brief An intrusive hashmap whose links are embedded in its elements.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/hashmap.h"
+#include "lib/ihashmap.h"
+
+/**
+ * @brief Rounds a capacity up to the next power of two.
+ * @param capacity The capacity to round up.
+ * @return The smallest power of two that is at least capacity, and at least 1.
+ */
+static size_t ihm_round_capacity(size_t capacity)
+{
+    size_t rounded_capacity = 1;
+
+    while (rounded_capacity < capacity)
+    {
+        rounded_capacity *= 2;
+    }
+
+    return rounded_capacity;
+}
+
+/**
+ * @brief Gets the link that points to the node holding a key.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to search.
+ * @param key A pointer to the key to search for.
+ * @param hash The hash of the key.
+ * @return A pointer to the bucket head or next pointer that points to the node
+ *         holding the key, or to the NULL that ends the bucket if the key is not in
+ *         the hashmap.
+ *
+ * The key compare function is only called for nodes with the same cached hash.
+ */
+static struct IntrusiveHashMapNode **
+ihm_find(struct IntrusiveHashMap *intrusive_hashmap, void *key, uint64_t hash)
+{
+    struct IntrusiveHashMapNode **link =
+        &intrusive_hashmap->buckets[hash & (intrusive_hashmap->capacity - 1)];
+
+    while (*link != NULL)
+    {
+        if ((*link)->hash == hash &&
+            intrusive_hashmap->key_compare_function(*link, key) == 0)
+        {
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+/**
+ * @brief Doubles the capacity of an intrusive hashmap if it is over its load factor.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to grow.
+ * @return void
+ *
+ * If allocating the new buckets fails, the hashmap keeps its current buckets and
+ * only gets slower.
+ */
+static void ihm_maybe_grow(struct IntrusiveHashMap *intrusive_hashmap)
+{
+    if (intrusive_hashmap->size * 100 <=
+        intrusive_hashmap->capacity * HM_MAX_LOAD_PERCENT)
+    {
+        return;
+    }
+
+    size_t capacity = intrusive_hashmap->capacity * 2;
+
+    struct IntrusiveHashMapNode **buckets = allocator_alloc(
+        intrusive_hashmap->allocator, capacity * sizeof(struct IntrusiveHashMapNode *));
+    if (buckets == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        buckets[i] = NULL;
+    }
+
+    for (size_t i = 0; i < intrusive_hashmap->capacity; i++)
+    {
+        struct IntrusiveHashMapNode *current_node = intrusive_hashmap->buckets[i];
+
+        while (current_node != NULL)
+        {
+            struct IntrusiveHashMapNode *next_node = current_node->next;
+            size_t index = current_node->hash & (capacity - 1);
+
+            current_node->next = buckets[index];
+            buckets[index] = current_node;
+            current_node = next_node;
+        }
+    }
+
+    allocator_free(intrusive_hashmap->allocator, intrusive_hashmap->buckets,
+                   intrusive_hashmap->capacity * sizeof(struct IntrusiveHashMapNode *));
+
+    intrusive_hashmap->buckets = buckets;
+    intrusive_hashmap->capacity = capacity;
+
+    return;
+}
+
+/**
+ * @brief Creates a new intrusive hashmap.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares the key of an element to a
+ *                             key.
+ * @return A pointer to the created intrusive hashmap.
+ */
+struct IntrusiveHashMap *
+ihm_create(size_t capacity, HashMapHashFunction hash_function,
+           IntrusiveHashMapKeyCompareFunction key_compare_function)
+{
+    return ihm_create_with_allocator(capacity, hash_function, key_compare_function,
+                                     NULL);
+}
+
+/**
+ * @brief Creates a new intrusive hashmap that allocates from an allocator.
+ * @param capacity The initial capacity of the hashmap, rounded up to a power of two.
+ * @param hash_function A function that hashes a key to a 64-bit hash.
+ * @param key_compare_function A function that compares the key of an element to a
+ *                             key.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created intrusive hashmap.
+ */
+struct IntrusiveHashMap *
+ihm_create_with_allocator(size_t capacity, HashMapHashFunction hash_function,
+                          IntrusiveHashMapKeyCompareFunction key_compare_function,
+                          const struct Allocator *allocator)
+{
+    struct IntrusiveHashMap *intrusive_hashmap =
+        allocator_alloc(allocator, sizeof(struct IntrusiveHashMap));
+    if (intrusive_hashmap == NULL)
+    {
+        return NULL;
+    }
+
+    capacity = ihm_round_capacity(capacity);
+
+    intrusive_hashmap->buckets =
+        allocator_alloc(allocator, capacity * sizeof(struct IntrusiveHashMapNode *));
+    if (intrusive_hashmap->buckets == NULL)
+    {
+        allocator_free(allocator, intrusive_hashmap, sizeof(struct IntrusiveHashMap));
+
+        return NULL;
+    }
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        intrusive_hashmap->buckets[i] = NULL;
+    }
+
+    intrusive_hashmap->capacity = capacity;
+    intrusive_hashmap->size = 0;
+    intrusive_hashmap->hash_function = hash_function;
+    intrusive_hashmap->key_compare_function = key_compare_function;
+    intrusive_hashmap->allocator = allocator;
+
+    return intrusive_hashmap;
+}
+
+/**
+ * @brief Frees an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to free.
+ * @param node_free_function A function that frees an element of the hashmap. Pass
+ *                           NULL if the elements do not need to be freed.
+ * @return void
+ */
+void ihm_free(struct IntrusiveHashMap *intrusive_hashmap,
+              IntrusiveHashMapNodeFreeFunction node_free_function)
+{
+    if (node_free_function != NULL)
+    {
+        for (size_t i = 0; i < intrusive_hashmap->capacity; i++)
+        {
+            struct IntrusiveHashMapNode *current_node = intrusive_hashmap->buckets[i];
+
+            while (current_node != NULL)
+            {
+                struct IntrusiveHashMapNode *next_node = current_node->next;
+
+                node_free_function(current_node);
+                current_node = next_node;
+            }
+        }
+    }
+
+    allocator_free(intrusive_hashmap->allocator, intrusive_hashmap->buckets,
+                   intrusive_hashmap->capacity * sizeof(struct IntrusiveHashMapNode *));
+    allocator_free(intrusive_hashmap->allocator, intrusive_hashmap,
+                   sizeof(struct IntrusiveHashMap));
+
+    return;
+}
+
+/**
+ * @brief Sets the element of a key in an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to set in.
+ * @param key A pointer to the key of the element.
+ * @param node A pointer to the node embedded in the element.
+ * @return A pointer to the node of the element that was replaced, or NULL if the key
+ *         was not in the hashmap.
+ *
+ * A replaced element takes the place of the old one in its bucket, so the hashmap
+ * does not grow.
+ */
+struct IntrusiveHashMapNode *ihm_set(struct IntrusiveHashMap *intrusive_hashmap,
+                                     void *key, struct IntrusiveHashMapNode *node)
+{
+    uint64_t hash = intrusive_hashmap->hash_function(key);
+
+    struct IntrusiveHashMapNode **link = ihm_find(intrusive_hashmap, key, hash);
+    struct IntrusiveHashMapNode *replaced_node = *link;
+
+    node->hash = hash;
+
+    if (replaced_node != NULL)
+    {
+        node->next = replaced_node->next;
+        replaced_node->next = NULL;
+        *link = node;
+
+        return replaced_node;
+    }
+
+    size_t index = hash & (intrusive_hashmap->capacity - 1);
+
+    node->next = intrusive_hashmap->buckets[index];
+    intrusive_hashmap->buckets[index] = node;
+    intrusive_hashmap->size++;
+
+    ihm_maybe_grow(intrusive_hashmap);
+
+    return NULL;
+}
+
+/**
+ * @brief Gets the element of a key from an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to get from.
+ * @param key A pointer to the key to get.
+ * @return A pointer to the node of the element, or NULL if the key is not in the
+ *         hashmap.
+ */
+struct IntrusiveHashMapNode *ihm_get(struct IntrusiveHashMap *intrusive_hashmap,
+                                     void *key)
+{
+    uint64_t hash = intrusive_hashmap->hash_function(key);
+
+    return *ihm_find(intrusive_hashmap, key, hash);
+}
+
+/**
+ * @brief Removes the element of a key from an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to remove from.
+ * @param key A pointer to the key to remove.
+ * @return A pointer to the node of the removed element, or NULL if the key is not in
+ *         the hashmap.
+ */
+struct IntrusiveHashMapNode *ihm_remove(struct IntrusiveHashMap *intrusive_hashmap,
+                                        void *key)
+{
+    uint64_t hash = intrusive_hashmap->hash_function(key);
+
+    struct IntrusiveHashMapNode **link = ihm_find(intrusive_hashmap, key, hash);
+    struct IntrusiveHashMapNode *removed_node = *link;
+    if (removed_node == NULL)
+    {
+        return NULL;
+    }
+
+    *link = removed_node->next;
+    removed_node->next = NULL;
+    intrusive_hashmap->size--;
+
+    return removed_node;
+}
+
+/**
+ * @brief Removes an element from an intrusive hashmap.
+ * @param intrusive_hashmap A pointer to the intrusive hashmap to remove from.
+ * @param node A pointer to the node embedded in the element.
+ * @return 0 if the element was removed successfully, -1 otherwise.
+ *
+ * The bucket is found with the cached hash of the node, so the key is not needed.
+ */
+int ihm_remove_node(struct IntrusiveHashMap *intrusive_hashmap,
+                    struct IntrusiveHashMapNode *node)
+{
+    struct IntrusiveHashMapNode **link =
+        &intrusive_hashmap->buckets[node->hash & (intrusive_hashmap->capacity - 1)];
+
+    while (*link != NULL)
+    {
+        if (*link == node)
+        {
+            *link = node->next;
+            node->next = NULL;
+            intrusive_hashmap->size--;
+
+            return 0;
+        }
+
+        link = &(*link)->next;
+    }
+
+    return -1;
+}
@@ -0,0 +1,190 @@
+/**
+ * @brief An intrusive doubly linked list whose links are embedded in its elements.
+ */
+
+#include <stddef.h>
+
+#include "lib/ilist.h"
+
+/**
+ * @brief Links a node into an intrusive list between two nodes.
+ * @param intrusive_list A pointer to the intrusive list to link into.
+ * @param prev A pointer to the node to link after, or NULL to link at the head.
+ * @param next A pointer to the node to link before, or NULL to link at the tail.
+ * @param node A pointer to the node to link.
+ * @return void
+ */
+static void il_link(struct IntrusiveList *intrusive_list,
+                    struct IntrusiveListNode *prev, struct IntrusiveListNode *next,
+                    struct IntrusiveListNode *node)
+{
+    node->prev = prev;
+    node->next = next;
+
+    if (prev == NULL)
+    {
+        intrusive_list->head = node;
+    }
+    else
+    {
+        prev->next = node;
+    }
+
+    if (next == NULL)
+    {
+        intrusive_list->tail = node;
+    }
+    else
+    {
+        next->prev = node;
+    }
+
+    intrusive_list->size++;
+
+    return;
+}
+
+/**
+ * @brief Initializes an empty intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to initialize.
+ * @return void
+ */
+void il_init(struct IntrusiveList *intrusive_list)
+{
+    intrusive_list->size = 0;
+    intrusive_list->head = NULL;
+    intrusive_list->tail = NULL;
+
+    return;
+}
+
+/**
+ * @brief Pushes a node onto the tail of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to push onto.
+ * @param node A pointer to the node to push.
+ * @return void
+ */
+void il_push(struct IntrusiveList *intrusive_list, struct IntrusiveListNode *node)
+{
+    il_link(intrusive_list, intrusive_list->tail, NULL, node);
+
+    return;
+}
+
+/**
+ * @brief Pushes a node onto the head of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to push onto.
+ * @param node A pointer to the node to push.
+ * @return void
+ */
+void il_push_front(struct IntrusiveList *intrusive_list,
+                   struct IntrusiveListNode *node)
+{
+    il_link(intrusive_list, NULL, intrusive_list->head, node);
+
+    return;
+}
+
+/**
+ * @brief Pops a node from the tail of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to pop from.
+ * @return A pointer to the popped node, or NULL if the list is empty.
+ */
+struct IntrusiveListNode *il_pop(struct IntrusiveList *intrusive_list)
+{
+    struct IntrusiveListNode *node = intrusive_list->tail;
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    il_remove(intrusive_list, node);
+
+    return node;
+}
+
+/**
+ * @brief Pops a node from the head of an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to pop from.
+ * @return A pointer to the popped node, or NULL if the list is empty.
+ */
+struct IntrusiveListNode *il_pop_front(struct IntrusiveList *intrusive_list)
+{
+    struct IntrusiveListNode *node = intrusive_list->head;
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    il_remove(intrusive_list, node);
+
+    return node;
+}
+
+/**
+ * @brief Inserts a node before another node in an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to insert into.
+ * @param node A pointer to the node to insert before.
+ * @param new_node A pointer to the node to insert.
+ * @return void
+ */
+void il_insert_before(struct IntrusiveList *intrusive_list,
+                      struct IntrusiveListNode *node,
+                      struct IntrusiveListNode *new_node)
+{
+    il_link(intrusive_list, node->prev, node, new_node);
+
+    return;
+}
+
+/**
+ * @brief Inserts a node after another node in an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to insert into.
+ * @param node A pointer to the node to insert after.
+ * @param new_node A pointer to the node to insert.
+ * @return void
+ */
+void il_insert_after(struct IntrusiveList *intrusive_list,
+                     struct IntrusiveListNode *node,
+                     struct IntrusiveListNode *new_node)
+{
+    il_link(intrusive_list, node, node->next, new_node);
+
+    return;
+}
+
+/**
+ * @brief Removes a node from an intrusive list.
+ * @param intrusive_list A pointer to the intrusive list to remove from.
+ * @param node A pointer to the node to remove.
+ * @return void
+ *
+ * The links of the removed node are cleared, so that stale uses of it fail fast.
+ */
+void il_remove(struct IntrusiveList *intrusive_list, struct IntrusiveListNode *node)
+{
+    if (node->prev == NULL)
+    {
+        intrusive_list->head = node->next;
+    }
+    else
+    {
+        node->prev->next = node->next;
+    }
+
+    if (node->next == NULL)
+    {
+        intrusive_list->tail = node->prev;
+    }
+    else
+    {
+        node->next->prev = node->prev;
+    }
+
+    node->prev = NULL;
+    node->next = NULL;
+
+    intrusive_list->size--;
+
+    return;
+}
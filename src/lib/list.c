@@ -4,7 +4,44 @@
 
 #include <stdlib.h>
 
+#include "lib/allocator.h"
 #include "lib/list.h"
+#include "lib/pool.h"
+
+/**
+ * @brief Allocates a node for a linked list.
+ * @param linked_list A pointer to the linked list the node is for.
+ * @return A pointer to the allocated node, or NULL if the allocation failed.
+ */
+static struct LinkedListNode *ll_alloc_node(struct LinkedList *linked_list)
+{
+    if (linked_list->node_pool != NULL)
+    {
+        return pool_alloc(linked_list->node_pool);
+    }
+
+    return allocator_alloc(linked_list->allocator, sizeof(struct LinkedListNode));
+}
+
+/**
+ * @brief Frees a node of a linked list.
+ * @param linked_list A pointer to the linked list the node was allocated for.
+ * @param node A pointer to the node to free.
+ * @return void
+ */
+static void ll_free_node(struct LinkedList *linked_list, struct LinkedListNode *node)
+{
+    if (linked_list->node_pool != NULL)
+    {
+        pool_release(linked_list->node_pool, node);
+    }
+    else
+    {
+        allocator_free(linked_list->allocator, node, sizeof(struct LinkedListNode));
+    }
+
+    return;
+}
 
 /**
  * @brief Creates a new linked list.
@@ -13,7 +50,20 @@
  */
 struct LinkedList *ll_create(ValueCompareFunction value_compare_function)
 {
-    struct LinkedList *linked_list = malloc(sizeof(struct LinkedList));
+    return ll_create_with_allocator(value_compare_function, NULL);
+}
+
+/**
+ * @brief Creates a new linked list that allocates from an allocator.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created linked list.
+ */
+struct LinkedList *ll_create_with_allocator(ValueCompareFunction value_compare_function,
+                                            const struct Allocator *allocator)
+{
+    struct LinkedList *linked_list =
+        allocator_alloc(allocator, sizeof(struct LinkedList));
     if (linked_list == NULL)
     {
         return NULL;
@@ -23,6 +73,32 @@ struct LinkedList *ll_create(ValueCompareFunction value_compare_function)
     linked_list->head = NULL;
     linked_list->tail = NULL;
     linked_list->value_compare_function = value_compare_function;
+    linked_list->node_pool = NULL;
+    linked_list->allocator = allocator;
+
+    return linked_list;
+}
+
+/**
+ * @brief Creates a new linked list that allocates its nodes from a pool.
+ * @param value_compare_function A function that compares two values in the list.
+ * @param node_pool A pointer to a pool of objects of sizeof(struct LinkedListNode)
+ *                  bytes. The pool may be shared by many lists and must outlive them.
+ * @return A pointer to the created linked list.
+ *
+ * The list itself is allocated from the allocator of the pool.
+ */
+struct LinkedList *ll_create_with_pool(ValueCompareFunction value_compare_function,
+                                       struct Pool *node_pool)
+{
+    struct LinkedList *linked_list =
+        ll_create_with_allocator(value_compare_function, node_pool->allocator);
+    if (linked_list == NULL)
+    {
+        return NULL;
+    }
+
+    linked_list->node_pool = node_pool;
 
     return linked_list;
 }
@@ -35,6 +111,12 @@ struct LinkedList *ll_create(ValueCompareFunction value_compare_function)
  */
 void ll_free(struct LinkedList *linked_list, ValueFreeFunction value_free_function)
 {
+    if (value_free_function == NULL &&
+        !allocator_frees_individually(linked_list->allocator))
+    {
+        return;
+    }
+
     struct LinkedListNode *current_node = linked_list->head;
 
     while (current_node != NULL)
@@ -45,11 +127,11 @@ void ll_free(struct LinkedList *linked_list, ValueFreeFunction value_free_functi
             value_free_function(current_node->value);
         }
 
-        free(current_node);
+        ll_free_node(linked_list, current_node);
         current_node = next_node;
     }
 
-    free(linked_list);
+    allocator_free(linked_list->allocator, linked_list, sizeof(struct LinkedList));
 
     return;
 }
@@ -108,7 +190,7 @@ struct LinkedListNode *ll_get_node_by_value(struct LinkedList *linked_list, void
  */
 int ll_push(struct LinkedList *linked_list, void *value)
 {
-    struct LinkedListNode *new_node = malloc(sizeof(struct LinkedListNode));
+    struct LinkedListNode *new_node = ll_alloc_node(linked_list);
     if (new_node == NULL)
     {
         return -1;
@@ -149,7 +231,7 @@ void *ll_pop(struct LinkedList *linked_list)
     {
         void *value = linked_list->tail->value;
 
-        free(linked_list->tail);
+        ll_free_node(linked_list, linked_list->tail);
 
         linked_list->head = NULL;
         linked_list->tail = NULL;
@@ -172,11 +254,100 @@ void *ll_pop(struct LinkedList *linked_list)
     linked_list->tail->next = NULL;
     linked_list->size--;
 
-    free(popped_node);
+    ll_free_node(linked_list, popped_node);
+
+    return value;
+}
+
+/**
+ * @brief Pushes a value onto the head of a linked list.
+ * @param linked_list A pointer to the linked list to push onto.
+ * @param value A pointer to the value to push.
+ * @return 0 if the value was pushed successfully, -1 otherwise.
+ */
+int ll_push_front(struct LinkedList *linked_list, void *value)
+{
+    struct LinkedListNode *new_node = ll_alloc_node(linked_list);
+    if (new_node == NULL)
+    {
+        return -1;
+    }
+
+    new_node->value = value;
+    new_node->next = linked_list->head;
+
+    if (linked_list->size == 0)
+    {
+        linked_list->tail = new_node;
+    }
+
+    linked_list->head = new_node;
+    linked_list->size++;
+
+    return 0;
+}
+
+/**
+ * @brief Pops a value from the head of a linked list.
+ * @param linked_list A pointer to the linked list to pop from.
+ * @return A pointer to the popped value, or NULL if the list is empty.
+ *
+ * Together with ll_push, this makes the list a FIFO queue with constant time
+ * operations.
+ */
+void *ll_pop_front(struct LinkedList *linked_list)
+{
+    struct LinkedListNode *popped_node = linked_list->head;
+    if (popped_node == NULL)
+    {
+        return NULL;
+    }
+
+    void *value = popped_node->value;
+
+    linked_list->head = popped_node->next;
+    linked_list->size--;
+
+    if (linked_list->size == 0)
+    {
+        linked_list->tail = NULL;
+    }
+
+    ll_free_node(linked_list, popped_node);
 
     return value;
 }
 
+/**
+ * @brief Gets the value at the head of a linked list without removing it.
+ * @param linked_list A pointer to the linked list to peek at.
+ * @return A pointer to the value, or NULL if the list is empty.
+ */
+void *ll_peek_front(struct LinkedList *linked_list)
+{
+    if (linked_list->head == NULL)
+    {
+        return NULL;
+    }
+
+    return linked_list->head->value;
+}
+
+/**
+ * @brief Gets the value at the tail of a linked list without removing it.
+ * @param linked_list A pointer to the linked list to peek at.
+ * @return A pointer to the value, or NULL if the list is empty.
+ */
+void *ll_peek_back(struct LinkedList *linked_list)
+{
+    if (linked_list->tail == NULL)
+    {
+        return NULL;
+    }
+
+    return linked_list->tail->value;
+}
+
 /**
  * @brief Inserts a value before a node in a linked list.
  * @param linked_list A pointer to the linked list to insert into.
@@ -187,7 +358,24 @@ void *ll_pop(struct LinkedList *linked_list)
 int ll_insert_before_node(struct LinkedList *linked_list, struct LinkedListNode *node,
                           void *value)
 {
-    struct LinkedListNode *new_node = malloc(sizeof(struct LinkedListNode));
+    struct LinkedListNode *previous_node = NULL;
+
+    if (node != linked_list->head)
+    {
+        previous_node = linked_list->head;
+
+        while (previous_node != NULL && previous_node->next != node)
+        {
+            previous_node = previous_node->next;
+        }
+
+        if (previous_node == NULL)
+        {
+            return -1;
+        }
+    }
+
+    struct LinkedListNode *new_node = ll_alloc_node(linked_list);
     if (new_node == NULL)
     {
         return -1;
@@ -196,32 +384,18 @@ int ll_insert_before_node(struct LinkedList *linked_list, struct LinkedListNode
     new_node->value = value;
     new_node->next = node;
 
-    if (node == linked_list->head)
+    if (previous_node == NULL)
     {
         linked_list->head = new_node;
-        linked_list->size++;
-
-        return 0;
     }
     else
     {
-        struct LinkedListNode *current_node = linked_list->head;
-
-        while (current_node != NULL)
-        {
-            if (current_node->next == node)
-            {
-                current_node->next = new_node;
-                linked_list->size++;
-
-                return 0;
-            }
-
-            return -1;
-        }
+        previous_node->next = new_node;
     }
 
-    return -1;
+    linked_list->size++;
+
+    return 0;
 }
 
 /**
@@ -263,7 +437,7 @@ int ll_insert_after_node(struct LinkedList *linked_list, struct LinkedListNode *
         return -1;
     }
 
-    struct LinkedListNode *new_node = malloc(sizeof(struct LinkedListNode));
+    struct LinkedListNode *new_node = ll_alloc_node(linked_list);
     if (new_node == NULL)
     {
         return -1;
@@ -321,7 +495,7 @@ int ll_remove_node(struct LinkedList *linked_list, struct LinkedListNode *node)
             linked_list->tail = NULL;
         }
 
-        free(node);
+        ll_free_node(linked_list, node);
 
         return 0;
     }
@@ -338,7 +512,7 @@ int ll_remove_node(struct LinkedList *linked_list, struct LinkedListNode *node)
                 linked_list->tail = current_node;
             }
 
-            free(node);
+            ll_free_node(linked_list, node);
 
             return 0;
         }
@@ -365,3 +539,88 @@ int ll_remove_value(struct LinkedList *linked_list, void *value)
 
     return ll_remove_node(linked_list, node);
 }
+
+/**
+ * @brief Starts iterating over a linked list.
+ * @param linked_list A pointer to the linked list to iterate over.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return void
+ */
+void ll_iter_begin(struct LinkedList *linked_list, struct LinkedListIterator *iterator)
+{
+    iterator->linked_list = linked_list;
+    iterator->previous = NULL;
+    iterator->current = NULL;
+    iterator->next = linked_list->head;
+
+    return;
+}
+
+/**
+ * @brief Advances an iterator to the next node of its linked list.
+ * @param iterator A pointer to the iterator to advance.
+ * @return A pointer to the next node, or NULL if every node has been returned.
+ *
+ * The node after the returned one is saved before returning it, so removing the
+ * returned node does not lose the position of the iterator.
+ */
+struct LinkedListNode *ll_iter_next(struct LinkedListIterator *iterator)
+{
+    if (iterator->current != NULL)
+    {
+        iterator->previous = iterator->current;
+    }
+
+    iterator->current = iterator->next;
+
+    if (iterator->current == NULL)
+    {
+        return NULL;
+    }
+
+    iterator->next = iterator->current->next;
+
+    return iterator->current;
+}
+
+/**
+ * @brief Removes the node last returned by an iterator from its linked list.
+ * @param iterator A pointer to the iterator.
+ * @return A pointer to the value of the removed node, or NULL if there is no node to
+ *         remove.
+ *
+ * The iterator remembers the node before the returned one, so unlinking takes
+ * constant time instead of searching the list like ll_remove_node.
+ */
+void *ll_iter_remove(struct LinkedListIterator *iterator)
+{
+    struct LinkedList *linked_list = iterator->linked_list;
+    struct LinkedListNode *node = iterator->current;
+
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    if (iterator->previous == NULL)
+    {
+        linked_list->head = iterator->next;
+    }
+    else
+    {
+        iterator->previous->next = iterator->next;
+    }
+
+    if (linked_list->tail == node)
+    {
+        linked_list->tail = iterator->previous;
+    }
+
+    linked_list->size--;
+    iterator->current = NULL;
+
+    void *value = node->value;
+    ll_free_node(linked_list, node);
+
+    return value;
+}
@@ -0,0 +1,190 @@
+/**
+ * @brief A fixed size object pool that carves objects out of large slabs.
+ */
+
+#include <stddef.h>
+
+#include "lib/allocator.h"
+#include "lib/pool.h"
+
+/**
+ * @brief Rounds a size up to a multiple of POOL_ALIGNMENT.
+ * @param size The size to round up.
+ * @return The rounded size.
+ */
+static size_t pool_align(size_t size)
+{
+    return (size + POOL_ALIGNMENT - 1) & ~(size_t)(POOL_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Adds a new slab to a pool.
+ * @param pool A pointer to the pool to grow.
+ * @return 0 if the slab was added successfully, -1 otherwise.
+ */
+static int pool_grow(struct Pool *pool)
+{
+    size_t header_size = pool_align(sizeof(struct PoolSlab));
+    size_t slab_size = header_size + pool->slab_objects * pool->object_size;
+
+    struct PoolSlab *slab = allocator_alloc(pool->allocator, slab_size);
+    if (slab == NULL)
+    {
+        return -1;
+    }
+
+    slab->next = pool->slabs;
+    slab->size = slab_size;
+    pool->slabs = slab;
+    pool->slab_cursor = (char *)slab + header_size;
+    pool->slab_end = (char *)slab + slab_size;
+
+    if (pool->slab_objects < pool->max_objects_per_slab)
+    {
+        pool->slab_objects *= 2;
+
+        if (pool->slab_objects > pool->max_objects_per_slab)
+        {
+            pool->slab_objects = pool->max_objects_per_slab;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Creates a new pool.
+ * @param object_size The size of the objects in the pool.
+ * @param max_objects_per_slab The maximum number of objects allocated at once.
+ * @return A pointer to the created pool.
+ */
+struct Pool *pool_create(size_t object_size, size_t max_objects_per_slab)
+{
+    return pool_create_with_allocator(object_size, max_objects_per_slab, NULL);
+}
+
+/**
+ * @brief Creates a new pool that allocates its slabs from an allocator.
+ * @param object_size The size of the objects in the pool.
+ * @param max_objects_per_slab The maximum number of objects allocated at once.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created pool.
+ *
+ * No memory for objects is allocated until the first call to pool_alloc.
+ */
+struct Pool *pool_create_with_allocator(size_t object_size, size_t max_objects_per_slab,
+                                        const struct Allocator *allocator)
+{
+    struct Pool *pool = allocator_alloc(allocator, sizeof(struct Pool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    if (object_size < sizeof(void *))
+    {
+        object_size = sizeof(void *);
+    }
+
+    if (max_objects_per_slab < POOL_MIN_SLAB_OBJECTS)
+    {
+        max_objects_per_slab = POOL_MIN_SLAB_OBJECTS;
+    }
+
+    pool->object_size = pool_align(object_size);
+    pool->max_objects_per_slab = max_objects_per_slab;
+    pool->slab_objects = POOL_MIN_SLAB_OBJECTS;
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->slab_cursor = NULL;
+    pool->slab_end = NULL;
+    pool->allocator = allocator;
+
+    return pool;
+}
+
+/**
+ * @brief Frees a pool and every object allocated from it.
+ * @param pool A pointer to the pool to free.
+ * @return void
+ */
+void pool_free(struct Pool *pool)
+{
+    if (!allocator_frees_individually(pool->allocator))
+    {
+        return;
+    }
+
+    struct PoolSlab *current_slab = pool->slabs;
+
+    while (current_slab != NULL)
+    {
+        struct PoolSlab *next_slab = current_slab->next;
+
+        allocator_free(pool->allocator, current_slab, current_slab->size);
+        current_slab = next_slab;
+    }
+
+    allocator_free(pool->allocator, pool, sizeof(struct Pool));
+
+    return;
+}
+
+/**
+ * @brief Allocates an object from a pool.
+ * @param pool A pointer to the pool to allocate from.
+ * @return A pointer to the allocated object, or NULL if the allocation failed.
+ */
+void *pool_alloc(struct Pool *pool)
+{
+    if (pool->free_list != NULL)
+    {
+        void *object = pool->free_list;
+        pool->free_list = *(void **)object;
+
+        return object;
+    }
+
+    if (pool->slab_cursor == pool->slab_end && pool_grow(pool) != 0)
+    {
+        return NULL;
+    }
+
+    void *object = pool->slab_cursor;
+    pool->slab_cursor += pool->object_size;
+
+    return object;
+}
+
+/**
+ * @brief Returns an object to a pool so that it can be allocated again.
+ * @param pool A pointer to the pool the object was allocated from.
+ * @param object A pointer to the object to return.
+ * @return void
+ */
+void pool_release(struct Pool *pool, void *object)
+{
+    *(void **)object = pool->free_list;
+    pool->free_list = object;
+
+    return;
+}
+
+/**
+ * @brief Gets the number of bytes a pool has allocated.
+ * @param pool A pointer to the pool.
+ * @return The size of the pool and all of its slabs, in bytes.
+ *
+ * Released objects still count, as their memory stays with the pool.
+ */
+size_t pool_bytes(struct Pool *pool)
+{
+    size_t bytes = sizeof(struct Pool);
+
+    for (struct PoolSlab *slab = pool->slabs; slab != NULL; slab = slab->next)
+    {
+        bytes += slab->size;
+    }
+
+    return bytes;
+}
@@ -0,0 +1,275 @@
+/**
+ * @brief Bounded lock-free queues for handing values from one thread to another.
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "lib/allocator.h"
+#include "lib/queue.h"
+
+/**
+ * @brief Rounds a capacity up to the next power of two.
+ * @param capacity The capacity to round up.
+ * @return The smallest power of two that is at least capacity, and at least 1.
+ */
+static size_t queue_round_capacity(size_t capacity)
+{
+    size_t rounded_capacity = 1;
+
+    while (rounded_capacity < capacity)
+    {
+        rounded_capacity *= 2;
+    }
+
+    return rounded_capacity;
+}
+
+/**
+ * @brief Creates a new single-producer single-consumer ring.
+ * @param capacity The number of values the ring holds, rounded up to a power of two.
+ * @return A pointer to the created ring.
+ */
+struct SpscRing *spsc_create(size_t capacity)
+{
+    return spsc_create_with_allocator(capacity, NULL);
+}
+
+/**
+ * @brief Creates a new single-producer single-consumer ring that allocates from an
+ *        allocator.
+ * @param capacity The number of values the ring holds, rounded up to a power of two.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created ring.
+ */
+struct SpscRing *spsc_create_with_allocator(size_t capacity,
+                                            const struct Allocator *allocator)
+{
+    struct SpscRing *ring = allocator_alloc(allocator, sizeof(struct SpscRing));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+
+    capacity = queue_round_capacity(capacity);
+
+    ring->slots = allocator_alloc(allocator, capacity * sizeof(void *));
+    if (ring->slots == NULL)
+    {
+        allocator_free(allocator, ring, sizeof(struct SpscRing));
+
+        return NULL;
+    }
+
+    ring->capacity = capacity;
+    ring->allocator = allocator;
+    atomic_init(&ring->head, 0);
+    ring->cached_tail = 0;
+    atomic_init(&ring->tail, 0);
+    ring->cached_head = 0;
+
+    return ring;
+}
+
+/**
+ * @brief Frees a single-producer single-consumer ring.
+ * @param ring A pointer to the ring to free.
+ * @return void
+ */
+void spsc_free(struct SpscRing *ring)
+{
+    allocator_free(ring->allocator, ring->slots, ring->capacity * sizeof(void *));
+    allocator_free(ring->allocator, ring, sizeof(struct SpscRing));
+
+    return;
+}
+
+/**
+ * @brief Pushes a value onto a single-producer single-consumer ring.
+ * @param ring A pointer to the ring to push onto. Only one thread may push.
+ * @param value The value to push, which may not be NULL.
+ * @return 0 if the value was pushed, -1 if the ring is full.
+ */
+int spsc_push(struct SpscRing *ring, void *value)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (tail - ring->cached_head == ring->capacity)
+    {
+        ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        if (tail - ring->cached_head == ring->capacity)
+        {
+            return -1;
+        }
+    }
+
+    ring->slots[tail & (ring->capacity - 1)] = value;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return 0;
+}
+
+/**
+ * @brief Pops the oldest value from a single-producer single-consumer ring.
+ * @param ring A pointer to the ring to pop from. Only one thread may pop.
+ * @return The popped value, or NULL if the ring is empty.
+ */
+void *spsc_pop(struct SpscRing *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    if (head == ring->cached_tail)
+    {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+        if (head == ring->cached_tail)
+        {
+            return NULL;
+        }
+    }
+
+    void *value = ring->slots[head & (ring->capacity - 1)];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return value;
+}
+
+/**
+ * @brief Creates a new multi-producer single-consumer queue.
+ * @param capacity The number of values the queue holds, rounded up to a power of two
+ *                 and to at least MPSC_MIN_CAPACITY.
+ * @return A pointer to the created queue.
+ */
+struct MpscQueue *mpsc_create(size_t capacity)
+{
+    return mpsc_create_with_allocator(capacity, NULL);
+}
+
+/**
+ * @brief Creates a new multi-producer single-consumer queue that allocates from an
+ *        allocator.
+ * @param capacity The number of values the queue holds, rounded up to a power of two
+ *                 and to at least MPSC_MIN_CAPACITY.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created queue.
+ */
+struct MpscQueue *mpsc_create_with_allocator(size_t capacity,
+                                             const struct Allocator *allocator)
+{
+    struct MpscQueue *queue = allocator_alloc(allocator, sizeof(struct MpscQueue));
+    if (queue == NULL)
+    {
+        return NULL;
+    }
+
+    if (capacity < MPSC_MIN_CAPACITY)
+    {
+        capacity = MPSC_MIN_CAPACITY;
+    }
+
+    capacity = queue_round_capacity(capacity);
+
+    queue->cells = allocator_alloc(allocator, capacity * sizeof(struct MpscQueueCell));
+    if (queue->cells == NULL)
+    {
+        allocator_free(allocator, queue, sizeof(struct MpscQueue));
+
+        return NULL;
+    }
+
+    for (size_t i = 0; i < capacity; i++)
+    {
+        atomic_init(&queue->cells[i].sequence, i);
+        queue->cells[i].value = NULL;
+    }
+
+    queue->capacity = capacity;
+    queue->allocator = allocator;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+
+    return queue;
+}
+
+/**
+ * @brief Frees a multi-producer single-consumer queue.
+ * @param queue A pointer to the queue to free.
+ * @return void
+ */
+void mpsc_free(struct MpscQueue *queue)
+{
+    allocator_free(queue->allocator, queue->cells,
+                   queue->capacity * sizeof(struct MpscQueueCell));
+    allocator_free(queue->allocator, queue, sizeof(struct MpscQueue));
+
+    return;
+}
+
+/**
+ * @brief Pushes a value onto a multi-producer single-consumer queue.
+ * @param queue A pointer to the queue to push onto. Any number of threads may push.
+ * @param value The value to push, which may not be NULL.
+ * @return 0 if the value was pushed, -1 if the queue is full.
+ */
+int mpsc_push(struct MpscQueue *queue, void *value)
+{
+    size_t position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    for (;;)
+    {
+        struct MpscQueueCell *cell = &queue->cells[position & (queue->capacity - 1)];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t)(sequence - position);
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position,
+                                                      position + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+            {
+                cell->value = value;
+                atomic_store_explicit(&cell->sequence, position + 1,
+                                      memory_order_release);
+
+                return 0;
+            }
+        }
+        else if (difference < 0)
+        {
+            return -1;
+        }
+        else
+        {
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Pops the oldest value from a multi-producer single-consumer queue.
+ * @param queue A pointer to the queue to pop from. Only one thread may pop.
+ * @return The popped value, or NULL if the queue is empty.
+ *
+ * A value whose producer has claimed its cell but not yet filled it counts as not
+ * pushed yet, so the queue may look empty for a moment while a push is underway.
+ */
+void *mpsc_pop(struct MpscQueue *queue)
+{
+    size_t position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    struct MpscQueueCell *cell = &queue->cells[position & (queue->capacity - 1)];
+
+    if (atomic_load_explicit(&cell->sequence, memory_order_acquire) != position + 1)
+    {
+        return NULL;
+    }
+
+    void *value = cell->value;
+
+    atomic_store_explicit(&cell->sequence, position + queue->capacity,
+                          memory_order_release);
+    atomic_store_explicit(&queue->head, position + 1, memory_order_relaxed);
+
+    return value;
+}
@@ -0,0 +1,682 @@
+/**
+ * @brief A lock-free ordered set of generic values, kept in a skip list.
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lib/allocator.h"
+#include "lib/epoch.h"
+#include "lib/ilist.h"
+#include "lib/list.h"
+#include "lib/skiplist.h"
+
+/**
+ * @brief The state of the random number generator that picks node heights.
+ *
+ * Every thread has its own state, so picking a height never touches shared memory.
+ */
+static _Thread_local uint64_t sl_random_state = 0;
+
+/**
+ * @brief Checks if a next pointer of a node is marked.
+ * @param link The next pointer to check.
+ * @return 1 if the node the pointer belongs to is being removed, 0 otherwise.
+ */
+static int sl_is_marked(uintptr_t link)
+{
+    return (int)(link & 1);
+}
+
+/**
+ * @brief Gets the node a next pointer points to, without its mark.
+ * @param link The next pointer.
+ * @return A pointer to the node, or NULL if the pointer ends its level.
+ */
+static struct SkipListNode *sl_node(uintptr_t link)
+{
+    return (struct SkipListNode *)(link & ~(uintptr_t)1);
+}
+
+/**
+ * @brief Gets the size of the allocation holding a node.
+ * @param height The number of levels the node is on.
+ * @return The size of the node and its next pointers.
+ */
+static size_t sl_node_size(int height)
+{
+    return sizeof(struct SkipListNode) + (size_t)height * sizeof(_Atomic(uintptr_t));
+}
+
+/**
+ * @brief Picks the number of levels of a new node.
+ * @return A height between 1 and SL_MAX_HEIGHT, where every height is half as
+ *         likely as the one below it.
+ *
+ * The generator is a xorshift seeded from the address of its state, which differs
+ * between threads.
+ */
+static int sl_random_height(void)
+{
+    if (sl_random_state == 0)
+    {
+        sl_random_state = (uint64_t)(uintptr_t)&sl_random_state * 0x9E3779B97F4A7C15ULL;
+        sl_random_state |= 1;
+    }
+
+    sl_random_state ^= sl_random_state << 13;
+    sl_random_state ^= sl_random_state >> 7;
+    sl_random_state ^= sl_random_state << 17;
+
+    int height = 1;
+    uint64_t bits = sl_random_state;
+
+    while (height < SL_MAX_HEIGHT && (bits & 1))
+    {
+        height++;
+        bits >>= 1;
+    }
+
+    return height;
+}
+
+/**
+ * @brief Allocates a node of a skip list.
+ * @param skip_list A pointer to the skip list the node is for.
+ * @param value A pointer to the value of the node.
+ * @param height The number of levels the node is on.
+ * @return A pointer to the node, or NULL if the allocation failed.
+ *
+ * The node starts out with two references, one for the thread adding it and one
+ * for the thread that will remove it.
+ */
+static struct SkipListNode *sl_create_node(struct SkipList *skip_list, void *value,
+                                           int height)
+{
+    struct SkipListNode *node =
+        allocator_alloc(skip_list->allocator, sl_node_size(height));
+    if (node == NULL)
+    {
+        return NULL;
+    }
+
+    node->value = value;
+    node->height = height;
+    atomic_init(&node->references, 2);
+
+    for (int i = 0; i < height; i++)
+    {
+        atomic_init(&node->next[i], 0);
+    }
+
+    return node;
+}
+
+/**
+ * @brief Frees a node of a skip list.
+ * @param skip_list A pointer to the skip list the node belonged to.
+ * @param node A pointer to the node to free.
+ * @return void
+ */
+static void sl_free_node(struct SkipList *skip_list, struct SkipListNode *node)
+{
+    allocator_free(skip_list->allocator, node, sl_node_size(node->height));
+
+    return;
+}
+
+/**
+ * @brief Frees a retired node of a skip list.
+ * @param epoch_node A pointer to the reclamation state of the node.
+ * @param context A pointer to the skip list the node belonged to.
+ * @return void
+ */
+static void sl_free_retired_node(struct EpochNode *epoch_node, void *context)
+{
+    sl_free_node(context, container_of(epoch_node, struct SkipListNode, epoch_node));
+
+    return;
+}
+
+/**
+ * @brief Finds the nodes around the place a value belongs on every level, unless a
+ *        concurrent change gets in the way.
+ * @param skip_list A pointer to the skip list to search. The caller is inside an
+ *                  epoch critical section.
+ * @param value A pointer to the value to search for.
+ * @param predecessors An array of SL_MAX_HEIGHT pointers that is set to the last
+ *                     node before the value on each level.
+ * @param successors An array of SL_MAX_HEIGHT pointers that is set to the first
+ *                   node on each level that is not smaller than the value.
+ * @return 1 if successors[0] holds a value equal to the value, 0 if it does not, or
+ *         -1 if unlinking a marked node failed because its predecessor changed.
+ *
+ * Every marked node walked past is unlinked from its level.
+ */
+static int sl_try_search(struct SkipList *skip_list, void *value,
+                         struct SkipListNode **predecessors,
+                         struct SkipListNode **successors)
+{
+    ValueCompareFunction value_compare_function = skip_list->value_compare_function;
+    struct SkipListNode *predecessor = skip_list->head;
+
+    for (int level = SL_MAX_HEIGHT - 1; level >= 0; level--)
+    {
+        struct SkipListNode *current = sl_node(
+            atomic_load_explicit(&predecessor->next[level], memory_order_acquire));
+
+        while (current != NULL)
+        {
+            uintptr_t next =
+                atomic_load_explicit(&current->next[level], memory_order_acquire);
+
+            if (sl_is_marked(next))
+            {
+                uintptr_t expected = (uintptr_t)current;
+
+                if (!atomic_compare_exchange_strong_explicit(
+                        &predecessor->next[level], &expected, (uintptr_t)sl_node(next),
+                        memory_order_acq_rel, memory_order_acquire))
+                {
+                    return -1;
+                }
+
+                current = sl_node(next);
+
+                continue;
+            }
+
+            if (value_compare_function(current->value, value) >= 0)
+            {
+                break;
+            }
+
+            predecessor = current;
+            current = sl_node(next);
+        }
+
+        predecessors[level] = predecessor;
+        successors[level] = current;
+    }
+
+    return successors[0] != NULL &&
+           value_compare_function(successors[0]->value, value) == 0;
+}
+
+/**
+ * @brief Finds the nodes around the place a value belongs on every level.
+ * @param skip_list A pointer to the skip list to search. The caller is inside an
+ *                  epoch critical section.
+ * @param value A pointer to the value to search for.
+ * @param predecessors An array of SL_MAX_HEIGHT pointers that is set to the last
+ *                     node before the value on each level.
+ * @param successors An array of SL_MAX_HEIGHT pointers that is set to the first
+ *                   node on each level that is not smaller than the value.
+ * @return 1 if successors[0] holds a value equal to the value, 0 otherwise.
+ *
+ * The search starts over from the head whenever a concurrent change gets in its
+ * way, so the nodes it returns were adjacent and unmarked at some point during the
+ * call.
+ */
+static int sl_search(struct SkipList *skip_list, void *value,
+                     struct SkipListNode **predecessors,
+                     struct SkipListNode **successors)
+{
+    for (;;)
+    {
+        int found = sl_try_search(skip_list, value, predecessors, successors);
+
+        if (found >= 0)
+        {
+            return found;
+        }
+    }
+}
+
+/**
+ * @brief Finds the first node that is not smaller than a value, without writing.
+ * @param skip_list A pointer to the skip list to search. The caller is inside an
+ *                  epoch critical section.
+ * @param value A pointer to the value to search for, or NULL for the first node.
+ * @return A pointer to the node, or NULL if every value is smaller.
+ *
+ * Marked nodes are stepped over instead of being unlinked, so readers never
+ * contend with writers for a cache line.
+ */
+static struct SkipListNode *sl_lower_bound(struct SkipList *skip_list, void *value)
+{
+    ValueCompareFunction value_compare_function = skip_list->value_compare_function;
+    struct SkipListNode *predecessor = skip_list->head;
+    struct SkipListNode *current = NULL;
+
+    for (int level = SL_MAX_HEIGHT - 1; level >= 0; level--)
+    {
+        current = sl_node(
+            atomic_load_explicit(&predecessor->next[level], memory_order_acquire));
+
+        while (current != NULL)
+        {
+            uintptr_t next =
+                atomic_load_explicit(&current->next[level], memory_order_acquire);
+
+            if (!sl_is_marked(next))
+            {
+                if (value == NULL ||
+                    value_compare_function(current->value, value) >= 0)
+                {
+                    break;
+                }
+
+                predecessor = current;
+            }
+
+            current = sl_node(next);
+        }
+    }
+
+    return current;
+}
+
+/**
+ * @brief Lets go of a node, and retires it if no other thread still holds it.
+ * @param skip_list A pointer to the skip list the node belongs to. The caller is
+ *                  inside an epoch critical section.
+ * @param node A pointer to the node to let go of.
+ * @return void
+ *
+ * The last of the adding and removing threads to let go searches for the value of
+ * the node once more. The node is marked on every level by then, and no thread
+ * links it anywhere any more, so the search unlinks it for good before it is
+ * retired.
+ */
+static void sl_release(struct SkipList *skip_list, struct SkipListNode *node)
+{
+    struct SkipListNode *predecessors[SL_MAX_HEIGHT];
+    struct SkipListNode *successors[SL_MAX_HEIGHT];
+
+    if (atomic_fetch_sub(&node->references, 1) != 1)
+    {
+        return;
+    }
+
+    sl_search(skip_list, node->value, predecessors, successors);
+    epoch_retire(&node->epoch_node, sl_free_retired_node, skip_list);
+
+    return;
+}
+
+/**
+ * @brief Links a node into the levels above the lowest one.
+ * @param skip_list A pointer to the skip list the node is in. The caller is inside
+ *                  an epoch critical section.
+ * @param node A pointer to the node, which is already on the lowest level.
+ * @param predecessors The predecessors of the node on each level.
+ * @param successors The successors of the node on each level.
+ * @return void
+ *
+ * Linking stops early once the node is being removed, either because one of its
+ * next pointers is marked and can no longer be set, or because it has left the
+ * lowest level.
+ */
+static void sl_link_upper_levels(struct SkipList *skip_list, struct SkipListNode *node,
+                                 struct SkipListNode **predecessors,
+                                 struct SkipListNode **successors)
+{
+    for (int level = 1; level < node->height; level++)
+    {
+        for (;;)
+        {
+            uintptr_t next =
+                atomic_load_explicit(&node->next[level], memory_order_acquire);
+
+            if (sl_is_marked(next))
+            {
+                return;
+            }
+
+            if (sl_node(next) != successors[level] &&
+                !atomic_compare_exchange_strong(&node->next[level], &next,
+                                                (uintptr_t)successors[level]))
+            {
+                return;
+            }
+
+            uintptr_t expected = (uintptr_t)successors[level];
+
+            if (atomic_compare_exchange_strong_explicit(
+                    &predecessors[level]->next[level], &expected, (uintptr_t)node,
+                    memory_order_release, memory_order_relaxed))
+            {
+                break;
+            }
+
+            sl_search(skip_list, node->value, predecessors, successors);
+
+            if (successors[0] != node)
+            {
+                return;
+            }
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Creates a new skip list.
+ * @param value_compare_function A function that orders two values.
+ * @return A pointer to the created skip list.
+ */
+struct SkipList *sl_create(ValueCompareFunction value_compare_function)
+{
+    return sl_create_with_allocator(value_compare_function, NULL);
+}
+
+/**
+ * @brief Creates a new skip list that allocates from an allocator.
+ * @param value_compare_function A function that orders two values.
+ * @param allocator A pointer to a thread safe allocator to allocate from, or NULL
+ *                  for malloc.
+ * @return A pointer to the created skip list.
+ *
+ * The head node is on every level and holds no value.
+ */
+struct SkipList *sl_create_with_allocator(ValueCompareFunction value_compare_function,
+                                          const struct Allocator *allocator)
+{
+    struct SkipList *skip_list = allocator_alloc(allocator, sizeof(struct SkipList));
+    if (skip_list == NULL)
+    {
+        return NULL;
+    }
+
+    skip_list->value_compare_function = value_compare_function;
+    skip_list->allocator = allocator;
+    atomic_init(&skip_list->size, 0);
+
+    skip_list->head = sl_create_node(skip_list, NULL, SL_MAX_HEIGHT);
+    if (skip_list->head == NULL)
+    {
+        allocator_free(allocator, skip_list, sizeof(struct SkipList));
+
+        return NULL;
+    }
+
+    return skip_list;
+}
+
+/**
+ * @brief Frees a skip list.
+ * @param skip_list A pointer to the skip list to free. No other thread may be using
+ *                  it, and the calling thread may not be inside an epoch critical
+ *                  section.
+ * @param value_free_function A function that frees a value in the skip list. Pass
+ *                            NULL if the values do not need to be freed.
+ * @return void
+ *
+ * Nodes the skip list retired are freed first, since freeing them uses the skip
+ * list. Every node still on the lowest level after that holds a value.
+ */
+void sl_free(struct SkipList *skip_list, ValueFreeFunction value_free_function)
+{
+    epoch_synchronize();
+
+    struct SkipListNode *current_node = sl_node(
+        atomic_load_explicit(&skip_list->head->next[0], memory_order_relaxed));
+
+    while (current_node != NULL)
+    {
+        struct SkipListNode *next_node = sl_node(
+            atomic_load_explicit(&current_node->next[0], memory_order_relaxed));
+
+        if (value_free_function != NULL)
+        {
+            value_free_function(current_node->value);
+        }
+
+        sl_free_node(skip_list, current_node);
+        current_node = next_node;
+    }
+
+    sl_free_node(skip_list, skip_list->head);
+    allocator_free(skip_list->allocator, skip_list, sizeof(struct SkipList));
+
+    return;
+}
+
+/**
+ * @brief Adds a value to a skip list.
+ * @param skip_list A pointer to the skip list to add to.
+ * @param value A pointer to the value to add.
+ * @return 0 if the value was added, 1 if an equal value is already in the skip
+ *         list, or -1 if an allocation failed.
+ *
+ * The node is only allocated once the value is known to be missing, and is freed
+ * again right away if an equal value wins the race to be linked first. The value
+ * is in the skip list as soon as the node is on the lowest level.
+ */
+int sl_insert(struct SkipList *skip_list, void *value)
+{
+    struct SkipListNode *predecessors[SL_MAX_HEIGHT];
+    struct SkipListNode *successors[SL_MAX_HEIGHT];
+    struct SkipListNode *node = NULL;
+
+    if (epoch_enter() != 0)
+    {
+        return -1;
+    }
+
+    for (;;)
+    {
+        if (sl_search(skip_list, value, predecessors, successors))
+        {
+            if (node != NULL)
+            {
+                sl_free_node(skip_list, node);
+            }
+
+            epoch_exit();
+
+            return 1;
+        }
+
+        if (node == NULL)
+        {
+            node = sl_create_node(skip_list, value, sl_random_height());
+            if (node == NULL)
+            {
+                epoch_exit();
+
+                return -1;
+            }
+        }
+
+        for (int i = 0; i < node->height; i++)
+        {
+            atomic_store_explicit(&node->next[i], (uintptr_t)successors[i],
+                                  memory_order_relaxed);
+        }
+
+        uintptr_t expected = (uintptr_t)successors[0];
+
+        if (atomic_compare_exchange_strong_explicit(
+                &predecessors[0]->next[0], &expected, (uintptr_t)node,
+                memory_order_release, memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    atomic_fetch_add(&skip_list->size, 1);
+
+    sl_link_upper_levels(skip_list, node, predecessors, successors);
+    sl_release(skip_list, node);
+
+    epoch_exit();
+
+    return 0;
+}
+
+/**
+ * @brief Gets the value of a skip list that is equal to a value.
+ * @param skip_list A pointer to the skip list to search.
+ * @param value A pointer to the value to search for.
+ * @return A pointer to the value in the skip list, or NULL if there is none.
+ *
+ * The search never writes to shared memory. NULL is also returned if the calling
+ * thread cannot enter an epoch critical section.
+ */
+void *sl_get(struct SkipList *skip_list, void *value)
+{
+    if (epoch_enter() != 0)
+    {
+        return NULL;
+    }
+
+    struct SkipListNode *node = sl_lower_bound(skip_list, value);
+    void *found_value = NULL;
+
+    if (node != NULL && skip_list->value_compare_function(node->value, value) == 0)
+    {
+        found_value = node->value;
+    }
+
+    epoch_exit();
+
+    return found_value;
+}
+
+/**
+ * @brief Removes the value of a skip list that is equal to a value.
+ * @param skip_list A pointer to the skip list to remove from.
+ * @param value A pointer to the value to remove.
+ * @return A pointer to the removed value, or NULL if there is none.
+ *
+ * The upper levels are marked first and the lowest level last. The thread whose
+ * mark on the lowest level sticks is the one that removes the value, so when two
+ * threads remove the same value, exactly one of them gets it back. NULL is also
+ * returned if the calling thread cannot enter an epoch critical section.
+ */
+void *sl_remove(struct SkipList *skip_list, void *value)
+{
+    struct SkipListNode *predecessors[SL_MAX_HEIGHT];
+    struct SkipListNode *successors[SL_MAX_HEIGHT];
+
+    if (epoch_enter() != 0)
+    {
+        return NULL;
+    }
+
+    if (!sl_search(skip_list, value, predecessors, successors))
+    {
+        epoch_exit();
+
+        return NULL;
+    }
+
+    struct SkipListNode *node = successors[0];
+
+    for (int level = node->height - 1; level >= 0; level--)
+    {
+        uintptr_t next = atomic_load_explicit(&node->next[level], memory_order_relaxed);
+
+        while (!sl_is_marked(next))
+        {
+            if (atomic_compare_exchange_weak(&node->next[level], &next, next | 1))
+            {
+                if (level == 0)
+                {
+                    atomic_fetch_sub(&skip_list->size, 1);
+
+                    void *removed_value = node->value;
+
+                    sl_release(skip_list, node);
+
+                    epoch_exit();
+
+                    return removed_value;
+                }
+
+                break;
+            }
+        }
+    }
+
+    epoch_exit();
+
+    return NULL;
+}
+
+/**
+ * @brief Gets the number of values in a skip list.
+ * @param skip_list A pointer to the skip list.
+ * @return The number of values, which other threads may change at any time.
+ */
+size_t sl_size(struct SkipList *skip_list)
+{
+    return atomic_load(&skip_list->size);
+}
+
+/**
+ * @brief Starts iterating over the values of a skip list from a given value.
+ * @param skip_list A pointer to the skip list to iterate over.
+ * @param from The smallest value to return. Pass NULL to iterate over every value.
+ * @param iterator A pointer to the iterator to initialize.
+ * @return 0 if the iterator was initialized, -1 if the calling thread could not
+ *         enter an epoch critical section, in which case sl_iter_end must not be
+ *         called.
+ *
+ * Finding the first value takes O(log n) time, and every call to sl_iter_next
+ * after that takes constant time apart from stepping over removed values.
+ */
+int sl_iter_begin(struct SkipList *skip_list, void *from,
+                  struct SkipListIterator *iterator)
+{
+    if (epoch_enter() != 0)
+    {
+        return -1;
+    }
+
+    iterator->skip_list = skip_list;
+    iterator->next = sl_lower_bound(skip_list, from);
+
+    return 0;
+}
+
+/**
+ * @brief Advances an iterator to the next value of a skip list.
+ * @param iterator A pointer to the iterator to advance.
+ * @return A pointer to the next value, or NULL if every value has been returned.
+ */
+void *sl_iter_next(struct SkipListIterator *iterator)
+{
+    while (iterator->next != NULL)
+    {
+        struct SkipListNode *node = iterator->next;
+        uintptr_t next = atomic_load_explicit(&node->next[0], memory_order_acquire);
+
+        iterator->next = sl_node(next);
+
+        if (!sl_is_marked(next))
+        {
+            return node->value;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Stops iterating over a skip list.
+ * @param iterator A pointer to the iterator to stop.
+ * @return void
+ */
+void sl_iter_end(struct SkipListIterator *iterator)
+{
+    iterator->next = NULL;
+
+    epoch_exit();
+
+    return;
+}
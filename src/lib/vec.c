@@ -0,0 +1,314 @@
+/**
+ * @brief A generic growable vector that stores its elements contiguously.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+#include "lib/vec.h"
+
+/**
+ * @brief Gets a pointer to an element of a vector without checking bounds.
+ * @param vector A pointer to the vector.
+ * @param index The index of the element.
+ * @return A pointer to the element.
+ */
+static char *vec_at(struct Vector *vector, size_t index)
+{
+    return (char *)vector->data + index * vector->element_size;
+}
+
+/**
+ * @brief Grows a vector so that it has room for a number of elements.
+ * @param vector A pointer to the vector to grow.
+ * @param size The number of elements the vector needs room for.
+ * @return 0 if the vector has room for the elements, -1 otherwise.
+ *
+ * The capacity is at least doubled, so that repeated pushes take amortized constant
+ * time.
+ */
+static int vec_grow(struct Vector *vector, size_t size)
+{
+    if (size <= vector->capacity)
+    {
+        return 0;
+    }
+
+    size_t capacity = vector->capacity == 0 ? VEC_MIN_CAPACITY : vector->capacity * 2;
+
+    if (capacity < size)
+    {
+        capacity = size;
+    }
+
+    return vec_reserve(vector, capacity);
+}
+
+/**
+ * @brief Creates a new vector.
+ * @param element_size The size of the elements in the vector, which may not be 0.
+ * @return A pointer to the created vector, or NULL if element_size is 0 or the
+ *         allocation failed.
+ */
+struct Vector *vec_create(size_t element_size)
+{
+    return vec_create_with_allocator(element_size, NULL);
+}
+
+/**
+ * @brief Creates a new vector that allocates from an allocator.
+ * @param element_size The size of the elements in the vector, which may not be 0.
+ * @param allocator A pointer to the allocator to allocate from, or NULL for malloc.
+ * @return A pointer to the created vector, or NULL if element_size is 0 or the
+ *         allocation failed.
+ *
+ * No memory is allocated for elements until the first one is added.
+ */
+struct Vector *vec_create_with_allocator(size_t element_size,
+                                         const struct Allocator *allocator)
+{
+    if (element_size == 0)
+    {
+        return NULL;
+    }
+
+    struct Vector *vector = allocator_alloc(allocator, sizeof(struct Vector));
+    if (vector == NULL)
+    {
+        return NULL;
+    }
+
+    vector->element_size = element_size;
+    vector->size = 0;
+    vector->capacity = 0;
+    vector->data = NULL;
+    vector->allocator = allocator;
+
+    return vector;
+}
+
+/**
+ * @brief Frees a vector.
+ * @param vector A pointer to the vector to free.
+ * @param value_free_function A function that is passed a pointer to each element
+ *                            to free what it owns. Pass NULL if the elements do not
+ *                            need to be freed.
+ * @return void
+ */
+void vec_free(struct Vector *vector, ValueFreeFunction value_free_function)
+{
+    if (value_free_function != NULL)
+    {
+        for (size_t i = 0; i < vector->size; i++)
+        {
+            value_free_function(vec_at(vector, i));
+        }
+    }
+
+    if (vector->data != NULL)
+    {
+        allocator_free(vector->allocator, vector->data,
+                       vector->capacity * vector->element_size);
+    }
+
+    allocator_free(vector->allocator, vector, sizeof(struct Vector));
+
+    return;
+}
+
+/**
+ * @brief Makes sure a vector has room for a number of elements.
+ * @param vector A pointer to the vector to reserve in.
+ * @param capacity The number of elements to make room for.
+ * @return 0 if the vector has room for the elements, -1 otherwise.
+ */
+int vec_reserve(struct Vector *vector, size_t capacity)
+{
+    if (capacity <= vector->capacity)
+    {
+        return 0;
+    }
+
+    if (capacity > SIZE_MAX / vector->element_size)
+    {
+        return -1;
+    }
+
+    void *data = allocator_realloc(vector->allocator, vector->data,
+                                   vector->capacity * vector->element_size,
+                                   capacity * vector->element_size);
+    if (data == NULL)
+    {
+        return -1;
+    }
+
+    vector->data = data;
+    vector->capacity = capacity;
+
+    return 0;
+}
+
+/**
+ * @brief Gets an element of a vector.
+ * @param vector A pointer to the vector to get from.
+ * @param index The index of the element to get.
+ * @return A pointer to the element, or NULL if the index is out of bounds.
+ */
+void *vec_get(struct Vector *vector, size_t index)
+{
+    if (index >= vector->size)
+    {
+        return NULL;
+    }
+
+    return vec_at(vector, index);
+}
+
+/**
+ * @brief Pushes a copy of an element onto the end of a vector.
+ * @param vector A pointer to the vector to push onto.
+ * @param element A pointer to the element to copy.
+ * @return 0 if the element was pushed successfully, -1 otherwise.
+ */
+int vec_push(struct Vector *vector, const void *element)
+{
+    if (vec_grow(vector, vector->size + 1) != 0)
+    {
+        return -1;
+    }
+
+    memcpy(vec_at(vector, vector->size), element, vector->element_size);
+    vector->size++;
+
+    return 0;
+}
+
+/**
+ * @brief Appends copies of an array of elements to the end of a vector.
+ * @param vector A pointer to the vector to append to.
+ * @param elements A pointer to the first element to copy.
+ * @param count The number of elements to copy.
+ * @return 0 if the elements were appended successfully, -1 otherwise.
+ *
+ * The vector grows at most once, and the elements are copied in a single memcpy.
+ */
+int vec_append(struct Vector *vector, const void *elements, size_t count)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    if (count > SIZE_MAX - vector->size || vec_grow(vector, vector->size + count) != 0)
+    {
+        return -1;
+    }
+
+    memcpy(vec_at(vector, vector->size), elements, count * vector->element_size);
+    vector->size += count;
+
+    return 0;
+}
+
+/**
+ * @brief Pops the last element of a vector.
+ * @param vector A pointer to the vector to pop from.
+ * @param element A pointer to copy the popped element to, or NULL to discard it.
+ * @return 0 if an element was popped, -1 if the vector is empty.
+ */
+int vec_pop(struct Vector *vector, void *element)
+{
+    if (vector->size == 0)
+    {
+        return -1;
+    }
+
+    vector->size--;
+
+    if (element != NULL)
+    {
+        memcpy(element, vec_at(vector, vector->size), vector->element_size);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Removes an element from a vector, keeping the order of the others.
+ * @param vector A pointer to the vector to remove from.
+ * @param index The index of the element to remove.
+ * @return 0 if the element was removed successfully, -1 otherwise.
+ *
+ * Every element after the removed one is moved, so this takes linear time. Use
+ * vec_swap_remove if the order does not matter.
+ */
+int vec_remove(struct Vector *vector, size_t index)
+{
+    if (index >= vector->size)
+    {
+        return -1;
+    }
+
+    memmove(vec_at(vector, index), vec_at(vector, index + 1),
+            (vector->size - index - 1) * vector->element_size);
+    vector->size--;
+
+    return 0;
+}
+
+/**
+ * @brief Removes an element from a vector by moving the last element into its place.
+ * @param vector A pointer to the vector to remove from.
+ * @param index The index of the element to remove.
+ * @return 0 if the element was removed successfully, -1 otherwise.
+ */
+int vec_swap_remove(struct Vector *vector, size_t index)
+{
+    if (index >= vector->size)
+    {
+        return -1;
+    }
+
+    vector->size--;
+
+    if (index != vector->size)
+    {
+        memcpy(vec_at(vector, index), vec_at(vector, vector->size),
+               vector->element_size);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Removes every element from a vector, keeping its capacity.
+ * @param vector A pointer to the vector to clear.
+ * @return void
+ */
+void vec_clear(struct Vector *vector)
+{
+    vector->size = 0;
+
+    return;
+}
+
+/**
+ * @brief Sorts the elements of a vector.
+ * @param vector A pointer to the vector to sort.
+ * @param order_function A function that orders two elements of the vector.
+ * @return void
+ */
+void vec_sort(struct Vector *vector, VectorOrderFunction order_function)
+{
+    if (vector->size < 2)
+    {
+        return;
+    }
+
+    qsort(vector->data, vector->size, vector->element_size, order_function);
+
+    return;
+}
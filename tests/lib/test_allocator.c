@@ -0,0 +1,185 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/allocator.h"
+#include "lib/arena.h"
+#include "lib/hashmap.h"
+#include "lib/list.h"
+
+void test_allocator_alloc()
+{
+    printf("Testing allocator_alloc\n");
+
+    char *memory = allocator_alloc(NULL, 16);
+
+    assert(memory != NULL);
+
+    memcpy(memory, "hello", 6);
+    memory = allocator_realloc(NULL, memory, 16, 64);
+
+    assert(memory != NULL);
+    assert(strcmp(memory, "hello") == 0);
+
+    allocator_free(NULL, memory, 64);
+
+    printf("allocator_alloc passed\n");
+
+    return;
+}
+
+void test_counting_allocator()
+{
+    printf("Testing counting_allocator\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    assert(allocator == &counting_allocator.allocator);
+    assert(counting_allocator.allocations == 0);
+    assert(counting_allocator.bytes_in_use == 0);
+
+    char *memory = allocator_alloc(allocator, 16);
+
+    assert(counting_allocator.allocations == 1);
+    assert(counting_allocator.bytes_in_use == 16);
+
+    memcpy(memory, "hello", 6);
+    memory = allocator_realloc(allocator, memory, 16, 64);
+
+    assert(strcmp(memory, "hello") == 0);
+    assert(counting_allocator.allocations == 2);
+    assert(counting_allocator.frees == 1);
+    assert(counting_allocator.bytes_in_use == 64);
+
+    memory = allocator_realloc(allocator, memory, 64, 8);
+
+    assert(counting_allocator.bytes_in_use == 8);
+    assert(counting_allocator.peak_bytes_in_use == 64);
+
+    allocator_free(allocator, memory, 8);
+
+    assert(counting_allocator.frees == 3);
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("counting_allocator passed\n");
+
+    return;
+}
+
+void test_allocator_without_realloc()
+{
+    printf("Testing allocator_without_realloc\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator allocator = *counting_allocator_init(&counting_allocator, NULL);
+    allocator.realloc = NULL;
+
+    char *memory = allocator_alloc(&allocator, 16);
+    memcpy(memory, "hello", 6);
+    memory = allocator_realloc(&allocator, memory, 16, 64);
+
+    assert(strcmp(memory, "hello") == 0);
+    assert(counting_allocator.allocations == 2);
+    assert(counting_allocator.frees == 1);
+    assert(counting_allocator.bytes_in_use == 64);
+
+    allocator_free(&allocator, memory, 64);
+
+    printf("allocator_without_realloc passed\n");
+
+    return;
+}
+
+void test_counting_allocator_without_free()
+{
+    printf("Testing counting_allocator_without_free\n");
+
+    struct Arena *arena = arena_create(1024);
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator =
+        counting_allocator_init(&counting_allocator, arena_allocator(arena));
+
+    assert(allocator->free == NULL);
+    assert(!allocator_frees_individually(allocator));
+
+    void *memory = allocator_alloc(allocator, 16);
+
+    assert(memory != NULL);
+
+    allocator_free(allocator, memory, 16);
+
+    assert(counting_allocator.frees == 0);
+    assert(counting_allocator.bytes_in_use == 16);
+
+    arena_free(arena);
+
+    allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    assert(allocator_frees_individually(allocator));
+
+    printf("counting_allocator_without_free passed\n");
+
+    return;
+}
+
+void test_containers_with_allocator()
+{
+    printf("Testing containers_with_allocator\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct LinkedList *linked_list = ll_create_with_allocator(NULL, allocator);
+    int values[3] = {1, 2, 3};
+
+    assert(linked_list->allocator == allocator);
+
+    for (int i = 0; i < 3; i++)
+    {
+        assert(ll_push(linked_list, &values[i]) == 0);
+    }
+
+    assert(counting_allocator.allocations == 4);
+
+    ll_free(linked_list, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    struct HashMap *hashmap =
+        hm_create_with_allocator(4, hm_hash_int, hm_compare_int, allocator);
+
+    assert(hashmap->allocator == allocator);
+
+    for (int i = 0; i < 3; i++)
+    {
+        assert(hm_set(hashmap, &values[i], &values[i]) == 0);
+    }
+
+    assert(counting_allocator.bytes_in_use > 0);
+
+    hm_free(hashmap, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+    assert(counting_allocator.allocations == counting_allocator.frees);
+
+    printf("containers_with_allocator passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/allocator.c\"\n");
+
+    test_allocator_alloc();
+    test_counting_allocator();
+    test_allocator_without_realloc();
+    test_counting_allocator_without_free();
+    test_containers_with_allocator();
+
+    printf("All tests passed for \"lib/allocator.c\"\n\n");
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/arena.h"
+#include "lib/hashmap.h"
+#include "lib/list.h"
+
+void test_arena_create()
+{
+    printf("Testing arena_create\n");
+
+    struct Arena *arena = arena_create(100);
+
+    assert(arena != NULL);
+    assert(arena->block_size % ARENA_ALIGNMENT == 0);
+    assert(arena->block_size >= 100);
+    assert(arena->first_block == NULL);
+    assert(arena->current_block == NULL);
+    assert(arena_allocator(arena)->free == NULL);
+    assert(!allocator_frees_individually(arena_allocator(arena)));
+
+    arena_free(arena);
+
+    printf("arena_create passed\n");
+
+    return;
+}
+
+void test_arena_alloc()
+{
+    printf("Testing arena_alloc\n");
+
+    struct Arena *arena = arena_create(256);
+
+    int *objects[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        objects[i] = arena_alloc(arena, sizeof(int));
+
+        assert(objects[i] != NULL);
+        assert((uintptr_t)objects[i] % ARENA_ALIGNMENT == 0);
+
+        *objects[i] = i;
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(*objects[i] == i);
+    }
+
+    assert(arena->first_block != arena->current_block);
+
+    char *large = arena_alloc(arena, 4096);
+
+    assert(large != NULL);
+    assert(arena->current_block->size >= 4096);
+
+    large[4095] = 1;
+
+    arena_free(arena);
+
+    printf("arena_alloc passed\n");
+
+    return;
+}
+
+void test_arena_reset()
+{
+    printf("Testing arena_reset\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *parent = counting_allocator_init(&counting_allocator, NULL);
+
+    struct Arena *arena = arena_create_with_allocator(256, parent);
+
+    void *objects[50];
+
+    for (int i = 0; i < 50; i++)
+    {
+        objects[i] = arena_alloc(arena, 24);
+    }
+
+    size_t allocations = counting_allocator.allocations;
+
+    arena_reset(arena);
+
+    assert(arena->current_block == arena->first_block);
+
+    for (int i = 0; i < 50; i++)
+    {
+        assert(arena_alloc(arena, 24) == objects[i]);
+    }
+
+    assert(counting_allocator.allocations == allocations);
+
+    arena_free(arena);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("arena_reset passed\n");
+
+    return;
+}
+
+void test_arena_realloc()
+{
+    printf("Testing arena_realloc\n");
+
+    struct Arena *arena = arena_create(256);
+    struct Allocator *allocator = arena_allocator(arena);
+
+    int *values = allocator_alloc(allocator, 4 * sizeof(int));
+
+    for (int i = 0; i < 4; i++)
+    {
+        values[i] = i;
+    }
+
+    assert(allocator_realloc(allocator, values, 4 * sizeof(int), 8 * sizeof(int)) ==
+           values);
+
+    int *other = allocator_alloc(allocator, sizeof(int));
+    int *moved =
+        allocator_realloc(allocator, values, 8 * sizeof(int), 16 * sizeof(int));
+
+    assert(moved != values);
+    assert(moved != other);
+
+    for (int i = 0; i < 4; i++)
+    {
+        assert(moved[i] == i);
+    }
+
+    assert(allocator_realloc(allocator, moved, 16 * sizeof(int), sizeof(int)) == moved);
+
+    allocator_free(allocator, moved, sizeof(int));
+
+    arena_free(arena);
+
+    printf("arena_realloc passed\n");
+
+    return;
+}
+
+void test_containers_with_arena()
+{
+    printf("Testing containers_with_arena\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *parent = counting_allocator_init(&counting_allocator, NULL);
+
+    struct Arena *arena = arena_create_with_allocator(4096, parent);
+    int values[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+    }
+
+    size_t allocations = 0;
+
+    for (int request = 0; request < 3; request++)
+    {
+        struct LinkedList *linked_list =
+            ll_create_with_allocator(NULL, arena_allocator(arena));
+        struct HashMap *hashmap = hm_create_with_allocator(
+            4, hm_hash_int, hm_compare_int, arena_allocator(arena));
+
+        for (int i = 0; i < 100; i++)
+        {
+            assert(ll_push(linked_list, &values[i]) == 0);
+            assert(hm_set(hashmap, &values[i], &values[i]) == 0);
+        }
+
+        for (int i = 0; i < 100; i++)
+        {
+            assert(hm_get(hashmap, &values[i]) == &values[i]);
+        }
+
+        assert(linked_list->size == 100);
+        assert(linked_list->tail->value == &values[99]);
+
+        arena_reset(arena);
+
+        if (request == 0)
+        {
+            allocations = counting_allocator.allocations;
+        }
+
+        assert(counting_allocator.allocations == allocations);
+    }
+
+    arena_free(arena);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("containers_with_arena passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/arena.c\"\n");
+
+    test_arena_create();
+    test_arena_alloc();
+    test_arena_reset();
+    test_arena_realloc();
+    test_containers_with_arena();
+
+    printf("All tests passed for \"lib/arena.c\"\n\n");
+
+    return 0;
+}
@@ -0,0 +1,346 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/btree.h"
+
+int allocations_left = -1;
+
+void *limited_alloc(void *context, size_t size)
+{
+    (void)context;
+
+    if (allocations_left == 0)
+    {
+        return NULL;
+    }
+
+    if (allocations_left > 0)
+    {
+        allocations_left--;
+    }
+
+    return malloc(size);
+}
+
+void limited_free(void *context, void *pointer, size_t size)
+{
+    (void)context;
+    (void)size;
+
+    free(pointer);
+}
+
+size_t check_node(struct BTreeNode *node, int is_root, uint64_t low, uint64_t high,
+                  size_t *leaf_depth, size_t depth)
+{
+    assert(is_root || node->count >= BT_MIN_KEYS);
+    assert(node->count <= BT_NODE_KEYS);
+
+    for (size_t i = 0; i < node->count; i++)
+    {
+        assert(node->keys[i] >= low && node->keys[i] < high);
+        assert(i == 0 || node->keys[i - 1] < node->keys[i]);
+    }
+
+    if (node->is_leaf)
+    {
+        if (*leaf_depth == 0)
+        {
+            *leaf_depth = depth;
+        }
+
+        assert(*leaf_depth == depth);
+
+        return node->count;
+    }
+
+    struct BTreeInternal *internal = (struct BTreeInternal *)node;
+    size_t keys = 0;
+
+    for (size_t i = 0; i <= node->count; i++)
+    {
+        keys += check_node(internal->children[i], 0, i == 0 ? low : node->keys[i - 1],
+                           i == node->count ? high : node->keys[i], leaf_depth,
+                           depth + 1);
+    }
+
+    return keys;
+}
+
+void check_tree(struct BTree *tree)
+{
+    size_t leaf_depth = 0;
+
+    if (tree->root == NULL)
+    {
+        assert(tree->size == 0);
+
+        return;
+    }
+
+    assert(check_node(tree->root, 1, 0, UINT64_MAX, &leaf_depth, 1) == tree->size);
+}
+
+void int_free_function(void *value)
+{
+    free(value);
+}
+
+void test_bt_create()
+{
+    printf("Testing bt_create\n");
+
+    struct BTree *tree = bt_create();
+    struct BTreeIterator iterator;
+
+    assert(tree != NULL);
+    assert(tree->root == NULL);
+    assert(bt_size(tree) == 0);
+    assert(bt_get(tree, 1) == NULL);
+    assert(bt_remove(tree, 1) == NULL);
+
+    bt_iter_begin(tree, 0, &iterator);
+
+    assert(bt_iter_next(&iterator, NULL, NULL) == 0);
+
+    bt_free(tree, NULL);
+
+    printf("bt_create passed\n");
+
+    return;
+}
+
+void test_bt_insert()
+{
+    printf("Testing bt_insert\n");
+
+    struct BTree *tree = bt_create();
+    int values[1000];
+
+    for (int i = 0; i < 1000; i++)
+    {
+        values[i] = i;
+
+        assert(bt_insert(tree, (uint64_t)(i * 7919 % 1000), &values[i]) == 0);
+    }
+
+    check_tree(tree);
+
+    assert(bt_size(tree) == 1000);
+    assert(!tree->root->is_leaf);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(bt_get(tree, (uint64_t)(i * 7919 % 1000)) == &values[i]);
+    }
+
+    assert(bt_get(tree, 1000) == NULL);
+    assert(bt_insert(tree, 5, &values[0]) == 0);
+    assert(bt_get(tree, 5) == &values[0]);
+    assert(bt_size(tree) == 1000);
+
+    bt_free(tree, NULL);
+
+    tree = bt_create();
+
+    for (int i = 0; i < 100; i++)
+    {
+        int *value = malloc(sizeof(int));
+
+        *value = i;
+
+        assert(bt_insert(tree, (uint64_t)i, value) == 0);
+    }
+
+    bt_free(tree, int_free_function);
+
+    printf("bt_insert passed\n");
+
+    return;
+}
+
+void test_bt_remove()
+{
+    printf("Testing bt_remove\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct BTree *tree = bt_create_with_allocator(allocator);
+    int values[2000];
+    int present[2000] = {0};
+
+    srand(42);
+
+    for (int i = 0; i < 2000; i++)
+    {
+        values[i] = i;
+    }
+
+    for (int round = 0; round < 20000; round++)
+    {
+        int key = rand() % 2000;
+
+        if (rand() % 3 != 0)
+        {
+            assert(bt_insert(tree, (uint64_t)key, &values[key]) == 0);
+            present[key] = 1;
+        }
+        else
+        {
+            void *expected = present[key] ? &values[key] : NULL;
+
+            assert(bt_remove(tree, (uint64_t)key) == expected);
+            present[key] = 0;
+        }
+
+        if (round % 1000 == 0)
+        {
+            check_tree(tree);
+        }
+    }
+
+    check_tree(tree);
+
+    for (int key = 0; key < 2000; key++)
+    {
+        assert(bt_get(tree, (uint64_t)key) == (present[key] ? &values[key] : NULL));
+    }
+
+    for (int key = 1999; key >= 1000; key--)
+    {
+        assert(bt_remove(tree, (uint64_t)key) == (present[key] ? &values[key] : NULL));
+        present[key] = 0;
+    }
+
+    check_tree(tree);
+
+    for (int key = 0; key < 2000; key++)
+    {
+        assert(bt_remove(tree, (uint64_t)key) == (present[key] ? &values[key] : NULL));
+    }
+
+    assert(bt_size(tree) == 0);
+    assert(tree->root == NULL);
+    assert(counting_allocator.bytes_in_use == sizeof(struct BTree));
+
+    bt_free(tree, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("bt_remove passed\n");
+
+    return;
+}
+
+void test_bt_iter()
+{
+    printf("Testing bt_iter\n");
+
+    struct BTree *tree = bt_create();
+    struct BTreeIterator iterator;
+    int values[500];
+    uint64_t key;
+    void *value;
+
+    for (int i = 0; i < 500; i++)
+    {
+        values[i] = i;
+
+        assert(bt_insert(tree, (uint64_t)(i * 2), &values[i]) == 0);
+    }
+
+    uint64_t expected = 0;
+
+    bt_iter_begin(tree, 0, &iterator);
+
+    while (bt_iter_next(&iterator, &key, &value))
+    {
+        assert(key == expected);
+        assert(value == &values[expected / 2]);
+
+        expected += 2;
+    }
+
+    assert(expected == 1000);
+
+    expected = 502;
+
+    bt_iter_begin(tree, 501, &iterator);
+
+    while (bt_iter_next(&iterator, &key, NULL) && key < 600)
+    {
+        assert(key == expected);
+
+        expected += 2;
+    }
+
+    assert(expected == 600);
+
+    bt_iter_begin(tree, 999, &iterator);
+
+    assert(bt_iter_next(&iterator, &key, &value) == 0);
+
+    bt_free(tree, NULL);
+
+    printf("bt_iter passed\n");
+
+    return;
+}
+
+void test_bt_allocation_failure()
+{
+    printf("Testing bt_allocation_failure\n");
+
+    struct Allocator allocator = {limited_alloc, NULL, limited_free, NULL};
+
+    struct BTree *tree = bt_create_with_allocator(&allocator);
+    int values[BT_NODE_KEYS + 1];
+
+    for (int i = 0; i < BT_NODE_KEYS; i++)
+    {
+        values[i] = i;
+
+        assert(bt_insert(tree, (uint64_t)i, &values[i]) == 0);
+    }
+
+    allocations_left = 1;
+
+    assert(bt_insert(tree, BT_NODE_KEYS, &values[0]) == -1);
+    assert(bt_size(tree) == BT_NODE_KEYS);
+    assert(tree->root->is_leaf);
+    assert(bt_get(tree, BT_NODE_KEYS) == NULL);
+
+    check_tree(tree);
+
+    allocations_left = -1;
+
+    assert(bt_insert(tree, BT_NODE_KEYS, &values[0]) == 0);
+    assert(!tree->root->is_leaf);
+
+    check_tree(tree);
+
+    bt_free(tree, NULL);
+
+    printf("bt_allocation_failure passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/btree.c\"\n");
+
+    test_bt_create();
+    test_bt_insert();
+    test_bt_remove();
+    test_bt_iter();
+    test_bt_allocation_failure();
+
+    printf("All tests passed for \"lib/btree.c\"\n\n");
+
+    return 0;
+}
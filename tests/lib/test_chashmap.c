@@ -0,0 +1,350 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/chashmap.h"
+
+#define THREADS 4
+#define KEYS_PER_THREAD 5000
+
+struct Worker
+{
+    struct ConcurrentHashMap *concurrent_hashmap;
+    uint64_t *keys;
+};
+
+void *set_worker(void *argument)
+{
+    struct Worker *worker = argument;
+
+    for (int i = 0; i < KEYS_PER_THREAD; i++)
+    {
+        uint64_t *key = &worker->keys[i];
+
+        assert(chm_set(worker->concurrent_hashmap, key, key) == 0);
+    }
+
+    return NULL;
+}
+
+void *get_and_remove_worker(void *argument)
+{
+    struct Worker *worker = argument;
+
+    for (int i = 0; i < KEYS_PER_THREAD; i++)
+    {
+        assert(chm_get(worker->concurrent_hashmap, &worker->keys[i]) ==
+               &worker->keys[i]);
+
+        if (i % 2 == 0)
+        {
+            assert(chm_remove(worker->concurrent_hashmap, &worker->keys[i]) ==
+                   &worker->keys[i]);
+        }
+    }
+
+    return NULL;
+}
+
+struct ConcurrentHashMap *unlocked_hashmap = NULL;
+size_t unlocked_bytes_in_use = 0;
+
+void assert_unlocked()
+{
+    if (unlocked_hashmap == NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < CHM_STRIPES; i++)
+    {
+        pthread_rwlock_t *lock = &unlocked_hashmap->stripes[i].lock;
+
+        assert(pthread_rwlock_trywrlock(lock) == 0);
+        pthread_rwlock_unlock(lock);
+    }
+
+    return;
+}
+
+void *unlocked_alloc(void *context, size_t size)
+{
+    (void)context;
+
+    assert_unlocked();
+    unlocked_bytes_in_use += size;
+
+    return malloc(size);
+}
+
+void unlocked_free(void *context, void *pointer, size_t size)
+{
+    (void)context;
+
+    unlocked_bytes_in_use -= size;
+    free(pointer);
+
+    return;
+}
+
+void run_workers(struct Worker *workers, void *(*function)(void *))
+{
+    pthread_t threads[THREADS];
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, function, &workers[i]) == 0);
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        assert(pthread_join(threads[i], NULL) == 0);
+    }
+
+    return;
+}
+
+void test_chm_create()
+{
+    printf("Testing chm_create\n");
+
+    struct ConcurrentHashMap *concurrent_hashmap =
+        chm_create(10, hm_hash_uint64, hm_compare_uint64);
+
+    assert(concurrent_hashmap != NULL);
+    assert(atomic_load(&concurrent_hashmap->table)->capacity == CHM_STRIPES);
+    assert(chm_size(concurrent_hashmap) == 0);
+
+    chm_free(concurrent_hashmap, NULL);
+
+    concurrent_hashmap = chm_create(1000, hm_hash_uint64, hm_compare_uint64);
+
+    assert(atomic_load(&concurrent_hashmap->table)->capacity == 1024);
+
+    chm_free(concurrent_hashmap, NULL);
+
+    assert(chm_create(SIZE_MAX, hm_hash_uint64, hm_compare_uint64) == NULL);
+
+    printf("chm_create passed\n");
+
+    return;
+}
+
+void test_chm_set_get_remove()
+{
+    printf("Testing chm_set_get_remove\n");
+
+    struct ConcurrentHashMap *concurrent_hashmap =
+        chm_create(0, hm_hash_uint64, hm_compare_uint64);
+    uint64_t keys[200];
+    int value = 42;
+
+    for (int i = 0; i < 200; i++)
+    {
+        keys[i] = i;
+
+        assert(chm_set(concurrent_hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    assert(chm_size(concurrent_hashmap) == 200);
+    assert(atomic_load(&concurrent_hashmap->table)->capacity == 512);
+
+    assert(chm_set(concurrent_hashmap, &keys[7], &value) == 0);
+    assert(chm_get(concurrent_hashmap, &keys[7]) == &value);
+    assert(chm_size(concurrent_hashmap) == 200);
+
+    assert(chm_remove(concurrent_hashmap, &keys[7]) == &value);
+    assert(chm_remove(concurrent_hashmap, &keys[7]) == NULL);
+    assert(chm_get(concurrent_hashmap, &keys[7]) == NULL);
+    assert(chm_size(concurrent_hashmap) == 199);
+
+    for (int i = 8; i < 200; i++)
+    {
+        assert(chm_get(concurrent_hashmap, &keys[i]) == &keys[i]);
+    }
+
+    chm_free(concurrent_hashmap, NULL);
+
+    printf("chm_set_get_remove passed\n");
+
+    return;
+}
+
+void test_chm_threads()
+{
+    printf("Testing chm_threads\n");
+
+    struct ConcurrentHashMap *concurrent_hashmap =
+        chm_create(0, hm_hash_uint64, hm_compare_uint64);
+    uint64_t *keys = malloc(THREADS * KEYS_PER_THREAD * sizeof(uint64_t));
+    struct Worker workers[THREADS];
+
+    for (int i = 0; i < THREADS * KEYS_PER_THREAD; i++)
+    {
+        keys[i] = i;
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        workers[i].concurrent_hashmap = concurrent_hashmap;
+        workers[i].keys = &keys[i * KEYS_PER_THREAD];
+    }
+
+    run_workers(workers, set_worker);
+
+    assert(chm_size(concurrent_hashmap) == THREADS * KEYS_PER_THREAD);
+
+    run_workers(workers, get_and_remove_worker);
+
+    assert(chm_size(concurrent_hashmap) == THREADS * KEYS_PER_THREAD / 2);
+
+    for (int i = 0; i < THREADS * KEYS_PER_THREAD; i++)
+    {
+        assert(chm_get(concurrent_hashmap, &keys[i]) == (i % 2 ? &keys[i] : NULL));
+    }
+
+    chm_free(concurrent_hashmap, NULL);
+    free(keys);
+
+    printf("chm_threads passed\n");
+
+    return;
+}
+
+void test_chm_grow()
+{
+    printf("Testing chm_grow\n");
+
+    struct Allocator allocator = {unlocked_alloc, NULL, unlocked_free, NULL};
+    struct ConcurrentHashMap *concurrent_hashmap =
+        chm_create_with_allocator(0, hm_hash_uint64, hm_compare_uint64, &allocator);
+    uint64_t keys[1000];
+
+    unlocked_hashmap = concurrent_hashmap;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        keys[i] = i;
+
+        assert(chm_set(concurrent_hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    assert(atomic_load(&concurrent_hashmap->table)->capacity == 2048);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(chm_get(concurrent_hashmap, &keys[i]) == &keys[i]);
+    }
+
+    unlocked_hashmap = NULL;
+
+    chm_free(concurrent_hashmap, NULL);
+
+    assert(unlocked_bytes_in_use == 0);
+
+    printf("chm_grow passed\n");
+
+    return;
+}
+
+struct Reader
+{
+    struct ConcurrentHashMap *concurrent_hashmap;
+    uint64_t *keys;
+    atomic_int *done;
+};
+
+void *reader_worker(void *argument)
+{
+    struct Reader *reader = argument;
+
+    while (!atomic_load(reader->done))
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            assert(chm_get(reader->concurrent_hashmap, &reader->keys[i]) ==
+                   &reader->keys[i]);
+        }
+    }
+
+    return NULL;
+}
+
+void test_chm_lock_free_get()
+{
+    printf("Testing chm_lock_free_get\n");
+
+    struct ConcurrentHashMap *concurrent_hashmap =
+        chm_create(0, hm_hash_uint64, hm_compare_uint64);
+    uint64_t *keys = malloc(20000 * sizeof(uint64_t));
+    atomic_int done = 0;
+    pthread_t threads[THREADS];
+    struct Reader reader = {concurrent_hashmap, keys, &done};
+
+    for (int i = 0; i < 20000; i++)
+    {
+        keys[i] = i;
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(chm_set(concurrent_hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, reader_worker, &reader) == 0);
+    }
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 100; i < 20000; i++)
+        {
+            assert(chm_set(concurrent_hashmap, &keys[i], &keys[i]) == 0);
+        }
+
+        for (int i = 0; i < 100; i++)
+        {
+            assert(chm_set(concurrent_hashmap, &keys[i], &keys[i]) == 0);
+        }
+
+        for (int i = 100; i < 20000; i++)
+        {
+            assert(chm_remove(concurrent_hashmap, &keys[i]) == &keys[i]);
+        }
+    }
+
+    atomic_store(&done, 1);
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        assert(pthread_join(threads[i], NULL) == 0);
+    }
+
+    assert(chm_size(concurrent_hashmap) == 100);
+
+    chm_free(concurrent_hashmap, NULL);
+    free(keys);
+
+    printf("chm_lock_free_get passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/chashmap.c\"\n");
+
+    test_chm_create();
+    test_chm_set_get_remove();
+    test_chm_grow();
+    test_chm_threads();
+    test_chm_lock_free_get();
+
+    printf("All tests passed for \"lib/chashmap.c\"\n\n");
+
+    return 0;
+}
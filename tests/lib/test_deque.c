@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/deque.h"
+
+void int_free_function(void *value)
+{
+    free(value);
+}
+
+void test_dq_create()
+{
+    printf("Testing dq_create\n");
+
+    struct Deque *deque = dq_create();
+
+    assert(deque != NULL);
+    assert(deque->capacity == 0);
+    assert(deque->size == 0);
+    assert(deque->slots == NULL);
+    assert(dq_pop_front(deque) == NULL);
+    assert(dq_pop_back(deque) == NULL);
+    assert(dq_peek_front(deque) == NULL);
+    assert(dq_peek_back(deque) == NULL);
+
+    dq_free(deque, NULL);
+
+    printf("dq_create passed\n");
+
+    return;
+}
+
+void test_dq_fifo()
+{
+    printf("Testing dq_fifo\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct Deque *deque = dq_create_with_allocator(allocator);
+    int values[DQ_MIN_CAPACITY];
+
+    for (int i = 0; i < DQ_MIN_CAPACITY; i++)
+    {
+        values[i] = i;
+
+        assert(dq_push_back(deque, &values[i]) == 0);
+    }
+
+    size_t allocations = counting_allocator.allocations;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(dq_pop_front(deque) == &values[i % DQ_MIN_CAPACITY]);
+        assert(dq_push_back(deque, &values[i % DQ_MIN_CAPACITY]) == 0);
+    }
+
+    assert(counting_allocator.allocations == allocations);
+    assert(deque->capacity == DQ_MIN_CAPACITY);
+
+    dq_free(deque, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("dq_fifo passed\n");
+
+    return;
+}
+
+void test_dq_grow_wrapped()
+{
+    printf("Testing dq_grow_wrapped\n");
+
+    struct Deque *deque = dq_create();
+    int values[20];
+
+    for (int i = 0; i < 20; i++)
+    {
+        values[i] = i;
+    }
+
+    for (int i = 4; i < 8; i++)
+    {
+        assert(dq_push_back(deque, &values[i]) == 0);
+    }
+
+    for (int i = 3; i >= 0; i--)
+    {
+        assert(dq_push_front(deque, &values[i]) == 0);
+    }
+
+    assert(deque->capacity == DQ_MIN_CAPACITY);
+    assert(deque->head != 0);
+
+    for (int i = 8; i < 20; i++)
+    {
+        assert(dq_push_back(deque, &values[i]) == 0);
+    }
+
+    assert(deque->size == 20);
+    assert(deque->capacity == 32);
+
+    for (int i = 0; i < 20; i++)
+    {
+        assert(dq_get(deque, i) == &values[i]);
+    }
+
+    assert(dq_get(deque, 20) == NULL);
+    assert(dq_peek_front(deque) == &values[0]);
+    assert(dq_peek_back(deque) == &values[19]);
+    assert(dq_pop_back(deque) == &values[19]);
+    assert(dq_pop_front(deque) == &values[0]);
+    assert(deque->size == 18);
+
+    dq_free(deque, NULL);
+
+    printf("dq_grow_wrapped passed\n");
+
+    return;
+}
+
+void test_dq_free()
+{
+    printf("Testing dq_free\n");
+
+    struct Deque *deque = dq_create();
+
+    for (int i = 0; i < 10; i++)
+    {
+        int *value = malloc(sizeof(int));
+        *value = i;
+
+        assert(dq_push_front(deque, value) == 0);
+    }
+
+    assert(*(int *)dq_peek_front(deque) == 9);
+
+    dq_free(deque, int_free_function);
+
+    printf("dq_free passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/deque.c\"\n");
+
+    test_dq_create();
+    test_dq_fifo();
+    test_dq_grow_wrapped();
+    test_dq_free();
+
+    printf("All tests passed for \"lib/deque.c\"\n\n");
+
+    return 0;
+}
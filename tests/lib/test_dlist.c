@@ -0,0 +1,233 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/dlist.h"
+
+int int_compare_function(void *a, void *b)
+{
+    return *(int *)a - *(int *)b;
+}
+
+void assert_dll_consistent(struct DoublyLinkedList *doubly_linked_list)
+{
+    size_t size = 0;
+    struct DoublyLinkedListNode *prev_node = NULL;
+    struct DoublyLinkedListNode *current_node = doubly_linked_list->head;
+
+    while (current_node != NULL)
+    {
+        assert(current_node->prev == prev_node);
+
+        prev_node = current_node;
+        current_node = current_node->next;
+        size++;
+    }
+
+    assert(doubly_linked_list->tail == prev_node);
+    assert(doubly_linked_list->size == size);
+
+    return;
+}
+
+void test_dll_create()
+{
+    printf("Testing dll_create\n");
+
+    struct DoublyLinkedList *doubly_linked_list = dll_create(int_compare_function);
+
+    assert(doubly_linked_list != NULL);
+    assert(doubly_linked_list->size == 0);
+    assert(doubly_linked_list->head == NULL);
+    assert(doubly_linked_list->tail == NULL);
+    assert(doubly_linked_list->value_compare_function == int_compare_function);
+    assert(doubly_linked_list->node_pool == NULL);
+
+    dll_free(doubly_linked_list, NULL);
+
+    printf("dll_create passed\n");
+
+    return;
+}
+
+void test_dll_create_with_pool()
+{
+    printf("Testing dll_create_with_pool\n");
+
+    struct Pool *pool = pool_create(sizeof(struct DoublyLinkedListNode), 64);
+    struct DoublyLinkedList *doubly_linked_list =
+        dll_create_with_pool(int_compare_function, pool);
+    int value = 42;
+
+    assert(doubly_linked_list->node_pool == pool);
+    assert(dll_push(doubly_linked_list, &value) == 0);
+
+    struct DoublyLinkedListNode *node = doubly_linked_list->head;
+
+    assert(dll_pop(doubly_linked_list) == &value);
+    assert(pool->free_list == node);
+
+    dll_free(doubly_linked_list, NULL);
+    pool_free(pool);
+
+    printf("dll_create_with_pool passed\n");
+
+    return;
+}
+
+void test_dll_push_and_pop()
+{
+    printf("Testing dll_push_and_pop\n");
+
+    struct DoublyLinkedList *doubly_linked_list = dll_create(int_compare_function);
+    int values[4] = {1, 2, 3, 4};
+
+    assert(dll_pop(doubly_linked_list) == NULL);
+    assert(dll_pop_front(doubly_linked_list) == NULL);
+
+    assert(dll_push(doubly_linked_list, &values[1]) == 0);
+    assert(dll_push(doubly_linked_list, &values[2]) == 0);
+    assert(dll_push_front(doubly_linked_list, &values[0]) == 0);
+    assert(dll_push(doubly_linked_list, &values[3]) == 0);
+    assert_dll_consistent(doubly_linked_list);
+
+    assert(doubly_linked_list->head->value == &values[0]);
+    assert(doubly_linked_list->tail->value == &values[3]);
+
+    assert(dll_pop(doubly_linked_list) == &values[3]);
+    assert(dll_pop_front(doubly_linked_list) == &values[0]);
+    assert_dll_consistent(doubly_linked_list);
+
+    assert(dll_pop_front(doubly_linked_list) == &values[1]);
+    assert(dll_pop(doubly_linked_list) == &values[2]);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->head == NULL);
+
+    dll_free(doubly_linked_list, NULL);
+
+    printf("dll_push_and_pop passed\n");
+
+    return;
+}
+
+void test_dll_insert_node()
+{
+    printf("Testing dll_insert_node\n");
+
+    struct DoublyLinkedList *doubly_linked_list = dll_create(int_compare_function);
+    int values[5] = {1, 2, 3, 4, 5};
+
+    assert(dll_push(doubly_linked_list, &values[2]) == 0);
+
+    struct DoublyLinkedListNode *node = doubly_linked_list->head;
+
+    assert(dll_insert_before_node(doubly_linked_list, node, &values[1]) == 0);
+    assert(dll_insert_before_node(doubly_linked_list, doubly_linked_list->head,
+                                  &values[0]) == 0);
+    assert(dll_insert_after_node(doubly_linked_list, node, &values[4]) == 0);
+    assert(dll_insert_after_node(doubly_linked_list, node, &values[3]) == 0);
+    assert_dll_consistent(doubly_linked_list);
+
+    struct DoublyLinkedListNode *current_node = doubly_linked_list->head;
+
+    for (int i = 0; i < 5; i++)
+    {
+        assert(current_node->value == &values[i]);
+
+        current_node = current_node->next;
+    }
+
+    dll_free(doubly_linked_list, NULL);
+
+    printf("dll_insert_node passed\n");
+
+    return;
+}
+
+void test_dll_remove()
+{
+    printf("Testing dll_remove\n");
+
+    struct DoublyLinkedList *doubly_linked_list = dll_create(int_compare_function);
+    int values[4] = {1, 2, 3, 4};
+    int missing = 5;
+
+    for (int i = 0; i < 4; i++)
+    {
+        assert(dll_push(doubly_linked_list, &values[i]) == 0);
+    }
+
+    dll_remove_node(doubly_linked_list, doubly_linked_list->head->next);
+    assert_dll_consistent(doubly_linked_list);
+    assert(dll_get_node_by_value(doubly_linked_list, &values[1]) == NULL);
+
+    dll_remove_node(doubly_linked_list, doubly_linked_list->tail);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->tail->value == &values[2]);
+
+    assert(dll_remove_value(doubly_linked_list, &missing) == -1);
+    assert(dll_remove_value(doubly_linked_list, &values[0]) == 0);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->head->value == &values[2]);
+
+    dll_remove_node(doubly_linked_list, doubly_linked_list->head);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->size == 0);
+
+    dll_free(doubly_linked_list, NULL);
+
+    printf("dll_remove passed\n");
+
+    return;
+}
+
+void test_dll_move_to_front()
+{
+    printf("Testing dll_move_to_front\n");
+
+    struct DoublyLinkedList *doubly_linked_list = dll_create(int_compare_function);
+    int values[3] = {1, 2, 3};
+
+    for (int i = 0; i < 3; i++)
+    {
+        assert(dll_push(doubly_linked_list, &values[i]) == 0);
+    }
+
+    struct DoublyLinkedListNode *node = doubly_linked_list->tail;
+
+    dll_move_to_front(doubly_linked_list, node);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->head == node);
+    assert(doubly_linked_list->tail->value == &values[1]);
+
+    dll_move_to_front(doubly_linked_list, node);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->head == node);
+
+    dll_move_to_front(doubly_linked_list, node->next);
+    assert_dll_consistent(doubly_linked_list);
+    assert(doubly_linked_list->head->value == &values[0]);
+    assert(doubly_linked_list->head->next == node);
+
+    dll_free(doubly_linked_list, NULL);
+
+    printf("dll_move_to_front passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/dlist.c\"\n");
+
+    test_dll_create();
+    test_dll_create_with_pool();
+    test_dll_push_and_pop();
+    test_dll_insert_node();
+    test_dll_remove();
+    test_dll_move_to_front();
+
+    printf("All tests passed for \"lib/dlist.c\"\n\n");
+
+    return 0;
+}
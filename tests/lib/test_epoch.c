@@ -0,0 +1,122 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/epoch.h"
+
+atomic_int freed = 0;
+atomic_int reader_entered = 0;
+atomic_int reader_may_exit = 0;
+
+void count_free_function(struct EpochNode *node, void *context)
+{
+    atomic_fetch_add(&freed, 1);
+
+    free(node);
+}
+
+void *pinned_reader(void *argument)
+{
+    assert(epoch_enter() == 0);
+
+    atomic_store(&reader_entered, 1);
+
+    while (!atomic_load(&reader_may_exit))
+    {
+        sched_yield();
+    }
+
+    epoch_exit();
+
+    return NULL;
+}
+
+void test_epoch_retire()
+{
+    printf("Testing epoch_retire\n");
+
+    atomic_store(&freed, 0);
+
+    for (int i = 0; i < EPOCH_RECLAIM_THRESHOLD * 4; i++)
+    {
+        epoch_retire(malloc(sizeof(struct EpochNode)), count_free_function, NULL);
+    }
+
+    assert(atomic_load(&freed) > 0);
+
+    epoch_synchronize();
+
+    assert(atomic_load(&freed) == EPOCH_RECLAIM_THRESHOLD * 4);
+
+    printf("epoch_retire passed\n");
+
+    return;
+}
+
+void test_epoch_nesting()
+{
+    printf("Testing epoch_nesting\n");
+
+    assert(epoch_enter() == 0);
+    assert(epoch_enter() == 0);
+
+    epoch_exit();
+    epoch_exit();
+
+    epoch_synchronize();
+
+    printf("epoch_nesting passed\n");
+
+    return;
+}
+
+void test_epoch_reader_blocks_reclaim()
+{
+    printf("Testing epoch_reader_blocks_reclaim\n");
+
+    pthread_t thread;
+
+    atomic_store(&freed, 0);
+
+    assert(pthread_create(&thread, NULL, pinned_reader, NULL) == 0);
+
+    while (!atomic_load(&reader_entered))
+    {
+        sched_yield();
+    }
+
+    for (int i = 0; i < EPOCH_RECLAIM_THRESHOLD * 4; i++)
+    {
+        epoch_retire(malloc(sizeof(struct EpochNode)), count_free_function, NULL);
+    }
+
+    assert(atomic_load(&freed) == 0);
+
+    atomic_store(&reader_may_exit, 1);
+
+    assert(pthread_join(thread, NULL) == 0);
+
+    epoch_synchronize();
+
+    assert(atomic_load(&freed) == EPOCH_RECLAIM_THRESHOLD * 4);
+
+    printf("epoch_reader_blocks_reclaim passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/epoch.c\"\n");
+
+    test_epoch_retire();
+    test_epoch_nesting();
+    test_epoch_reader_blocks_reclaim();
+
+    printf("All tests passed for \"lib/epoch.c\"\n\n");
+
+    return 0;
+}
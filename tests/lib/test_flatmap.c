@@ -0,0 +1,274 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/flatmap.h"
+
+uint64_t int_hash_function(void *key)
+{
+    return (uint64_t)*(int *)key;
+}
+
+uint64_t collide_hash_function(void *key)
+{
+    return 0x2A;
+}
+
+int int_compare_function(void *a, void *b)
+{
+    return *(int *)a - *(int *)b;
+}
+
+void entry_free_function(struct HashMapEntry *entry)
+{
+    free(entry->key);
+    free(entry->value);
+
+    return;
+}
+
+int *int_create(int value)
+{
+    int *pointer = malloc(sizeof(int));
+    *pointer = value;
+
+    return pointer;
+}
+
+void test_fm_create()
+{
+    printf("Testing fm_create\n");
+
+    struct FlatMap *flatmap = fm_create(10, int_hash_function, int_compare_function);
+
+    assert(flatmap != NULL);
+    assert(flatmap->capacity == FM_GROUP_WIDTH);
+    assert(flatmap->size == 0);
+    assert(flatmap->control != NULL);
+    assert(flatmap->slots != NULL);
+    assert(flatmap->hash_function == int_hash_function);
+    assert(flatmap->key_compare_function == int_compare_function);
+
+    fm_free(flatmap, entry_free_function);
+
+    flatmap = fm_create(100, int_hash_function, int_compare_function);
+
+    assert(flatmap->capacity == 128);
+
+    fm_free(flatmap, entry_free_function);
+
+    assert(fm_create(SIZE_MAX, int_hash_function, int_compare_function) == NULL);
+
+    printf("fm_create passed\n");
+
+    return;
+}
+
+void test_fm_set()
+{
+    printf("Testing fm_set\n");
+
+    struct FlatMap *flatmap = fm_create(10, int_hash_function, int_compare_function);
+
+    int *key = int_create(0);
+    int *value = int_create(10);
+
+    assert(fm_set(flatmap, key, value) == 0);
+    assert(flatmap->size == 1);
+    assert(flatmap->slots[0].key == key);
+    assert(flatmap->slots[0].value == value);
+    assert(flatmap->slots[0].hash == 0);
+
+    int *key2 = int_create(128);
+    int *value2 = int_create(20);
+
+    assert(fm_set(flatmap, key2, value2) == 0);
+    assert(flatmap->size == 2);
+    assert(flatmap->slots[1].key == key2);
+    assert(flatmap->slots[1].value == value2);
+
+    int *overlap_key = int_create(0);
+    int *overlap_value = int_create(40);
+
+    assert(fm_set(flatmap, overlap_key, overlap_value) == 0);
+    assert(flatmap->size == 2);
+    assert(flatmap->slots[0].key == overlap_key);
+    assert(flatmap->slots[0].value == overlap_value);
+
+    free(key);
+    free(value);
+
+    fm_free(flatmap, entry_free_function);
+
+    printf("fm_set passed\n");
+
+    return;
+}
+
+void test_fm_get()
+{
+    printf("Testing fm_get\n");
+
+    struct FlatMap *flatmap = fm_create(10, int_hash_function, int_compare_function);
+
+    int *key = int_create(0);
+    int *value = int_create(10);
+
+    assert(fm_set(flatmap, key, value) == 0);
+    assert(fm_get(flatmap, key) == value);
+
+    int *key2 = int_create(128);
+    int *value2 = int_create(20);
+
+    assert(fm_set(flatmap, key2, value2) == 0);
+    assert(fm_get(flatmap, key2) == value2);
+    assert(fm_get(flatmap, key) == value);
+
+    int non_existent_key = 2;
+
+    assert(fm_get(flatmap, &non_existent_key) == NULL);
+
+    fm_free(flatmap, entry_free_function);
+
+    printf("fm_get passed\n");
+
+    return;
+}
+
+void test_fm_remove()
+{
+    printf("Testing fm_remove\n");
+
+    struct FlatMap *flatmap = fm_create(10, int_hash_function, int_compare_function);
+
+    int *key = int_create(0);
+    int *value = int_create(10);
+
+    assert(fm_set(flatmap, key, value) == 0);
+    assert(fm_remove(flatmap, key) == value);
+    assert(fm_get(flatmap, key) == NULL);
+    assert(flatmap->size == 0);
+    assert(flatmap->growth_left == 14);
+
+    free(key);
+    free(value);
+
+    int non_existent_key = 2;
+
+    assert(fm_remove(flatmap, &non_existent_key) == NULL);
+
+    fm_free(flatmap, entry_free_function);
+
+    printf("fm_remove passed\n");
+
+    return;
+}
+
+void test_fm_grow()
+{
+    printf("Testing fm_grow\n");
+
+    struct FlatMap *flatmap = fm_create(0, int_hash_function, int_compare_function);
+    int *keys[1000];
+
+    for (int i = 0; i < 1000; i++)
+    {
+        keys[i] = int_create(i);
+
+        assert(fm_set(flatmap, keys[i], int_create(i * 2)) == 0);
+    }
+
+    assert(flatmap->size == 1000);
+    assert(flatmap->capacity == 2048);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(*(int *)fm_get(flatmap, &i) == i * 2);
+    }
+
+    for (int i = 0; i < 1000; i += 2)
+    {
+        int *value = fm_remove(flatmap, &i);
+
+        assert(value != NULL);
+        assert(*value == i * 2);
+
+        free(value);
+        free(keys[i]);
+    }
+
+    assert(flatmap->size == 500);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        int *value = fm_get(flatmap, &i);
+
+        if (i % 2 == 0)
+        {
+            assert(value == NULL);
+        }
+        else
+        {
+            assert(*value == i * 2);
+        }
+    }
+
+    fm_free(flatmap, entry_free_function);
+
+    printf("fm_grow passed\n");
+
+    return;
+}
+
+void test_fm_tag_collisions()
+{
+    printf("Testing fm_tag_collisions\n");
+
+    struct FlatMap *flatmap =
+        fm_create(100, collide_hash_function, int_compare_function);
+    int keys[40];
+
+    for (int i = 0; i < 40; i++)
+    {
+        keys[i] = i;
+
+        assert(fm_set(flatmap, &keys[i], &keys[i]) == 0);
+    }
+
+    for (int i = 0; i < 40; i += 3)
+    {
+        assert(fm_remove(flatmap, &keys[i]) == &keys[i]);
+    }
+
+    for (int i = 0; i < 40; i++)
+    {
+        assert(fm_get(flatmap, &keys[i]) == (i % 3 == 0 ? NULL : &keys[i]));
+    }
+
+    int missing = 40;
+
+    assert(fm_get(flatmap, &missing) == NULL);
+
+    fm_free(flatmap, NULL);
+
+    printf("fm_tag_collisions passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/flatmap.c\"\n");
+
+    test_fm_create();
+    test_fm_set();
+    test_fm_get();
+    test_fm_remove();
+    test_fm_grow();
+    test_fm_tag_collisions();
+
+    printf("All tests passed for \"lib/flatmap.c\"\n\n");
+
+    return 0;
+}
@@ -1,12 +1,14 @@
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "lib/hashmap.h"
 
-size_t int_hash_function(struct HashMap *hm, void *key)
+uint64_t int_hash_function(void *key)
 {
-    return *(int *)key % hm->capacity;
+    return (uint64_t)*(int *)key;
 };
 
 int int_compare_function(void *a, void *b)
@@ -22,6 +24,44 @@ void entry_free_function(struct HashMapEntry *entry)
     return;
 }
 
+int freed_entries = 0;
+
+int allocations_left = -1;
+
+void *limited_alloc(void *context, size_t size)
+{
+    (void)context;
+
+    if (allocations_left == 0)
+    {
+        return NULL;
+    }
+
+    if (allocations_left > 0)
+    {
+        allocations_left--;
+    }
+
+    return malloc(size);
+}
+
+void limited_free(void *context, void *pointer, size_t size)
+{
+    (void)context;
+    (void)size;
+
+    free(pointer);
+}
+
+void counting_entry_free_function(struct HashMapEntry *entry)
+{
+    freed_entries++;
+
+    entry_free_function(entry);
+
+    return;
+}
+
 void test_hm_create()
 {
     printf("Testing hm_create\n");
@@ -29,13 +69,19 @@ void test_hm_create()
     struct HashMap *hashmap = hm_create(10, int_hash_function, int_compare_function);
 
     assert(hashmap != NULL);
-    assert(hashmap->capacity == 10);
+    assert(hashmap->capacity == 16);
+    assert(hashmap->size == 0);
     assert(hashmap->buckets != NULL);
+    assert(hashmap->old_buckets == NULL);
+    assert(hashmap->entry_pool != NULL);
+    assert(hashmap->node_pool != NULL);
     assert(hashmap->hash_function == int_hash_function);
     assert(hashmap->key_compare_function == int_compare_function);
 
     hm_free(hashmap, entry_free_function);
 
+    assert(hm_create(SIZE_MAX, int_hash_function, int_compare_function) == NULL);
+
     printf("hm_create passed\n");
 
     return;
@@ -55,9 +101,10 @@ void test_hm_set()
     assert(hm_set(hashmap, key, value) == 0);
     assert(((struct HashMapEntry *)hashmap->buckets[0]->head->value)->key == key);
     assert(((struct HashMapEntry *)hashmap->buckets[0]->head->value)->value == value);
+    assert(((struct HashMapEntry *)hashmap->buckets[0]->head->value)->hash == 0);
 
     int *key2 = malloc(sizeof(int));
-    *key2 = 10;
+    *key2 = 16;
     int *value2 = malloc(sizeof(int));
     *value2 = 20;
 
@@ -115,7 +162,7 @@ void test_hm_get()
     assert(hm_get(hashmap, key) == value);
 
     int *key2 = malloc(sizeof(int));
-    *key2 = 10;
+    *key2 = 16;
     int *value2 = malloc(sizeof(int));
     *value2 = 20;
 
@@ -162,7 +209,7 @@ void test_hm_remove()
     free(value);
 
     int *key2 = malloc(sizeof(int));
-    *key2 = 10;
+    *key2 = 16;
     int *value2 = malloc(sizeof(int));
     *value2 = 20;
 
@@ -199,6 +246,696 @@ void test_hm_remove()
     return;
 }
 
+void test_hm_resize()
+{
+    printf("Testing hm_resize\n");
+
+    struct HashMap *hashmap = hm_create(4, int_hash_function, int_compare_function);
+    int *keys[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        int *key = malloc(sizeof(int));
+        *key = i;
+        int *value = malloc(sizeof(int));
+        *value = i * 2;
+        keys[i] = key;
+
+        assert(hm_set(hashmap, key, value) == 0);
+        assert(hm_get(hashmap, key) == value);
+    }
+
+    assert(hashmap->size == 100);
+    assert(hashmap->capacity == 256);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(*(int *)hm_get(hashmap, &i) == i * 2);
+    }
+
+    assert(hashmap->old_buckets == NULL);
+
+    for (int i = 0; i < 100; i += 2)
+    {
+        int *value = hm_remove(hashmap, &i);
+
+        assert(value != NULL);
+        assert(*value == i * 2);
+
+        free(value);
+        free(keys[i]);
+    }
+
+    assert(hashmap->size == 50);
+
+    for (int i = 0; i < 100; i++)
+    {
+        int *value = hm_get(hashmap, &i);
+
+        if (i % 2 == 0)
+        {
+            assert(value == NULL);
+        }
+        else
+        {
+            assert(*value == i * 2);
+        }
+    }
+
+    hm_free(hashmap, entry_free_function);
+
+    printf("hm_resize passed\n");
+
+    return;
+}
+
+void test_hm_hash_functions()
+{
+    printf("Testing hm_hash_functions\n");
+
+    char long_string[100];
+    memset(long_string, 'a', sizeof(long_string) - 1);
+    long_string[sizeof(long_string) - 1] = '\0';
+
+    assert(hm_hash_bytes("", 0, 0) == hm_hash_bytes("", 0, 0));
+    assert(hm_hash_bytes("abc", 3, 0) == hm_hash_bytes("abc", 3, 0));
+    assert(hm_hash_bytes("abc", 3, 0) != hm_hash_bytes("abc", 3, 1));
+    assert(hm_hash_bytes("abc", 3, 0) != hm_hash_bytes("abd", 3, 0));
+    assert(hm_hash_bytes("abc", 3, 0) != hm_hash_bytes("abc", 2, 0));
+    assert(hm_hash_bytes(long_string, 99, 0) != hm_hash_bytes(long_string, 98, 0));
+    assert(hm_hash_integer(1, 0) != hm_hash_integer(2, 0));
+    assert(hm_hash_integer(1, 0) != hm_hash_integer(1, 1));
+
+    char string1[] = "nickname";
+    char string2[] = "nickname";
+    int int1 = 42;
+    int int2 = 42;
+    uint64_t uint1 = 42;
+    uint64_t uint2 = 42;
+
+    assert(hm_hash_string(string1) == hm_hash_string(string2));
+    assert(hm_hash_int(&int1) == hm_hash_int(&int2));
+    assert(hm_hash_uint64(&uint1) == hm_hash_uint64(&uint2));
+    assert(hm_hash_pointer(&int1) != hm_hash_pointer(&int2));
+    assert(hm_compare_string(string1, string2) == 0);
+    assert(hm_compare_string(string1, long_string) != 0);
+    assert(hm_compare_int(&int1, &int2) == 0);
+    assert(hm_compare_uint64(&uint1, &uint2) == 0);
+    assert(hm_compare_pointer(&int1, &int1) == 0);
+    assert(hm_compare_pointer(&int1, &int2) != 0);
+
+    uint64_t hash = hm_hash_string(string1);
+    hm_set_hash_seed(1);
+    assert(hm_hash_string(string1) != hash);
+
+    struct HashMap *hashmap = hm_create(4, hm_hash_string, hm_compare_string);
+
+    assert(hm_set(hashmap, string1, &int1) == 0);
+    assert(hm_set(hashmap, long_string, &int2) == 0);
+    assert(hm_get(hashmap, string2) == &int1);
+    assert(hm_get(hashmap, long_string) == &int2);
+    assert(hm_get(hashmap, "channel") == NULL);
+
+    hm_free(hashmap, NULL);
+
+    printf("hm_hash_functions passed\n");
+
+    return;
+}
+
+void test_hm_batch()
+{
+    printf("Testing hm_batch\n");
+
+    struct HashMap *hashmap = hm_create(4, hm_hash_int, hm_compare_int);
+
+    int keys[100];
+    int values[100];
+    void *key_pointers[100];
+    void *value_pointers[100];
+    void *results[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        keys[i] = i;
+        values[i] = i * 10;
+        key_pointers[i] = &keys[i];
+        value_pointers[i] = &values[i];
+    }
+
+    assert(hm_set_many(hashmap, key_pointers, value_pointers, 50) == 0);
+    assert(hashmap->size == 50);
+
+    hm_get_many(hashmap, key_pointers, 100, results);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(results[i] == (i < 50 ? &values[i] : NULL));
+    }
+
+    assert(hm_set_many(hashmap, key_pointers, value_pointers, 100) == 0);
+    assert(hashmap->size == 100);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(hm_get(hashmap, &keys[i]) == &values[i]);
+    }
+
+    assert(hm_remove_many(hashmap, &key_pointers[25], 50, results) == 50);
+    assert(hm_remove_many(hashmap, &key_pointers[25], 50, NULL) == 0);
+    assert(hashmap->size == 50);
+
+    for (int i = 0; i < 50; i++)
+    {
+        assert(results[i] == &values[25 + i]);
+    }
+
+    hm_get_many(hashmap, key_pointers, 100, results);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(results[i] == (i < 25 || i >= 75 ? &values[i] : NULL));
+    }
+
+    hm_free(hashmap, NULL);
+
+    printf("hm_batch passed\n");
+
+    return;
+}
+
+void test_hm_iter()
+{
+    printf("Testing hm_iter\n");
+
+    struct HashMap *hashmap = hm_create(1024, hm_hash_int, hm_compare_int);
+    struct HashMapIterator iterator;
+    int keys[200];
+    int seen[200] = {0};
+
+    hm_iter_begin(hashmap, &iterator);
+
+    assert(hm_iter_next(&iterator) == NULL);
+    assert(hm_iter_remove(&iterator) == NULL);
+
+    for (int i = 0; i < 200; i++)
+    {
+        keys[i] = i;
+
+        assert(hm_set(hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    struct HashMapEntry *entry;
+    int count = 0;
+
+    hm_iter_begin(hashmap, &iterator);
+
+    while ((entry = hm_iter_next(&iterator)) != NULL)
+    {
+        int key = *(int *)entry->key;
+
+        assert(entry->value == &keys[key]);
+        assert(hm_get(hashmap, &key) == &keys[key]);
+        assert(seen[key] == 0);
+
+        seen[key] = 1;
+        count++;
+
+        if (key % 3 != 0)
+        {
+            assert(hm_iter_remove(&iterator) == &keys[key]);
+        }
+    }
+
+    assert(count == 200);
+    assert(hashmap->size == 67);
+
+    for (int i = 0; i < 200; i++)
+    {
+        assert(hm_get(hashmap, &keys[i]) == (i % 3 == 0 ? &keys[i] : NULL));
+    }
+
+    count = 0;
+    hm_iter_begin(hashmap, &iterator);
+
+    while (hm_iter_next(&iterator) != NULL)
+    {
+        hm_iter_remove(&iterator);
+        count++;
+    }
+
+    assert(count == 67);
+    assert(hashmap->size == 0);
+
+    for (size_t i = 0; i < HM_OCCUPIED_WORDS(hashmap->capacity); i++)
+    {
+        assert(hashmap->occupied[i] == 0);
+    }
+
+    hm_free(hashmap, NULL);
+
+    printf("hm_iter passed\n");
+
+    return;
+}
+
+void test_hm_iter_while_rehashing()
+{
+    printf("Testing hm_iter_while_rehashing\n");
+
+    struct HashMapIterator iterator;
+    struct HashMapEntry *entry;
+    int keys[1000];
+
+    for (int i = 0; i < 1000; i++)
+    {
+        keys[i] = i;
+    }
+
+    struct Allocator allocator = {limited_alloc, NULL, limited_free, NULL};
+
+    for (int round = 0; round < 3; round++)
+    {
+        struct HashMap *hashmap =
+            hm_create_with_allocator(4, hm_hash_int, hm_compare_int, &allocator);
+        int seen[1000] = {0};
+        int count = 0;
+        int size = 0;
+
+        while (hashmap->is_small || hashmap->old_buckets == NULL ||
+               hashmap->capacity < 256)
+        {
+            assert(hm_set(hashmap, &keys[size], &keys[size]) == 0);
+            size++;
+        }
+
+        hm_iter_begin(hashmap, &iterator);
+
+        assert(hashmap->old_buckets != NULL);
+        assert(hashmap->rehash_index == 0);
+
+        if (round == 2)
+        {
+            allocations_left = 0;
+
+            while (pool_alloc(hashmap->bucket_pool) != NULL)
+            {
+            }
+        }
+
+        while ((entry = hm_iter_next(&iterator)) != NULL)
+        {
+            int key = *(int *)entry->key;
+
+            assert(key < size);
+            assert(seen[key] == 0);
+
+            if (round == 1)
+            {
+                int other = (key * 7) % size;
+
+                assert(hm_get(hashmap, &keys[other]) ==
+                       (other % 5 == 0 && seen[other] ? NULL : &keys[other]));
+            }
+
+            seen[key] = 1;
+            count++;
+
+            if (key % 5 == 0)
+            {
+                assert(hm_iter_remove(&iterator) == &keys[key]);
+            }
+        }
+
+        allocations_left = -1;
+
+        assert(count == size);
+        assert((int)hm_size(hashmap) == size - (size + 4) / 5);
+
+        for (int i = 0; i < size; i++)
+        {
+            assert(hm_get(hashmap, &keys[i]) == (i % 5 == 0 ? NULL : &keys[i]));
+        }
+
+        hm_free(hashmap, NULL);
+    }
+
+    printf("hm_iter_while_rehashing passed\n");
+
+    return;
+}
+
+void test_hm_size_and_sparse_free()
+{
+    printf("Testing hm_size_and_sparse_free\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct HashMap *hashmap =
+        hm_create_with_allocator(4096, hm_hash_int, hm_compare_int, allocator);
+    int *keys[5];
+
+    assert(hm_size(hashmap) == 0);
+
+    for (int i = 0; i < 5; i++)
+    {
+        int *value = malloc(sizeof(int));
+        keys[i] = malloc(sizeof(int));
+        *keys[i] = i;
+        *value = i;
+
+        assert(hm_set(hashmap, keys[i], value) == 0);
+    }
+
+    free(hm_remove(hashmap, keys[4]));
+    free(keys[4]);
+
+    assert(hm_size(hashmap) == 4);
+
+    int occupied_buckets = 0;
+
+    for (size_t i = 0; i < HM_OCCUPIED_WORDS(hashmap->capacity); i++)
+    {
+        occupied_buckets += __builtin_popcountll(hashmap->occupied[i]);
+    }
+
+    assert(occupied_buckets <= 4 && occupied_buckets > 0);
+
+    freed_entries = 0;
+    hm_free(hashmap, counting_entry_free_function);
+
+    assert(freed_entries == 4);
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("hm_size_and_sparse_free passed\n");
+
+    return;
+}
+
+void test_hm_lazy_buckets()
+{
+    printf("Testing hm_lazy_buckets\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct HashMap *hashmap =
+        hm_create_with_allocator(65536, hm_hash_int, hm_compare_int, allocator);
+    size_t allocations = counting_allocator.allocations;
+
+    assert(allocations < 8);
+
+    for (size_t i = 0; i < hashmap->capacity; i++)
+    {
+        assert(hashmap->buckets[i] == NULL);
+    }
+
+    int key = 42;
+    size_t index = hm_hash_int(&key) & (hashmap->capacity - 1);
+
+    assert(hm_get(hashmap, &key) == NULL);
+    assert(hm_remove(hashmap, &key) == NULL);
+    assert(hm_set(hashmap, &key, &key) == 0);
+    assert(hashmap->buckets[index] != NULL);
+    assert(hm_get(hashmap, &key) == &key);
+    assert(hm_remove(hashmap, &key) == &key);
+
+    hm_free(hashmap, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("hm_lazy_buckets passed\n");
+
+    return;
+}
+
+void test_hm_small()
+{
+    printf("Testing hm_small\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct HashMap *hashmap =
+        hm_create_with_allocator(0, hm_hash_int, hm_compare_int, allocator);
+    struct HashMapIterator iterator;
+    int keys[HM_SMALL_CAPACITY + 1];
+
+    for (int i = 0; i < HM_SMALL_CAPACITY; i++)
+    {
+        keys[i] = i;
+
+        assert(hm_set(hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    assert(hm_set(hashmap, &keys[0], &keys[1]) == 0);
+    assert(hm_get(hashmap, &keys[0]) == &keys[1]);
+    assert(hm_set(hashmap, &keys[0], &keys[0]) == 0);
+
+    assert(counting_allocator.allocations == 1);
+    assert(hashmap->is_small);
+    assert(hm_size(hashmap) == HM_SMALL_CAPACITY);
+
+    assert(hm_remove(hashmap, &keys[2]) == &keys[2]);
+    assert(hm_remove(hashmap, &keys[2]) == NULL);
+    assert(hm_get(hashmap, &keys[2]) == NULL);
+    assert(hm_get(hashmap, &keys[7]) == &keys[7]);
+
+    int seen = 0;
+    struct HashMapEntry *entry;
+
+    hm_iter_begin(hashmap, &iterator);
+
+    while ((entry = hm_iter_next(&iterator)) != NULL)
+    {
+        seen |= 1 << *(int *)entry->key;
+
+        if (*(int *)entry->key % 2 == 1)
+        {
+            void *value = entry->value;
+
+            assert(hm_iter_remove(&iterator) == value);
+        }
+    }
+
+    assert(seen == ((1 << HM_SMALL_CAPACITY) - 1) - (1 << 2));
+    assert(hm_size(hashmap) == HM_SMALL_CAPACITY / 2 - 1);
+
+    for (int i = 1; i < HM_SMALL_CAPACITY; i += 2)
+    {
+        assert(hm_set(hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    assert(hm_set(hashmap, &keys[2], &keys[2]) == 0);
+    assert(hashmap->is_small);
+
+    keys[HM_SMALL_CAPACITY] = HM_SMALL_CAPACITY;
+
+    assert(hm_set(hashmap, &keys[HM_SMALL_CAPACITY], &keys[HM_SMALL_CAPACITY]) == 0);
+    assert(!hashmap->is_small);
+    assert(hashmap->capacity == HM_SMALL_CAPACITY * 2);
+    assert(hm_size(hashmap) == HM_SMALL_CAPACITY + 1);
+
+    for (int i = 0; i <= HM_SMALL_CAPACITY; i++)
+    {
+        assert(hm_get(hashmap, &keys[i]) == &keys[i]);
+    }
+
+    hm_free(hashmap, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    struct Allocator limited_allocator = {limited_alloc, NULL, limited_free, NULL};
+    size_t upgraded = 0;
+
+    for (int limit = 0; !upgraded; limit++)
+    {
+        hashmap = hm_create_with_allocator(0, hm_hash_int, hm_compare_int,
+                                           &limited_allocator);
+
+        for (int i = 0; i < HM_SMALL_CAPACITY; i++)
+        {
+            assert(hm_set(hashmap, &keys[i], &keys[i]) == 0);
+        }
+
+        allocations_left = limit;
+        upgraded = hm_set(hashmap, &keys[HM_SMALL_CAPACITY], &keys[0]) == 0;
+        allocations_left = -1;
+
+        assert(hashmap->is_small || hashmap->capacity == HM_SMALL_CAPACITY * 2);
+        assert(hm_size(hashmap) == HM_SMALL_CAPACITY + upgraded);
+        assert(hm_get(hashmap, &keys[HM_SMALL_CAPACITY]) ==
+               (upgraded ? &keys[0] : NULL));
+
+        for (int i = 0; i < HM_SMALL_CAPACITY; i++)
+        {
+            assert(hm_get(hashmap, &keys[i]) == &keys[i]);
+        }
+
+        hm_free(hashmap, NULL);
+    }
+
+    printf("hm_small passed\n");
+
+    return;
+}
+
+void test_hm_stats()
+{
+    printf("Testing hm_stats\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct HashMap *hashmap =
+        hm_create_with_allocator(0, hm_hash_int, hm_compare_int, allocator);
+    int keys[100];
+    char line[1024];
+    char expected[128];
+
+    for (int i = 0; i < 100; i++)
+    {
+        keys[i] = i;
+
+        assert(hm_set(hashmap, &keys[i], &keys[i]) == 0);
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        int missing = 100 + i;
+
+        assert(hm_get(hashmap, &keys[i]) == &keys[i]);
+        assert(hm_get(hashmap, &missing) == NULL);
+    }
+
+    FILE *stream = tmpfile();
+
+    assert(hm_stats(hashmap, stream) == 0);
+
+    rewind(stream);
+
+    assert(fgets(line, sizeof(line), stream) != NULL);
+    assert(line[0] == '{');
+    assert(strcmp(line + strlen(line) - 2, "}\n") == 0);
+
+    snprintf(expected, sizeof(expected), "\"size\":100,\"capacity\":%zu,",
+             hashmap->capacity);
+    assert(strstr(line, expected) != NULL);
+
+    snprintf(expected, sizeof(expected), "\"bytes\":%zu,",
+             counting_allocator.bytes_in_use);
+    assert(strstr(line, expected) != NULL);
+    assert(strstr(line, "\"chain_histogram\":[") != NULL);
+
+#if HM_STATS
+    assert(hashmap->stats.lookups == 300);
+    assert(hashmap->stats.hits == 100);
+    assert(hashmap->stats.resizes >= 4);
+    assert(strstr(line, "\"probe_histogram\":[") != NULL);
+#else
+    assert(hashmap->stats.lookups == 0);
+    assert(strstr(line, "\"lookups\"") == NULL);
+#endif
+
+    fclose(stream);
+
+    hm_free(hashmap, NULL);
+
+    hashmap = hm_create(0, hm_hash_int, hm_compare_int);
+
+    for (int i = 0; i <= HM_SMALL_CAPACITY; i++)
+    {
+        assert(hm_entry(hashmap, &keys[i], NULL) != NULL);
+    }
+
+    assert(!hashmap->is_small);
+    assert(hashmap->stats.lookups == (HM_STATS ? HM_SMALL_CAPACITY + 1 : 0));
+    assert(hashmap->stats.hits == 0);
+
+    hm_free(hashmap, NULL);
+
+    printf("hm_stats passed\n");
+
+    return;
+}
+
+void test_hm_entry()
+{
+    printf("Testing hm_entry\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct HashMap *hashmap =
+        hm_create_with_allocator(0, hm_hash_int, hm_compare_int, allocator);
+    int keys[100];
+    long counts[100] = {0};
+    int inserted;
+
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            keys[i] = i;
+
+            void **slot = hm_entry(hashmap, &keys[i], &inserted);
+
+            assert(slot != NULL);
+            assert(inserted == (round == 0));
+
+            if (inserted)
+            {
+                assert(*slot == NULL);
+
+                *slot = &counts[i];
+            }
+
+            (*(long *)*slot)++;
+        }
+    }
+
+    assert(hm_size(hashmap) == 100);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(hm_get(hashmap, &keys[i]) == &counts[i]);
+        assert(counts[i] == 3);
+    }
+
+    size_t allocations = counting_allocator.allocations;
+    int other_key = 5;
+    void *old_value = &counts[0];
+    long value = 0;
+
+    assert(hm_entry(hashmap, &keys[7], NULL) != NULL);
+    assert(hm_get_or_insert(hashmap, &keys[7], &value) == &counts[7]);
+    assert(hm_upsert(hashmap, &other_key, &value, &old_value) == 1);
+    assert(old_value == &counts[5]);
+    assert(hm_get(hashmap, &keys[5]) == &value);
+    assert(counting_allocator.allocations == allocations);
+
+    int new_key = 100;
+
+    assert(hm_get_or_insert(hashmap, &new_key, &value) == &value);
+    assert(hm_upsert(hashmap, &new_key, &counts[0], NULL) == 1);
+    assert(hm_get(hashmap, &new_key) == &counts[0]);
+
+    int newer_key = 101;
+
+    assert(hm_upsert(hashmap, &newer_key, &value, &old_value) == 0);
+    assert(old_value == NULL);
+    assert(hm_size(hashmap) == 102);
+
+    hm_free(hashmap, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("hm_entry passed\n");
+
+    return;
+}
+
 int main()
 {
     printf("Running tests for \"lib/hashmap.c\"\n");
@@ -207,6 +944,16 @@ int main()
     test_hm_set();
     test_hm_get();
     test_hm_remove();
+    test_hm_batch();
+    test_hm_iter();
+    test_hm_iter_while_rehashing();
+    test_hm_size_and_sparse_free();
+    test_hm_lazy_buckets();
+    test_hm_small();
+    test_hm_stats();
+    test_hm_entry();
+    test_hm_resize();
+    test_hm_hash_functions();
 
     printf("All tests passed for \"lib/hashmap.c\"\n\n");
 
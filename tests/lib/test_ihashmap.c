@@ -0,0 +1,178 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/ihashmap.h"
+
+struct Session
+{
+    int id;
+    struct IntrusiveHashMapNode node;
+};
+
+int session_compare_function(struct IntrusiveHashMapNode *node, void *key)
+{
+    return container_of(node, struct Session, node)->id - *(int *)key;
+}
+
+uint64_t collide_hash_function(void *key)
+{
+    return (uint64_t)(*(int *)key % 2);
+}
+
+void session_free_function(struct IntrusiveHashMapNode *node)
+{
+    free(container_of(node, struct Session, node));
+}
+
+void test_ihm_create()
+{
+    printf("Testing ihm_create\n");
+
+    struct IntrusiveHashMap *intrusive_hashmap =
+        ihm_create(10, hm_hash_int, session_compare_function);
+
+    assert(intrusive_hashmap != NULL);
+    assert(intrusive_hashmap->capacity == 16);
+    assert(intrusive_hashmap->size == 0);
+
+    for (size_t i = 0; i < intrusive_hashmap->capacity; i++)
+    {
+        assert(intrusive_hashmap->buckets[i] == NULL);
+    }
+
+    ihm_free(intrusive_hashmap, NULL);
+
+    printf("ihm_create passed\n");
+
+    return;
+}
+
+void test_ihm_set_and_get()
+{
+    printf("Testing ihm_set_and_get\n");
+
+    struct IntrusiveHashMap *intrusive_hashmap =
+        ihm_create(4, hm_hash_int, session_compare_function);
+    struct Session sessions[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        sessions[i].id = i;
+
+        assert(ihm_set(intrusive_hashmap, &sessions[i].id, &sessions[i].node) == NULL);
+    }
+
+    assert(intrusive_hashmap->size == 100);
+    assert(intrusive_hashmap->capacity == 256);
+
+    for (int i = 0; i < 100; i++)
+    {
+        struct IntrusiveHashMapNode *node = ihm_get(intrusive_hashmap, &i);
+
+        assert(container_of(node, struct Session, node) == &sessions[i]);
+    }
+
+    int missing = 100;
+
+    assert(ihm_get(intrusive_hashmap, &missing) == NULL);
+
+    struct Session replacement = {.id = 42};
+
+    assert(ihm_set(intrusive_hashmap, &replacement.id, &replacement.node) ==
+           &sessions[42].node);
+    assert(ihm_get(intrusive_hashmap, &replacement.id) == &replacement.node);
+    assert(intrusive_hashmap->size == 100);
+
+    ihm_free(intrusive_hashmap, NULL);
+
+    printf("ihm_set_and_get passed\n");
+
+    return;
+}
+
+void test_ihm_remove()
+{
+    printf("Testing ihm_remove\n");
+
+    struct IntrusiveHashMap *intrusive_hashmap =
+        ihm_create(16, collide_hash_function, session_compare_function);
+    struct Session sessions[6];
+
+    for (int i = 0; i < 6; i++)
+    {
+        sessions[i].id = i;
+        ihm_set(intrusive_hashmap, &sessions[i].id, &sessions[i].node);
+    }
+
+    int key = 2;
+
+    assert(ihm_remove(intrusive_hashmap, &key) == &sessions[2].node);
+    assert(ihm_remove(intrusive_hashmap, &key) == NULL);
+    assert(ihm_get(intrusive_hashmap, &key) == NULL);
+
+    assert(ihm_remove_node(intrusive_hashmap, &sessions[4].node) == 0);
+    assert(ihm_remove_node(intrusive_hashmap, &sessions[4].node) == -1);
+    assert(intrusive_hashmap->size == 4);
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (i == 2 || i == 4)
+        {
+            continue;
+        }
+
+        assert(ihm_get(intrusive_hashmap, &i) == &sessions[i].node);
+    }
+
+    ihm_free(intrusive_hashmap, NULL);
+
+    printf("ihm_remove passed\n");
+
+    return;
+}
+
+void test_ihm_with_allocator()
+{
+    printf("Testing ihm_with_allocator\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct IntrusiveHashMap *intrusive_hashmap = ihm_create_with_allocator(
+        1024, hm_hash_int, session_compare_function, allocator);
+    size_t allocations = counting_allocator.allocations;
+
+    for (int i = 0; i < 500; i++)
+    {
+        struct Session *session = malloc(sizeof(struct Session));
+        session->id = i;
+
+        ihm_set(intrusive_hashmap, &session->id, &session->node);
+    }
+
+    assert(counting_allocator.allocations == allocations);
+
+    ihm_free(intrusive_hashmap, session_free_function);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("ihm_with_allocator passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/ihashmap.c\"\n");
+
+    test_ihm_create();
+    test_ihm_set_and_get();
+    test_ihm_remove();
+    test_ihm_with_allocator();
+
+    printf("All tests passed for \"lib/ihashmap.c\"\n\n");
+
+    return 0;
+}
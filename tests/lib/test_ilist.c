@@ -0,0 +1,149 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/ilist.h"
+
+struct Client
+{
+    int id;
+    struct IntrusiveListNode channel_node;
+    struct IntrusiveListNode lru_node;
+};
+
+void test_il_init()
+{
+    printf("Testing il_init\n");
+
+    struct IntrusiveList intrusive_list;
+
+    il_init(&intrusive_list);
+
+    assert(intrusive_list.size == 0);
+    assert(intrusive_list.head == NULL);
+    assert(intrusive_list.tail == NULL);
+    assert(il_pop(&intrusive_list) == NULL);
+    assert(il_pop_front(&intrusive_list) == NULL);
+
+    printf("il_init passed\n");
+
+    return;
+}
+
+void test_il_push_and_pop()
+{
+    printf("Testing il_push_and_pop\n");
+
+    struct IntrusiveList intrusive_list;
+    struct Client clients[3] = {{.id = 1}, {.id = 2}, {.id = 3}};
+
+    il_init(&intrusive_list);
+
+    il_push(&intrusive_list, &clients[1].channel_node);
+    il_push(&intrusive_list, &clients[2].channel_node);
+    il_push_front(&intrusive_list, &clients[0].channel_node);
+
+    assert(intrusive_list.size == 3);
+    assert(container_of(intrusive_list.head, struct Client, channel_node)->id == 1);
+    assert(container_of(intrusive_list.tail, struct Client, channel_node)->id == 3);
+
+    struct IntrusiveListNode *node = il_pop(&intrusive_list);
+
+    assert(container_of(node, struct Client, channel_node) == &clients[2]);
+    assert(node->prev == NULL && node->next == NULL);
+
+    node = il_pop_front(&intrusive_list);
+
+    assert(container_of(node, struct Client, channel_node) == &clients[0]);
+    assert(intrusive_list.head == &clients[1].channel_node);
+    assert(intrusive_list.tail == &clients[1].channel_node);
+    assert(intrusive_list.head->prev == NULL);
+    assert(intrusive_list.size == 1);
+
+    printf("il_push_and_pop passed\n");
+
+    return;
+}
+
+void test_il_insert_and_remove()
+{
+    printf("Testing il_insert_and_remove\n");
+
+    struct IntrusiveList intrusive_list;
+    struct Client clients[4] = {{.id = 1}, {.id = 2}, {.id = 3}, {.id = 4}};
+
+    il_init(&intrusive_list);
+
+    il_push(&intrusive_list, &clients[2].channel_node);
+    il_insert_before(&intrusive_list, &clients[2].channel_node,
+                     &clients[0].channel_node);
+    il_insert_after(&intrusive_list, &clients[0].channel_node,
+                    &clients[1].channel_node);
+    il_insert_after(&intrusive_list, &clients[2].channel_node,
+                    &clients[3].channel_node);
+
+    struct IntrusiveListNode *current_node = intrusive_list.head;
+
+    for (int i = 0; i < 4; i++)
+    {
+        assert(container_of(current_node, struct Client, channel_node)->id == i + 1);
+
+        current_node = current_node->next;
+    }
+
+    il_remove(&intrusive_list, &clients[1].channel_node);
+    il_remove(&intrusive_list, &clients[3].channel_node);
+
+    assert(intrusive_list.size == 2);
+    assert(intrusive_list.head->next == &clients[2].channel_node);
+    assert(intrusive_list.tail == &clients[2].channel_node);
+    assert(intrusive_list.tail->prev == &clients[0].channel_node);
+
+    printf("il_insert_and_remove passed\n");
+
+    return;
+}
+
+void test_il_many_lists()
+{
+    printf("Testing il_many_lists\n");
+
+    struct IntrusiveList channel;
+    struct IntrusiveList lru;
+    struct Client clients[3] = {{.id = 1}, {.id = 2}, {.id = 3}};
+
+    il_init(&channel);
+    il_init(&lru);
+
+    for (int i = 0; i < 3; i++)
+    {
+        il_push(&channel, &clients[i].channel_node);
+        il_push_front(&lru, &clients[i].lru_node);
+    }
+
+    il_remove(&lru, &clients[0].lru_node);
+
+    assert(channel.size == 3);
+    assert(lru.size == 2);
+    assert(container_of(channel.head, struct Client, channel_node)->id == 1);
+    assert(container_of(lru.head, struct Client, lru_node)->id == 3);
+    assert(container_of(lru.tail, struct Client, lru_node)->id == 2);
+
+    printf("il_many_lists passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/ilist.c\"\n");
+
+    test_il_init();
+    test_il_push_and_pop();
+    test_il_insert_and_remove();
+    test_il_many_lists();
+
+    printf("All tests passed for \"lib/ilist.c\"\n\n");
+
+    return 0;
+}
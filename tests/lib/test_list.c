@@ -25,6 +25,7 @@ void test_ll_create()
     assert(linked_list->head == NULL);
     assert(linked_list->tail == NULL);
     assert(linked_list->value_compare_function == int_compare_function);
+    assert(linked_list->node_pool == NULL);
 
     ll_free(linked_list, int_free_function);
 
@@ -33,6 +34,44 @@ void test_ll_create()
     return;
 }
 
+void test_ll_create_with_pool()
+{
+    printf("Testing ll_create_with_pool\n");
+
+    struct Pool *pool = pool_create(sizeof(struct LinkedListNode), 64);
+    struct LinkedList *linked_list = ll_create_with_pool(int_compare_function, pool);
+
+    assert(linked_list != NULL);
+    assert(linked_list->size == 0);
+    assert(linked_list->node_pool == pool);
+
+    int *value = malloc(sizeof(int));
+    *value = 42;
+    int *value2 = malloc(sizeof(int));
+    *value2 = 43;
+
+    assert(ll_push(linked_list, value) == 0);
+
+    struct LinkedListNode *node = linked_list->head;
+
+    assert(ll_pop(linked_list) == value);
+    assert(pool->free_list == node);
+    assert(ll_push(linked_list, value2) == 0);
+    assert(linked_list->head == node);
+    assert(pool->free_list == NULL);
+
+    ll_free(linked_list, int_free_function);
+
+    assert(pool->free_list == node);
+
+    pool_free(pool);
+    free(value);
+
+    printf("ll_create_with_pool passed\n");
+
+    return;
+}
+
 void test_ll_has_node()
 {
     printf("Testing ll_has_node\n");
@@ -184,6 +223,47 @@ void test_ll_pop()
     return;
 }
 
+void test_ll_push_front_and_pop_front()
+{
+    printf("Testing ll_push_front_and_pop_front\n");
+
+    struct LinkedList *linked_list = ll_create(int_compare_function);
+    int values[3] = {1, 2, 3};
+
+    assert(ll_pop_front(linked_list) == NULL);
+    assert(ll_peek_front(linked_list) == NULL);
+    assert(ll_peek_back(linked_list) == NULL);
+
+    assert(ll_push_front(linked_list, &values[1]) == 0);
+    assert(linked_list->head == linked_list->tail);
+
+    assert(ll_push_front(linked_list, &values[0]) == 0);
+    assert(ll_push(linked_list, &values[2]) == 0);
+
+    assert(linked_list->size == 3);
+    assert(ll_peek_front(linked_list) == &values[0]);
+    assert(ll_peek_back(linked_list) == &values[2]);
+
+    for (int i = 0; i < 3; i++)
+    {
+        assert(ll_pop_front(linked_list) == &values[i]);
+    }
+
+    assert(linked_list->size == 0);
+    assert(linked_list->head == NULL);
+    assert(linked_list->tail == NULL);
+
+    assert(ll_push(linked_list, &values[0]) == 0);
+    assert(ll_peek_front(linked_list) == &values[0]);
+    assert(ll_peek_back(linked_list) == &values[0]);
+
+    ll_free(linked_list, NULL);
+
+    printf("ll_push_front_and_pop_front passed\n");
+
+    return;
+}
+
 void test_ll_insert_before_node()
 {
     printf("Testing ll_insert_before_node\n");
@@ -473,15 +553,81 @@ void test_ll_remove_value()
     return;
 }
 
+void test_ll_iter()
+{
+    printf("Testing ll_iter\n");
+
+    struct LinkedList *linked_list = ll_create(int_compare_function);
+    struct LinkedListIterator iterator;
+    int values[6] = {0, 1, 2, 3, 4, 5};
+
+    ll_iter_begin(linked_list, &iterator);
+
+    assert(ll_iter_next(&iterator) == NULL);
+    assert(ll_iter_remove(&iterator) == NULL);
+
+    for (int i = 0; i < 6; i++)
+    {
+        assert(ll_push(linked_list, &values[i]) == 0);
+    }
+
+    struct LinkedListNode *node;
+    int count = 0;
+
+    ll_iter_begin(linked_list, &iterator);
+
+    while ((node = ll_iter_next(&iterator)) != NULL)
+    {
+        assert(node->value == &values[count]);
+
+        if (*(int *)node->value % 2 == 0 || *(int *)node->value == 5)
+        {
+            assert(ll_iter_remove(&iterator) == &values[count]);
+            assert(ll_iter_remove(&iterator) == NULL);
+        }
+
+        count++;
+    }
+
+    assert(count == 6);
+    assert(linked_list->size == 2);
+    assert(linked_list->head->value == &values[1]);
+    assert(linked_list->tail->value == &values[3]);
+    assert(linked_list->tail->next == NULL);
+
+    assert(ll_push(linked_list, &values[4]) == 0);
+    assert(linked_list->tail->value == &values[4]);
+
+    ll_iter_begin(linked_list, &iterator);
+
+    while (ll_iter_next(&iterator) != NULL)
+    {
+        ll_iter_remove(&iterator);
+    }
+
+    assert(linked_list->size == 0);
+    assert(linked_list->head == NULL);
+    assert(linked_list->tail == NULL);
+
+    ll_free(linked_list, NULL);
+
+    printf("ll_iter passed\n");
+
+    return;
+}
+
 int main()
 {
     printf("Running tests for \"lib/list.c\"\n");
 
     test_ll_create();
+    test_ll_create_with_pool();
     test_ll_has_node();
     test_ll_get_node_by_value();
     test_ll_push();
     test_ll_pop();
+    test_ll_push_front_and_pop_front();
+    test_ll_iter();
     test_ll_insert_before_node();
     test_ll_insert_before_value();
     test_ll_insert_after_node();
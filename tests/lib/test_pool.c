@@ -0,0 +1,142 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/pool.h"
+
+void test_pool_create()
+{
+    printf("Testing pool_create\n");
+
+    struct Pool *pool = pool_create(12, 64);
+
+    assert(pool != NULL);
+    assert(pool->object_size == 16);
+    assert(pool->max_objects_per_slab == 64);
+    assert(pool->slab_objects == POOL_MIN_SLAB_OBJECTS);
+    assert(pool->slabs == NULL);
+    assert(pool->free_list == NULL);
+
+    pool_free(pool);
+
+    pool = pool_create(1, 1);
+
+    assert(pool->object_size == sizeof(void *));
+    assert(pool->max_objects_per_slab == POOL_MIN_SLAB_OBJECTS);
+
+    pool_free(pool);
+
+    printf("pool_create passed\n");
+
+    return;
+}
+
+void test_pool_alloc()
+{
+    printf("Testing pool_alloc\n");
+
+    struct Pool *pool = pool_create(sizeof(int), 32);
+
+    int *objects[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        objects[i] = pool_alloc(pool);
+
+        assert(objects[i] != NULL);
+        assert((uintptr_t)objects[i] % POOL_ALIGNMENT == 0);
+
+        *objects[i] = i;
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(*objects[i] == i);
+
+        for (int j = 0; j < i; j++)
+        {
+            assert(objects[i] != objects[j]);
+        }
+    }
+
+    assert(pool->slab_objects == 32);
+
+    pool_free(pool);
+
+    printf("pool_alloc passed\n");
+
+    return;
+}
+
+void test_pool_release()
+{
+    printf("Testing pool_release\n");
+
+    struct Pool *pool = pool_create(sizeof(int), 32);
+
+    int *object = pool_alloc(pool);
+    int *object2 = pool_alloc(pool);
+
+    pool_release(pool, object);
+
+    assert(pool->free_list == object);
+    assert(pool_alloc(pool) == object);
+    assert(pool->free_list == NULL);
+
+    pool_release(pool, object);
+    pool_release(pool, object2);
+
+    assert(pool_alloc(pool) == object2);
+    assert(pool_alloc(pool) == object);
+    assert(pool_alloc(pool) != object2);
+
+    pool_free(pool);
+
+    printf("pool_release passed\n");
+
+    return;
+}
+
+void test_pool_bytes()
+{
+    printf("Testing pool_bytes\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct Pool *pool = pool_create_with_allocator(sizeof(int), 32, allocator);
+
+    assert(pool_bytes(pool) == sizeof(struct Pool));
+
+    for (int i = 0; i < 100; i++)
+    {
+        int *object = pool_alloc(pool);
+
+        assert(pool_bytes(pool) == counting_allocator.bytes_in_use);
+
+        pool_release(pool, object);
+        pool_alloc(pool);
+    }
+
+    pool_free(pool);
+
+    printf("pool_bytes passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/pool.c\"\n");
+
+    test_pool_create();
+    test_pool_alloc();
+    test_pool_release();
+    test_pool_bytes();
+
+    printf("All tests passed for \"lib/pool.c\"\n\n");
+
+    return 0;
+}
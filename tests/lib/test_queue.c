@@ -0,0 +1,236 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/queue.h"
+
+#define PRODUCERS 4
+#define VALUES_PER_PRODUCER 100000
+
+struct Producer
+{
+    struct MpscQueue *queue;
+    uintptr_t first_value;
+};
+
+void *mpsc_producer(void *argument)
+{
+    struct Producer *producer = argument;
+
+    for (uintptr_t i = 0; i < VALUES_PER_PRODUCER; i++)
+    {
+        while (mpsc_push(producer->queue, (void *)(producer->first_value + i)) != 0)
+        {
+        }
+    }
+
+    return NULL;
+}
+
+void *spsc_producer(void *argument)
+{
+    struct SpscRing *ring = argument;
+
+    for (uintptr_t i = 1; i <= VALUES_PER_PRODUCER; i++)
+    {
+        while (spsc_push(ring, (void *)i) != 0)
+        {
+        }
+    }
+
+    return NULL;
+}
+
+void test_spsc_push_and_pop()
+{
+    printf("Testing spsc_push_and_pop\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct SpscRing *ring = spsc_create_with_allocator(3, allocator);
+    int values[4] = {1, 2, 3, 4};
+
+    assert(ring->capacity == 4);
+    assert(spsc_pop(ring) == NULL);
+
+    for (int i = 0; i < 4; i++)
+    {
+        assert(spsc_push(ring, &values[i]) == 0);
+    }
+
+    assert(spsc_push(ring, &values[0]) == -1);
+    assert(spsc_pop(ring) == &values[0]);
+    assert(spsc_push(ring, &values[0]) == 0);
+
+    for (int i = 1; i < 4; i++)
+    {
+        assert(spsc_pop(ring) == &values[i]);
+    }
+
+    assert(spsc_pop(ring) == &values[0]);
+    assert(spsc_pop(ring) == NULL);
+
+    size_t allocations = counting_allocator.allocations;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(spsc_push(ring, &values[i % 4]) == 0);
+        assert(spsc_pop(ring) == &values[i % 4]);
+    }
+
+    assert(counting_allocator.allocations == allocations);
+
+    spsc_free(ring);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("spsc_push_and_pop passed\n");
+
+    return;
+}
+
+void test_spsc_threads()
+{
+    printf("Testing spsc_threads\n");
+
+    struct SpscRing *ring = spsc_create(64);
+    pthread_t thread;
+
+    assert(pthread_create(&thread, NULL, spsc_producer, ring) == 0);
+
+    for (uintptr_t expected = 1; expected <= VALUES_PER_PRODUCER;)
+    {
+        void *value = spsc_pop(ring);
+
+        if (value != NULL)
+        {
+            assert((uintptr_t)value == expected);
+
+            expected++;
+        }
+    }
+
+    assert(pthread_join(thread, NULL) == 0);
+    assert(spsc_pop(ring) == NULL);
+
+    spsc_free(ring);
+
+    printf("spsc_threads passed\n");
+
+    return;
+}
+
+void test_mpsc_push_and_pop()
+{
+    printf("Testing mpsc_push_and_pop\n");
+
+    struct MpscQueue *queue = mpsc_create(4);
+    int values[4] = {1, 2, 3, 4};
+
+    assert(queue->capacity == 4);
+    assert(mpsc_pop(queue) == NULL);
+
+    for (int lap = 0; lap < 3; lap++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            assert(mpsc_push(queue, &values[i]) == 0);
+        }
+
+        assert(mpsc_push(queue, &values[0]) == -1);
+
+        for (int i = 0; i < 4; i++)
+        {
+            assert(mpsc_pop(queue) == &values[i]);
+        }
+
+        assert(mpsc_pop(queue) == NULL);
+    }
+
+    mpsc_free(queue);
+
+    queue = mpsc_create(1);
+
+    assert(queue->capacity == MPSC_MIN_CAPACITY);
+
+    for (int lap = 0; lap < 3; lap++)
+    {
+        assert(mpsc_push(queue, &values[0]) == 0);
+        assert(mpsc_push(queue, &values[1]) == 0);
+        assert(mpsc_push(queue, &values[2]) == -1);
+        assert(mpsc_pop(queue) == &values[0]);
+        assert(mpsc_pop(queue) == &values[1]);
+        assert(mpsc_pop(queue) == NULL);
+    }
+
+    mpsc_free(queue);
+
+    printf("mpsc_push_and_pop passed\n");
+
+    return;
+}
+
+void test_mpsc_threads()
+{
+    printf("Testing mpsc_threads\n");
+
+    struct MpscQueue *queue = mpsc_create(256);
+    pthread_t threads[PRODUCERS];
+    struct Producer producers[PRODUCERS];
+    uintptr_t next_values[PRODUCERS];
+
+    for (int i = 0; i < PRODUCERS; i++)
+    {
+        producers[i].queue = queue;
+        producers[i].first_value = (uintptr_t)(i + 1) << 32;
+        next_values[i] = producers[i].first_value;
+
+        assert(pthread_create(&threads[i], NULL, mpsc_producer, &producers[i]) == 0);
+    }
+
+    for (int popped = 0; popped < PRODUCERS * VALUES_PER_PRODUCER;)
+    {
+        void *value = mpsc_pop(queue);
+
+        if (value != NULL)
+        {
+            int producer = (int)((uintptr_t)value >> 32) - 1;
+
+            assert((uintptr_t)value == next_values[producer]);
+
+            next_values[producer]++;
+            popped++;
+        }
+    }
+
+    for (int i = 0; i < PRODUCERS; i++)
+    {
+        assert(pthread_join(threads[i], NULL) == 0);
+    }
+
+    assert(mpsc_pop(queue) == NULL);
+
+    mpsc_free(queue);
+
+    printf("mpsc_threads passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/queue.c\"\n");
+
+    test_spsc_push_and_pop();
+    test_spsc_threads();
+    test_mpsc_push_and_pop();
+    test_mpsc_threads();
+
+    printf("All tests passed for \"lib/queue.c\"\n\n");
+
+    return 0;
+}
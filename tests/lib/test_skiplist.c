@@ -0,0 +1,376 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/hashmap.h"
+#include "lib/skiplist.h"
+
+#define THREADS 4
+#define VALUES_PER_THREAD 5000
+
+struct Worker
+{
+    struct SkipList *skip_list;
+    uint64_t *values;
+    int thread;
+    atomic_int *done;
+    atomic_size_t *removed;
+};
+
+void *insert_worker(void *argument)
+{
+    struct Worker *worker = argument;
+
+    for (int i = 0; i < VALUES_PER_THREAD; i++)
+    {
+        uint64_t *value = &worker->values[i * THREADS + worker->thread];
+
+        assert(sl_insert(worker->skip_list, value) == 0);
+    }
+
+    return NULL;
+}
+
+void *remove_worker(void *argument)
+{
+    struct Worker *worker = argument;
+
+    for (int i = 0; i < THREADS * VALUES_PER_THREAD; i += 2)
+    {
+        if (sl_remove(worker->skip_list, &worker->values[i]) == &worker->values[i])
+        {
+            atomic_fetch_add(worker->removed, 1);
+        }
+    }
+
+    return NULL;
+}
+
+void *churn_worker(void *argument)
+{
+    struct Worker *worker = argument;
+    uint64_t state = (uint64_t)worker->thread + 1;
+
+    for (int i = 0; i < VALUES_PER_THREAD * 4; i++)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        uint64_t *value = &worker->values[(state >> 33) % 256];
+
+        if (state & (1ULL << 62))
+        {
+            int result = sl_insert(worker->skip_list, value);
+
+            assert(result == 0 || result == 1);
+        }
+        else
+        {
+            void *removed = sl_remove(worker->skip_list, value);
+
+            assert(removed == NULL || removed == value);
+        }
+    }
+
+    return NULL;
+}
+
+void *scan_worker(void *argument)
+{
+    struct Worker *worker = argument;
+    struct SkipListIterator iterator;
+
+    while (!atomic_load(worker->done))
+    {
+        uint64_t *previous = NULL;
+        uint64_t *value;
+
+        assert(sl_iter_begin(worker->skip_list, NULL, &iterator) == 0);
+
+        while ((value = sl_iter_next(&iterator)) != NULL)
+        {
+            assert(previous == NULL || *previous < *value);
+
+            previous = value;
+        }
+
+        sl_iter_end(&iterator);
+    }
+
+    return NULL;
+}
+
+void run_workers(struct Worker *workers, void *(*function)(void *))
+{
+    pthread_t threads[THREADS];
+    pthread_t scanner;
+    atomic_int done = 0;
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        workers[i].done = &done;
+    }
+
+    assert(pthread_create(&scanner, NULL, scan_worker, &workers[0]) == 0);
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        assert(pthread_create(&threads[i], NULL, function, &workers[i]) == 0);
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        assert(pthread_join(threads[i], NULL) == 0);
+    }
+
+    atomic_store(&done, 1);
+
+    assert(pthread_join(scanner, NULL) == 0);
+
+    return;
+}
+
+void test_sl_create()
+{
+    printf("Testing sl_create\n");
+
+    struct SkipList *skip_list = sl_create(hm_compare_uint64);
+    struct SkipListIterator iterator;
+    uint64_t value = 1;
+
+    assert(skip_list != NULL);
+    assert(sl_size(skip_list) == 0);
+    assert(sl_get(skip_list, &value) == NULL);
+    assert(sl_remove(skip_list, &value) == NULL);
+
+    assert(sl_iter_begin(skip_list, NULL, &iterator) == 0);
+    assert(sl_iter_next(&iterator) == NULL);
+
+    sl_iter_end(&iterator);
+
+    sl_free(skip_list, NULL);
+
+    printf("sl_create passed\n");
+
+    return;
+}
+
+void test_sl_insert_get_remove()
+{
+    printf("Testing sl_insert_get_remove\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct SkipList *skip_list = sl_create_with_allocator(hm_compare_uint64, allocator);
+    uint64_t values[1000];
+    uint64_t equal_value = 7;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        values[i] = (uint64_t)(i * 7919 % 1000);
+
+        assert(sl_insert(skip_list, &values[i]) == 0);
+    }
+
+    assert(sl_size(skip_list) == 1000);
+    assert(sl_insert(skip_list, &equal_value) == 1);
+    assert(sl_size(skip_list) == 1000);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(sl_get(skip_list, &values[i]) == &values[i]);
+    }
+
+    uint64_t *removed = sl_remove(skip_list, &equal_value);
+
+    assert(removed != &equal_value);
+    assert(*removed == 7);
+    assert(sl_get(skip_list, &equal_value) == NULL);
+    assert(sl_remove(skip_list, &equal_value) == NULL);
+    assert(sl_insert(skip_list, &equal_value) == 0);
+    assert(sl_get(skip_list, removed) == &equal_value);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        if (values[i] % 2 == 0 && values[i] != 7)
+        {
+            assert(sl_remove(skip_list, &values[i]) == &values[i]);
+        }
+    }
+
+    assert(sl_size(skip_list) == 500);
+
+    sl_free(skip_list, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("sl_insert_get_remove passed\n");
+
+    return;
+}
+
+void test_sl_iter()
+{
+    printf("Testing sl_iter\n");
+
+    struct SkipList *skip_list = sl_create(hm_compare_uint64);
+    struct SkipListIterator iterator;
+    uint64_t values[500];
+    uint64_t from = 501;
+    uint64_t *value;
+
+    for (int i = 499; i >= 0; i--)
+    {
+        values[i] = (uint64_t)(i * 2);
+
+        assert(sl_insert(skip_list, &values[i]) == 0);
+    }
+
+    uint64_t expected = 0;
+
+    assert(sl_iter_begin(skip_list, NULL, &iterator) == 0);
+
+    while ((value = sl_iter_next(&iterator)) != NULL)
+    {
+        assert(*value == expected);
+
+        expected += 2;
+    }
+
+    sl_iter_end(&iterator);
+
+    assert(expected == 1000);
+
+    expected = 502;
+
+    assert(sl_iter_begin(skip_list, &from, &iterator) == 0);
+
+    while ((value = sl_iter_next(&iterator)) != NULL && *value < 600)
+    {
+        assert(*value == expected);
+
+        expected += 2;
+    }
+
+    sl_iter_end(&iterator);
+
+    assert(expected == 600);
+
+    sl_free(skip_list, NULL);
+
+    printf("sl_iter passed\n");
+
+    return;
+}
+
+void test_sl_threads()
+{
+    printf("Testing sl_threads\n");
+
+    struct SkipList *skip_list = sl_create(hm_compare_uint64);
+    uint64_t *values = malloc(THREADS * VALUES_PER_THREAD * sizeof(uint64_t));
+    struct Worker workers[THREADS];
+    atomic_size_t removed = 0;
+
+    for (int i = 0; i < THREADS * VALUES_PER_THREAD; i++)
+    {
+        values[i] = i;
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        workers[i].skip_list = skip_list;
+        workers[i].values = values;
+        workers[i].thread = i;
+        workers[i].removed = &removed;
+    }
+
+    run_workers(workers, insert_worker);
+
+    assert(sl_size(skip_list) == THREADS * VALUES_PER_THREAD);
+
+    run_workers(workers, remove_worker);
+
+    assert(atomic_load(&removed) == THREADS * VALUES_PER_THREAD / 2);
+    assert(sl_size(skip_list) == THREADS * VALUES_PER_THREAD / 2);
+
+    for (int i = 0; i < THREADS * VALUES_PER_THREAD; i++)
+    {
+        assert(sl_get(skip_list, &values[i]) == (i % 2 ? &values[i] : NULL));
+    }
+
+    sl_free(skip_list, NULL);
+    free(values);
+
+    printf("sl_threads passed\n");
+
+    return;
+}
+
+void test_sl_churn()
+{
+    printf("Testing sl_churn\n");
+
+    struct SkipList *skip_list = sl_create(hm_compare_uint64);
+    struct SkipListIterator iterator;
+    uint64_t values[256];
+    struct Worker workers[THREADS];
+    size_t count = 0;
+
+    for (int i = 0; i < 256; i++)
+    {
+        values[i] = i;
+    }
+
+    for (int i = 0; i < THREADS; i++)
+    {
+        workers[i].skip_list = skip_list;
+        workers[i].values = values;
+        workers[i].thread = i;
+    }
+
+    run_workers(workers, churn_worker);
+
+    assert(sl_iter_begin(skip_list, NULL, &iterator) == 0);
+
+    while (sl_iter_next(&iterator) != NULL)
+    {
+        count++;
+    }
+
+    sl_iter_end(&iterator);
+
+    assert(count == sl_size(skip_list));
+
+    for (int i = 0; i < 256; i++)
+    {
+        sl_remove(skip_list, &values[i]);
+    }
+
+    assert(sl_size(skip_list) == 0);
+
+    sl_free(skip_list, NULL);
+
+    printf("sl_churn passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/skiplist.c\"\n");
+
+    test_sl_create();
+    test_sl_insert_get_remove();
+    test_sl_iter();
+    test_sl_threads();
+    test_sl_churn();
+
+    printf("All tests passed for \"lib/skiplist.c\"\n\n");
+
+    return 0;
+}
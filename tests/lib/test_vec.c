@@ -0,0 +1,226 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/allocator.h"
+#include "lib/vec.h"
+
+struct Message
+{
+    int id;
+    char *text;
+};
+
+int int_order_function(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+void message_free_function(void *value)
+{
+    free(((struct Message *)value)->text);
+}
+
+void test_vec_create()
+{
+    printf("Testing vec_create\n");
+
+    struct Vector *vector = vec_create(sizeof(int));
+
+    assert(vector != NULL);
+    assert(vector->element_size == sizeof(int));
+    assert(vector->size == 0);
+    assert(vector->capacity == 0);
+    assert(vector->data == NULL);
+    assert(vec_get(vector, 0) == NULL);
+
+    vec_free(vector, NULL);
+
+    assert(vec_create(0) == NULL);
+
+    printf("vec_create passed\n");
+
+    return;
+}
+
+void test_vec_push_and_pop()
+{
+    printf("Testing vec_push_and_pop\n");
+
+    struct Vector *vector = vec_create(sizeof(int));
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(vec_push(vector, &i) == 0);
+    }
+
+    assert(vector->size == 100);
+    assert(vector->capacity == 128);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(*(int *)vec_get(vector, i) == i);
+    }
+
+    assert(vec_get(vector, 100) == NULL);
+
+    int value;
+
+    assert(vec_pop(vector, &value) == 0);
+    assert(value == 99);
+    assert(vec_pop(vector, NULL) == 0);
+    assert(vector->size == 98);
+
+    vec_clear(vector);
+
+    assert(vector->size == 0);
+    assert(vector->capacity == 128);
+    assert(vec_pop(vector, &value) == -1);
+
+    vec_free(vector, NULL);
+
+    printf("vec_push_and_pop passed\n");
+
+    return;
+}
+
+void test_vec_reserve_and_append()
+{
+    printf("Testing vec_reserve_and_append\n");
+
+    struct CountingAllocator counting_allocator;
+    struct Allocator *allocator = counting_allocator_init(&counting_allocator, NULL);
+
+    struct Vector *vector = vec_create_with_allocator(sizeof(int), allocator);
+
+    assert(vec_reserve(vector, 1000) == 0);
+    assert(vector->capacity == 1000);
+
+    size_t allocations = counting_allocator.allocations;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(vec_push(vector, &i) == 0);
+    }
+
+    assert(counting_allocator.allocations == allocations);
+
+    int values[500];
+
+    for (int i = 0; i < 500; i++)
+    {
+        values[i] = 1000 + i;
+    }
+
+    assert(vec_append(vector, values, 500) == 0);
+    assert(vec_append(vector, values, 0) == 0);
+    assert(vector->size == 1500);
+    assert(counting_allocator.allocations == allocations + 1);
+
+    for (int i = 0; i < 1500; i++)
+    {
+        assert(*(int *)vec_get(vector, i) == i);
+    }
+
+    vec_free(vector, NULL);
+
+    assert(counting_allocator.bytes_in_use == 0);
+
+    printf("vec_reserve_and_append passed\n");
+
+    return;
+}
+
+void test_vec_remove()
+{
+    printf("Testing vec_remove\n");
+
+    struct Vector *vector = vec_create(sizeof(int));
+
+    for (int i = 0; i < 5; i++)
+    {
+        assert(vec_push(vector, &i) == 0);
+    }
+
+    assert(vec_swap_remove(vector, 1) == 0);
+    assert(*(int *)vec_get(vector, 1) == 4);
+    assert(vector->size == 4);
+
+    assert(vec_swap_remove(vector, 3) == 0);
+    assert(vector->size == 3);
+
+    assert(vec_remove(vector, 0) == 0);
+    assert(*(int *)vec_get(vector, 0) == 4);
+    assert(*(int *)vec_get(vector, 1) == 2);
+    assert(vector->size == 2);
+
+    assert(vec_remove(vector, 2) == -1);
+    assert(vec_swap_remove(vector, 2) == -1);
+
+    vec_free(vector, NULL);
+
+    printf("vec_remove passed\n");
+
+    return;
+}
+
+void test_vec_sort()
+{
+    printf("Testing vec_sort\n");
+
+    struct Vector *vector = vec_create(sizeof(int));
+    int values[8] = {5, 3, 7, 1, 8, 2, 6, 4};
+
+    assert(vec_append(vector, values, 8) == 0);
+
+    vec_sort(vector, int_order_function);
+
+    for (int i = 0; i < 8; i++)
+    {
+        assert(*(int *)vec_get(vector, i) == i + 1);
+    }
+
+    vec_free(vector, NULL);
+
+    printf("vec_sort passed\n");
+
+    return;
+}
+
+void test_vec_free()
+{
+    printf("Testing vec_free\n");
+
+    struct Vector *vector = vec_create(sizeof(struct Message));
+
+    for (int i = 0; i < 10; i++)
+    {
+        struct Message message = {i, malloc(16)};
+
+        assert(vec_push(vector, &message) == 0);
+    }
+
+    assert(((struct Message *)vec_get(vector, 9))->id == 9);
+
+    vec_free(vector, message_free_function);
+
+    printf("vec_free passed\n");
+
+    return;
+}
+
+int main()
+{
+    printf("Running tests for \"lib/vec.c\"\n");
+
+    test_vec_create();
+    test_vec_push_and_pop();
+    test_vec_reserve_and_append();
+    test_vec_remove();
+    test_vec_sort();
+    test_vec_free();
+
+    printf("All tests passed for \"lib/vec.c\"\n\n");
+
+    return 0;
+}